@@ -0,0 +1,82 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/renderer.hpp"
+#include "bench_common.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL_image.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <SDL2/SDL_image.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+namespace {
+
+const char* s_textures[] = {
+    "base-tile-01.png",
+    "dino-sprite-map.png",
+    "obstacle-type-01.png",
+    "world-bg.png"
+};
+
+} // namespace
+
+/* PNG decode only. */
+static void BM_DecodeImage(benchmark::State& state) {
+    auto file_path = dino::bench::asset("texture", s_textures[state.range(0)]);
+    state.SetLabel(s_textures[state.range(0)]);
+
+    for (auto _ : state) {
+        SDL_Surface* surface = IMG_Load(file_path.c_str());
+
+        if (surface == nullptr) {
+            state.SkipWithError(IMG_GetError());
+            break;
+        }
+
+        SDL_FreeSurface(surface);
+    }
+}
+
+BENCHMARK(BM_DecodeImage)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+/* PNG decode and texture creation, as done when a world is loaded. */
+static void BM_LoadSprite(benchmark::State& state) {
+    auto file_path = dino::bench::asset("texture", s_textures[state.range(0)]);
+    state.SetLabel(s_textures[state.range(0)]);
+
+    SDL_Surface* surface = dino::bench::createSurface();
+    auto renderer = new dino::Renderer(surface);
+
+    for (auto _ : state) {
+        delete renderer->loadSprite(file_path);
+    }
+
+    delete renderer;
+    SDL_FreeSurface(surface);
+}
+
+BENCHMARK(BM_LoadSprite)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+/* WAV decode of a sound effect. */
+static void BM_DecodeWave(benchmark::State& state) {
+    auto file_path = dino::bench::asset("audio", "cartoon-jump.wav");
+
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+
+    for (auto _ : state) {
+        if (SDL_LoadWAV(file_path.c_str(), &spec, &buffer, &length) == nullptr) {
+            state.SkipWithError(SDL_GetError());
+            break;
+        }
+
+        SDL_FreeWAV(buffer);
+    }
+
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+BENCHMARK(BM_DecodeWave)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/audio_mixer.hpp"
+#include "engine/sample_kernels.hpp"
+
+/* Frames per mixer callback at the default buffer size. */
+#define DINO_BENCH_CALLBACK_FRAMES 1024
+
+namespace {
+
+std::vector<float> createTone(int frames) {
+    std::vector<float> samples(static_cast<std::size_t>(frames) * 2);
+
+    for (std::size_t index = 0; index < samples.size(); index++) {
+        samples[index] = 0.5f * std::sin(static_cast<float>(index) * 0.01f);
+    }
+
+    return samples;
+}
+
+} // namespace
+
+static void BM_MixStereo(benchmark::State& state) {
+    auto frames = static_cast<int>(state.range(0));
+    auto source = createTone(frames);
+    std::vector<float> target(source.size(), 0.0f);
+
+    for (auto _ : state) {
+        dino::SampleKernels::mixStereo(target.data(), source.data(), frames, 0.7f, 0.3f);
+        benchmark::DoNotOptimize(target.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_MixStereo)->Arg(256)->Arg(DINO_BENCH_CALLBACK_FRAMES)->Arg(DINO_AUDIO_MAX_BUFFER_FRAMES);
+
+static void BM_ResampleStereo(benchmark::State& state) {
+    auto frames = static_cast<int>(state.range(0));
+    auto source = createTone(frames);
+    std::vector<float> target(source.size(), 0.0f);
+
+    for (auto _ : state) {
+        double position = 0.0;
+        int produced = dino::SampleKernels::resampleStereo(target.data(), source.data(), frames, &position, 22050.0 / 44100.0, frames);
+        benchmark::DoNotOptimize(produced);
+    }
+
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_ResampleStereo)->Arg(DINO_BENCH_CALLBACK_FRAMES)->Arg(DINO_AUDIO_MAX_BUFFER_FRAMES);
+
+static void BM_ConvertS16(benchmark::State& state) {
+    auto samples = static_cast<int>(state.range(0)) * 2;
+    std::vector<int16_t> source(static_cast<std::size_t>(samples), 1234);
+    std::vector<float> target(static_cast<std::size_t>(samples));
+
+    for (auto _ : state) {
+        dino::SampleKernels::convertS16(target.data(), source.data(), samples);
+        benchmark::DoNotOptimize(target.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+
+BENCHMARK(BM_ConvertS16)->Arg(DINO_BENCH_CALLBACK_FRAMES);
+
+/* One mixer callback: every voice added to a float bus, then saturated into the device buffer. */
+static void BM_MixVoices(benchmark::State& state) {
+    auto voices = static_cast<int>(state.range(0));
+    auto source = createTone(DINO_BENCH_CALLBACK_FRAMES);
+
+    std::vector<float> bus(source.size());
+    std::vector<int16_t> device(source.size());
+
+    for (auto _ : state) {
+        std::fill(bus.begin(), bus.end(), 0.0f);
+
+        for (int voice = 0; voice < voices; voice++) {
+            dino::SampleKernels::mixStereo(bus.data(), source.data(), DINO_BENCH_CALLBACK_FRAMES, 0.5f, 0.5f);
+        }
+
+        dino::SampleKernels::mixIntoS16(device.data(), bus.data(), static_cast<int>(bus.size()));
+        benchmark::DoNotOptimize(device.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * voices * DINO_BENCH_CALLBACK_FRAMES);
+}
+
+BENCHMARK(BM_MixVoices)->Arg(1)->Arg(4)->Arg(DINO_AUDIO_DEFAULT_VOICES);
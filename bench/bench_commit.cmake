@@ -0,0 +1,26 @@
+# ---
+# Benchmark commit
+# -
+# Script mode: cmake -DDINO_SOURCE_DIR=<dir> -DDINO_OUTPUT=<file> -P bench_commit.cmake
+# Writes the current commit to a header, rewritten only when it changes so
+# dino-bench is not rebuilt on every build.
+# =========================================================================
+execute_process(COMMAND git rev-parse --short HEAD
+        WORKING_DIRECTORY "${DINO_SOURCE_DIR}"
+        OUTPUT_VARIABLE DINO_BENCH_COMMIT
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET)
+
+if (NOT DINO_BENCH_COMMIT)
+    set(DINO_BENCH_COMMIT "unknown")
+endif ()
+
+set(DINO_CONTENT "#pragma once\n\n#define DINO_BENCH_COMMIT \"${DINO_BENCH_COMMIT}\"\n")
+
+if (EXISTS "${DINO_OUTPUT}")
+    file(READ "${DINO_OUTPUT}" DINO_PREVIOUS_CONTENT)
+endif ()
+
+if (NOT DINO_CONTENT STREQUAL DINO_PREVIOUS_CONTENT)
+    file(WRITE "${DINO_OUTPUT}" "${DINO_CONTENT}")
+endif ()
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include "platform/standard.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <SDL2/SDL.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+/* Size of the surface drawn into by the software renderer. */
+#define DINO_BENCH_SURFACE_WIDTH  1280
+#define DINO_BENCH_SURFACE_HEIGHT 720
+
+namespace dino::bench {
+
+/**
+ * @brief Returns the path of an asset shipped in the source tree.
+ * @param directory Asset directory, e.g. texture.
+ * @param file File name.
+ * @return Absolute path of the asset.
+ */
+inline std::string asset(const std::string& directory, const std::string& file) {
+    return std::string(DINO_BENCH_ASSET_DIR).append("/").append(directory).append("/").append(file);
+}
+
+/**
+ * @brief Creates the surface drawn into by the software renderer.
+ * @return A 32 bit surface, freed with SDL_FreeSurface.
+ */
+inline SDL_Surface* createSurface() {
+    return SDL_CreateRGBSurfaceWithFormat(0, DINO_BENCH_SURFACE_WIDTH, DINO_BENCH_SURFACE_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+}
+
+} // namespace dino::bench
@@ -0,0 +1,47 @@
+#include <cstdlib>
+#include <filesystem>
+
+#include <benchmark/benchmark.h>
+
+#include "platform/logger.hpp"
+#include "engine/sample_kernels.hpp"
+#include "bench_common.hpp"
+#include "bench_commit.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL_image.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <SDL2/SDL_image.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+int main(int argc, char** argv) {
+    if (SDL_Init(0) != 0 || IMG_Init(IMG_INIT_PNG) == 0) {
+        dino::Logger::error("Unable to initialise SDL:", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    dino::SampleKernels::initialise();
+
+    /* Engine logging goes to a file so it does not interleave with the results. */
+    auto log_file = std::filesystem::temp_directory_path() / "dino-bench.log";
+    dino::Logger::openBinaryLog(log_file.string());
+
+    benchmark::AddCustomContext("dino_commit", DINO_BENCH_COMMIT);
+    benchmark::AddCustomContext("dino_kernels", dino::SampleKernels::getName());
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    dino::Logger::closeBinaryLog();
+
+    IMG_Quit();
+    SDL_Quit();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+
+#include "platform/logger.hpp"
+
+/* Records per timed batch, half a ring so the batch never overflows it. */
+#define DINO_BENCH_LOG_BATCH (DINO_LOG_RING_SIZE / 2)
+
+/*
+ * Cost of an enabled call on the calling thread. The ring is flushed
+ * outside the timed region between batches, so records are formatted
+ * by the writer thread and not dropped.
+ */
+static void BM_LogEnabled(benchmark::State& state) {
+    uint64_t dropped = dino::Logger::getDropped();
+    int frame = 0;
+
+    for (auto _ : state) {
+        for (int index = 0; index < DINO_BENCH_LOG_BATCH; index++) {
+            DINO_LOG(dino::Logger::INFO, "Frame {} took {} ms on {}.", frame, 16.6, "bench");
+            frame = frame + 1;
+        }
+
+        state.PauseTiming();
+        dino::Logger::flush();
+        state.ResumeTiming();
+    }
+
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = static_cast<double>(dino::Logger::getDropped() - dropped);
+    }
+
+    state.SetItemsProcessed(state.iterations() * DINO_BENCH_LOG_BATCH);
+}
+
+BENCHMARK(BM_LogEnabled)->ThreadRange(1, 4);
+
+/* Call filtered out by the runtime level. */
+static void BM_LogFiltered(benchmark::State& state) {
+    int level = dino::Logger::getLevel();
+    dino::Logger::setLevel(dino::Logger::WARN);
+
+    int frame = 0;
+
+    for (auto _ : state) {
+        DINO_LOG(dino::Logger::INFO, "Frame {} took {} ms on {}.", frame, 16.6, "bench");
+        frame = frame + 1;
+    }
+
+    dino::Logger::setLevel(level);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_LogFiltered);
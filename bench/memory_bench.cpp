@@ -0,0 +1,97 @@
+#include <memory_resource>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/frame_arena.hpp"
+#include "engine/object_pool.hpp"
+
+/* Same capacity as the platformer. */
+#define DINO_BENCH_ARENA_SIZE 65536
+
+namespace {
+
+struct bench_entity {
+    int posX = 0;
+    int posY = 0;
+};
+
+} // namespace
+
+/* Small allocations served by the frame arena. */
+static void BM_ArenaAllocate(benchmark::State& state) {
+    dino::FrameArena arena(DINO_BENCH_ARENA_SIZE);
+
+    for (auto _ : state) {
+        arena.beginFrame();
+
+        for (int index = 0; index < state.range(0); index++) {
+            benchmark::DoNotOptimize(arena.allocate(32));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArenaAllocate)->Arg(64)->Arg(1024);
+
+/* The same allocations from the general purpose heap, for comparison. */
+static void BM_HeapAllocate(benchmark::State& state) {
+    std::vector<void*> blocks(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (auto& block : blocks) {
+            block = ::operator new(32);
+            benchmark::DoNotOptimize(block);
+        }
+
+        for (auto block : blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_HeapAllocate)->Arg(64)->Arg(1024);
+
+/* Growing a per-frame container, as moveCamera() does with collisions. */
+static void BM_ArenaVector(benchmark::State& state) {
+    dino::FrameArena arena(DINO_BENCH_ARENA_SIZE);
+
+    for (auto _ : state) {
+        arena.beginFrame();
+
+        std::pmr::vector<int> values {arena.getResource()};
+
+        for (int index = 0; index < state.range(0); index++) {
+            values.push_back(index);
+        }
+
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArenaVector)->Arg(16)->Arg(1024);
+
+/* Filling and draining the obstacle pool. */
+static void BM_PoolCycle(benchmark::State& state) {
+    dino::ObjectPool<bench_entity, 256> pool;
+    std::vector<dino::PoolHandle> handles(pool.capacity());
+
+    for (auto _ : state) {
+        for (auto& handle : handles) {
+            benchmark::DoNotOptimize(pool.acquire(handle));
+        }
+
+        for (const auto& handle : handles) {
+            pool.release(handle);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pool.capacity()));
+}
+
+BENCHMARK(BM_PoolCycle);
@@ -0,0 +1,132 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "game/batch_simulation.hpp"
+#include "game/world_simulation.hpp"
+
+/* Ticks simulated ahead of the snapshot, ten seconds of play. */
+#define DINO_BENCH_RESIMULATE_TICKS 2400
+
+/* Ticks looked ahead before deciding to jump, a little longer than a jump. */
+#define DINO_BENCH_LOOKAHEAD_TICKS 180
+
+/* Instances in a batch, enough to keep every core busy. */
+#define DINO_BENCH_BATCH_INSTANCES 4096
+
+namespace {
+
+/* Sizes of the game assets at 1920x1080. */
+dino::WorldLayout createLayout() {
+    dino::WorldLayout layout {};
+    layout.viewWidth      = 1920;
+    layout.tileWidth      = 210;
+    layout.sceneWidth     = 1920;
+    layout.playerX        = 100;
+    layout.playerY        = 720;
+    layout.playerWidth    = 262;
+    layout.playerHeight   = 160;
+    layout.obstacleY      = 680;
+    layout.obstacleWidth  = 90;
+    layout.obstacleHeight = 200;
+
+    return layout;
+}
+
+/**
+ * @brief Records the inputs of a player that looks ahead before every jump.
+ *
+ * Each tick the simulation is rewound and run ahead with and without
+ * a jump, which is the what-if evaluation the rollback is meant for.
+ */
+std::vector<uint8_t> createInputs(dino::WorldSimulation* simulation, dino::WorldState* state, int ticks) {
+    std::vector<uint8_t> inputs(static_cast<std::size_t>(ticks), dino::WorldSimulation::INPUT_NONE);
+    std::vector<uint8_t> jump(DINO_BENCH_LOOKAHEAD_TICKS, dino::WorldSimulation::INPUT_NONE);
+
+    jump[0] = dino::WorldSimulation::INPUT_JUMP;
+
+    for (std::size_t tick = 0; tick < inputs.size(); tick++) {
+        dino::WorldState now = *state;
+
+        int idle_ticks = simulation->resimulate(now, nullptr, DINO_BENCH_LOOKAHEAD_TICKS);
+        int jump_ticks = idle_ticks < DINO_BENCH_LOOKAHEAD_TICKS ? simulation->resimulate(now, jump.data(), DINO_BENCH_LOOKAHEAD_TICKS) : 0;
+
+        /* Jump at the first tick from which a jump clears what is ahead. */
+        inputs[tick] = jump_ticks == DINO_BENCH_LOOKAHEAD_TICKS ? dino::WorldSimulation::INPUT_JUMP : dino::WorldSimulation::INPUT_NONE;
+
+        *state = now;
+        simulation->step(inputs[tick]);
+    }
+
+    return inputs;
+}
+
+} // namespace
+
+/* Rewinds to a snapshot and simulates ahead, the cost of one rollback. */
+static void BM_Resimulate(benchmark::State& state) {
+    dino::WorldState world;
+    dino::WorldSimulation simulation(createLayout(), &world, 1234);
+
+    int ticks = static_cast<int>(state.range(0));
+    dino::WorldState snapshot = world;
+
+    auto inputs = createInputs(&simulation, &world, ticks);
+    int simulated = 0;
+
+    for (auto _ : state) {
+        simulated = simulated + simulation.resimulate(snapshot, inputs.data(), ticks);
+        benchmark::DoNotOptimize(&world);
+    }
+
+    state.SetItemsProcessed(simulated);
+    state.counters["ticks"] = benchmark::Counter(simulated / static_cast<double>(state.iterations()));
+}
+
+BENCHMARK(BM_Resimulate)->Arg(8)->Arg(DINO_BENCH_RESIMULATE_TICKS)->Unit(benchmark::kMicrosecond);
+
+/* Copies the whole world state, the cost of saving or restoring a snapshot. */
+static void BM_SnapshotCopy(benchmark::State& state) {
+    dino::WorldState world;
+    dino::WorldSimulation simulation(createLayout(), &world, 1234);
+
+    dino::WorldState snapshot;
+
+    for (auto _ : state) {
+        snapshot = world;
+        benchmark::DoNotOptimize(&snapshot);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sizeof(dino::WorldState)));
+}
+
+BENCHMARK(BM_SnapshotCopy);
+
+/* Lockstep steps of a batch, with an agent that jumps when the next obstacle is close. */
+static void BM_BatchStep(benchmark::State& state) {
+    dino::BatchConfig config {};
+    config.instances = DINO_BENCH_BATCH_INSTANCES;
+    config.threads   = static_cast<int>(state.range(0));
+    config.frameSkip = static_cast<int>(state.range(1));
+
+    dino::BatchSimulation batch(createLayout(), config);
+    std::vector<uint8_t> actions(DINO_BENCH_BATCH_INSTANCES);
+
+    for (auto _ : state) {
+        const float* observations = batch.getObservations();
+
+        for (int instance = 0; instance < DINO_BENCH_BATCH_INSTANCES; instance++) {
+            bool is_close = observations[instance * DINO_BATCH_OBSERVATION_SIZE + 2] < 0.05f;
+            actions[instance] = is_close ? dino::WorldSimulation::INPUT_JUMP : dino::WorldSimulation::INPUT_NONE;
+        }
+
+        batch.step(actions.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(batch.getTickCount()));
+    state.counters["threads"] = batch.getThreadCount();
+}
+
+/* Thread count 0 uses every hardware thread. */
+BENCHMARK(BM_BatchStep)->Args({1, 1})->Args({0, 1})->Args({0, 4})->Unit(benchmark::kMicrosecond)->UseRealTime();
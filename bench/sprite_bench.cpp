@@ -0,0 +1,220 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/geometry.hpp"
+#include "engine/object_pool.hpp"
+#include "engine/renderer.hpp"
+#include "engine/sprite_batch.hpp"
+#include "engine/tween_system.hpp"
+#include "bench_common.hpp"
+
+/* Same values as the platformer. */
+#define DINO_BENCH_SCROLL_VELOCITY 5
+#define DINO_BENCH_CLIP_WIDTH      262
+#define DINO_BENCH_POOL_SIZE       16
+
+namespace {
+
+struct bench_obstacle {
+    int posX = 0;
+    int posY = 0;
+};
+
+/**
+ * @brief Sprites cloned from one texture, laid out as a scrolling floor.
+ */
+class SpriteFixture : public benchmark::Fixture {
+
+public:
+    SDL_Surface* surface = nullptr;
+    dino::Renderer* renderer = nullptr;
+    dino::SpriteMaterial* material = nullptr;
+
+    std::vector<dino::SpriteMaterial*> sprites;
+
+    void SetUp(const benchmark::State& state) override {
+        surface  = dino::bench::createSurface();
+        renderer = new dino::Renderer(surface);
+        material = renderer->loadSprite(dino::bench::asset("texture", "base-tile-01.png"));
+
+        for (int index = 0; index < state.range(0); index++) {
+            auto sprite = material->clone();
+            sprite->setAttachment(index * material->getWidth(), DINO_BENCH_SURFACE_HEIGHT - material->getHeight());
+            sprites.push_back(sprite);
+        }
+    }
+
+    void TearDown(const benchmark::State&) override {
+        for (auto sprite : sprites) {
+            delete sprite;
+        }
+
+        sprites.clear();
+
+        delete material;
+        delete renderer;
+        SDL_FreeSurface(surface);
+    }
+};
+
+/**
+ * @brief Lays out rectangles the way SpriteFixture lays out sprites.
+ */
+std::vector<dino::Rect2> createRects(int count, int width, int height) {
+    std::vector<dino::Rect2> rects;
+
+    for (int index = 0; index < count; index++) {
+        rects.push_back(dino::Rect2 {index * width, DINO_BENCH_SURFACE_HEIGHT - height, width, height});
+    }
+
+    return rects;
+}
+
+} // namespace
+
+/* The floor scroll of WorldSimulation::step(), through the sprite accessors. */
+BENCHMARK_DEFINE_F(SpriteFixture, ScrollSprites)(benchmark::State& state) {
+    constexpr dino::Vector2 scroll {-DINO_BENCH_SCROLL_VELOCITY, 0};
+    int restart_x = static_cast<int>(sprites.size() - 1) * material->getWidth();
+
+    for (auto _ : state) {
+        for (auto sprite : sprites) {
+            sprite->setPosition(sprite->getBounds().translate(scroll).wrapLeft(0, restart_x).position());
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(SpriteFixture, ScrollSprites)->Arg(16)->Arg(256)->Arg(4096);
+
+/* The same scroll over contiguous rectangles, which the compiler can vectorise. */
+static void BM_ScrollRects(benchmark::State& state) {
+    constexpr dino::Vector2 scroll {-DINO_BENCH_SCROLL_VELOCITY, 0};
+
+    auto rects = createRects(static_cast<int>(state.range(0)), 128, 64);
+    int restart_x = static_cast<int>(rects.size() - 1) * 128;
+
+    for (auto _ : state) {
+        for (auto& rect : rects) {
+            rect = rect.translate(scroll).wrapLeft(0, restart_x);
+        }
+
+        benchmark::DoNotOptimize(rects.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ScrollRects)->Arg(16)->Arg(256)->Arg(4096);
+
+/* Property tweens advanced together, as the main loop does every frame. */
+static void BM_TweenUpdate(benchmark::State& state) {
+    dino::TweenSystem tweens(static_cast<std::size_t>(state.range(0)));
+    std::vector<float> values(static_cast<std::size_t>(state.range(0)));
+
+    for (auto& value : values) {
+        dino::TweenSpec spec;
+        spec.target   = &value;
+        spec.to       = 255.0f;
+        spec.duration = 600.0f;
+        spec.easing   = dino::TweenSystem::EASE_IN_OUT_SINE;
+        spec.repeat   = -1;
+
+        tweens.start(spec);
+    }
+
+    for (auto _ : state) {
+        tweens.update(4.0f);
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TweenUpdate)->Arg(16)->Arg(1024);
+
+/* Obstacle scroll and collision test of WorldSimulation::step(). */
+static void BM_CollidePool(benchmark::State& state) {
+    dino::ObjectPool<bench_obstacle, DINO_BENCH_POOL_SIZE> obstacles;
+    dino::PoolHandle handle {};
+
+    dino::Rect2 hitbox {101, 400, DINO_BENCH_CLIP_WIDTH - 1, 180};
+
+    for (int index = 0; index < DINO_BENCH_POOL_SIZE; index++) {
+        auto obstacle = obstacles.acquire(handle);
+        obstacle->posX = index * 300;
+        obstacle->posY = 560;
+    }
+
+    for (auto _ : state) {
+        int collisions = 0;
+
+        obstacles.forEach([&] (dino::PoolHandle, bench_obstacle& obstacle) {
+            obstacle.posX = obstacle.posX <= -64 ? DINO_BENCH_POOL_SIZE * 300 : obstacle.posX - DINO_BENCH_SCROLL_VELOCITY;
+            collisions += hitbox.intersects(dino::Rect2 {obstacle.posX, obstacle.posY, 1, 64}) ? 1 : 0;
+        });
+
+        benchmark::DoNotOptimize(collisions);
+    }
+
+    state.SetItemsProcessed(state.iterations() * DINO_BENCH_POOL_SIZE);
+}
+
+BENCHMARK(BM_CollidePool);
+
+/* Hitbox against contiguous rectangles, which the compiler can vectorise. */
+static void BM_CollideRects(benchmark::State& state) {
+    auto rects = createRects(static_cast<int>(state.range(0)), 64, 64);
+    dino::Rect2 hitbox {101, 400, DINO_BENCH_CLIP_WIDTH - 1, 180};
+
+    for (auto _ : state) {
+        int collisions = 0;
+
+        for (const auto& rect : rects) {
+            collisions += hitbox.intersects(rect) ? 1 : 0;
+        }
+
+        benchmark::DoNotOptimize(collisions);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_CollideRects)->Arg(16)->Arg(256)->Arg(4096);
+
+/* Draw submission through the software renderer. */
+BENCHMARK_DEFINE_F(SpriteFixture, DrawSprites)(benchmark::State& state) {
+    for (auto _ : state) {
+        renderer->begin();
+        renderer->draw(&sprites);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(SpriteFixture, DrawSprites)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+/* The same sprites through a sprite batch, spread over layers in reverse so the sort has work to do. */
+BENCHMARK_DEFINE_F(SpriteFixture, DrawBatch)(benchmark::State& state) {
+    dino::SpriteBatch batch;
+
+    for (auto _ : state) {
+        batch.clear();
+
+        for (std::size_t index = 0; index < sprites.size(); index++) {
+            batch.add(sprites[index], static_cast<uint16_t>(sprites.size() - index));
+        }
+
+        renderer->begin();
+        renderer->draw(&batch);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(SpriteFixture, DrawBatch)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,186 @@
+/**
+ * asset_reloader.cpp - Hot reload of textures and audio
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+#include "platform/logger.hpp"
+#include "platform/memory_tracker.hpp"
+#include "except.hpp"
+#include "asset_reloader.hpp"
+
+namespace {
+
+/* Registered paths and reported paths are compared in this form. */
+std::string normalisePath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().string();
+}
+
+} // namespace
+
+dino::AssetReloader::AssetReloader() {
+    m_reloaded = new dino::SpscRing<reloaded_asset>(DINO_RELOAD_QUEUE_SIZE);
+    m_watcher  = new dino::FileWatcher();
+}
+
+dino::AssetReloader::~AssetReloader() {
+    delete m_watcher;
+
+    reloaded_asset asset {};
+
+    while (m_reloaded->pop(asset)) {
+        discard_(asset);
+    }
+
+    delete m_reloaded;
+}
+
+void dino::AssetReloader::discard_(const reloaded_asset& asset) {
+    if (asset.surface != nullptr) {
+        SDL_FreeSurface(asset.surface);
+    }
+
+    delete asset.clip;
+}
+
+void dino::AssetReloader::watchTexture(dino::SpriteMaterial* material, const std::string& image_file) {
+    m_assets.push_back(watched_asset {ASSET_TEXTURE, normalisePath(image_file), material, material->getPixelFormat(), nullptr, 0});
+}
+
+void dino::AssetReloader::watchEffect(dino::AudioMixer* mixer, unsigned int effect_id, const std::string& audio_file) {
+    m_assets.push_back(watched_asset {ASSET_EFFECT, normalisePath(audio_file), nullptr, 0, mixer, effect_id});
+}
+
+void dino::AssetReloader::watchMusic(dino::AudioMixer* mixer, const std::string& audio_file) {
+    m_assets.push_back(watched_asset {ASSET_MUSIC, normalisePath(audio_file), nullptr, 0, mixer, 0});
+}
+
+bool dino::AssetReloader::start() {
+    if (!dino::FileWatcher::isSupported()) {
+        return false;
+    }
+
+    std::vector<std::string> directories;
+
+    for (const auto& asset : m_assets) {
+        auto directory = std::filesystem::path(asset.path).parent_path().string();
+
+        if (std::find(directories.begin(), directories.end(), directory) != directories.end()) {
+            continue;
+        }
+
+        if (!m_watcher->watch(directory)) {
+            dino::Logger::warn("Unable to watch", directory);
+            continue;
+        }
+
+        directories.push_back(directory);
+    }
+
+    return m_watcher->start([this] (const std::string& path) {
+        decode_(path);
+    });
+}
+
+void dino::AssetReloader::decode_(const std::string& path) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+
+    auto changed_path = normalisePath(path);
+
+    for (std::size_t index = 0; index < m_assets.size(); index++) {
+        const auto& asset = m_assets[index];
+
+        if (asset.path != changed_path) {
+            continue;
+        }
+
+        reloaded_asset reloaded {index, nullptr, nullptr};
+
+        if (asset.kind == ASSET_TEXTURE) {
+            reloaded.surface = dino::SpriteMaterial::decodeImage(asset.path, asset.pixelFormat);
+
+        } else if (asset.kind == ASSET_EFFECT) {
+            reloaded.clip = dino::AudioMixer::decodeEffect(asset.path);
+        }
+
+        if (asset.kind != ASSET_MUSIC && reloaded.surface == nullptr && reloaded.clip == nullptr) {
+            dino::Logger::warn("Unable to decode", asset.path);
+            continue;
+        }
+
+        if (!m_reloaded->push(reloaded)) {
+            dino::Logger::warn("Reload queue is full, dropped", asset.path);
+            discard_(reloaded);
+        }
+    }
+}
+
+int dino::AssetReloader::apply() {
+    int applied = 0;
+    reloaded_asset reloaded {};
+
+    while (m_reloaded->pop(reloaded)) {
+        const auto& asset = m_assets[reloaded.index];
+
+        try {
+            if (asset.kind == ASSET_TEXTURE) {
+                if (!asset.material->updatePixels(reloaded.surface)) {
+                    dino::Logger::warn("Image size changed, restart to load", asset.path);
+                    discard_(reloaded);
+                    continue;
+                }
+
+                SDL_FreeSurface(std::exchange(reloaded.surface, nullptr));
+
+            } else if (asset.kind == ASSET_EFFECT) {
+                /* The mixer owns the clip from here on, it frees the clip itself when the swap fails. */
+                asset.mixer->replaceEffectClip(asset.effectId, std::exchange(reloaded.clip, nullptr));
+
+            } else {
+                bool is_playing = asset.mixer->isLoopPlaying();
+                asset.mixer->loadLoopAudio(asset.path);
+
+                if (is_playing) {
+                    asset.mixer->playLoopAudio();
+                }
+            }
+
+        } catch (dino::EngineError& error) {
+            dino::Logger::warn(error.what(), asset.path);
+            discard_(reloaded);
+            continue;
+        }
+
+        dino::Logger::info("Reloaded", asset.path);
+        applied++;
+    }
+
+    return applied;
+}
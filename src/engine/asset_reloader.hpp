@@ -0,0 +1,162 @@
+/**
+ * asset_reloader.hpp - Hot reload of textures and audio
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "platform/file_watcher.hpp"
+#include "platform/spsc_ring.hpp"
+#include "audio_mixer.hpp"
+#include "sprite_material.hpp"
+
+/* Decoded assets waiting for the next frame boundary. */
+#define DINO_RELOAD_QUEUE_SIZE 64
+
+namespace dino {
+
+/**
+ * @brief Reloads textures and audio when their files change on disk.
+ *
+ * Registered files are watched by a dino::FileWatcher. When one is
+ * written, the watcher thread decodes it and queues the result, and
+ * apply() swaps it in behind the existing handle between two frames:
+ * textures are updated in place, so sprite materials and their clones
+ * keep working, and effects keep their identifier.
+ *
+ * Files must be registered before start(). A texture whose size
+ * changed cannot be updated in place and is skipped with a warning.
+ */
+class AssetReloader {
+
+private:
+    enum AssetKind : int {
+        ASSET_TEXTURE = 0,
+        ASSET_EFFECT,
+        ASSET_MUSIC
+    };
+
+    struct watched_asset {
+        int kind;
+        std::string path;
+
+        SpriteMaterial* material;
+
+        /**
+         * @brief Texture format the watcher thread converts to.
+         */
+        uint32_t pixelFormat;
+
+        AudioMixer* mixer;
+        unsigned int effectId;
+    };
+
+    /**
+     * @brief A decoded asset travelling from the watcher thread to apply().
+     */
+    struct reloaded_asset {
+        std::size_t index;
+        SDL_Surface* surface;
+        AudioClip* clip;
+    };
+
+    /**
+     * @brief Read by the watcher thread, so it is only changed before start().
+     */
+    std::vector<watched_asset> m_assets;
+
+    SpscRing<reloaded_asset>* m_reloaded;
+
+    FileWatcher* m_watcher;
+
+    /**
+     * @brief Decodes a changed file. Watcher thread only.
+     * @param path Path of the changed file.
+     */
+    void decode_(const std::string&);
+
+    /**
+     * @brief Frees a decoded asset that was not applied.
+     * @param asset The asset.
+     */
+    static void discard_(const reloaded_asset&);
+
+public:
+    AssetReloader();
+
+    /**
+     * @brief Stops watching and frees assets that were never applied.
+     */
+    ~AssetReloader();
+
+    AssetReloader(const AssetReloader&) = delete;
+
+    AssetReloader& operator=(const AssetReloader&) = delete;
+
+    /**
+     * @brief Reloads the texture of a sprite material when its image changes.
+     * @param material The sprite material, must outlive the reloader.
+     * @param image_file Absolute path the material was loaded from.
+     */
+    void watchTexture(SpriteMaterial*, const std::string&);
+
+    /**
+     * @brief Reloads a sound effect when its file changes.
+     * @param mixer The mixer holding the effect, must outlive the reloader.
+     * @param effect_id Identifier of the effect.
+     * @param audio_file Absolute path the effect was loaded from.
+     */
+    void watchEffect(AudioMixer*, unsigned int, const std::string&);
+
+    /**
+     * @brief Reloads the BGM when its file changes.
+     * @param mixer The mixer playing the BGM, must outlive the reloader.
+     * @param audio_file Absolute path the BGM was loaded from.
+     */
+    void watchMusic(AudioMixer*, const std::string&);
+
+    /**
+     * @brief Starts watching the directories of the registered files.
+     * @return True if watching, false if file watching is not available.
+     */
+    bool start();
+
+    /**
+     * @brief Swaps in every asset decoded since the last call.
+     * @return Number of assets swapped.
+     *
+     * Called by the render thread between frames.
+     */
+    int apply();
+};
+
+} // namespace dino
@@ -27,7 +27,13 @@
  * ========================================================================
  */
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "platform/memory_tracker.hpp"
 #include "assert.hpp"
+#include "sample_kernels.hpp"
 #include "audio_mixer.hpp"
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
@@ -35,85 +41,562 @@
 #endif
 
 
-dino::AudioMixer::AudioMixer() :
-        m_isLooping(false),
-        m_loopAudio(nullptr) {
+dino::AudioMixer::AudioMixer(int voice_count) :
+        m_isLooping(false) {
+
+    dino::MemoryScope memory_scope(dino::MemoryTracker::AUDIO);
+
+    Uint16 format = 0;
+    int channels  = 0;
+
+    if (Mix_QuerySpec(&m_frequency, &format, &channels) == 0) {
+        throw dino::EngineError(SDL_GetError(), dino::EngineError::E_TYPE_MIX_RESULT);
+    }
+
+    if (format != AUDIO_S16SYS || channels != 2) {
+        throw dino::EngineError("Audio device must be opened as signed 16 bit stereo.", dino::EngineError::E_TYPE_MIX_RESULT);
+    }
+
+    /* Effects no longer play on SDL_mixer channels. */
+    Mix_AllocateChannels(0);
+
+    m_effects  = new std::vector<dino::AudioEffect>();
+    m_voices   = new std::vector<dino::AudioVoice>(static_cast<std::size_t>(std::max(voice_count, 1)));
+    m_commands = new dino::SpscRing<dino::AudioCommand>(DINO_AUDIO_COMMAND_QUEUE_SIZE);
 
-    m_effectMap = new std::map<unsigned int, Mix_Chunk*>();
+    m_retiredAssets = new std::vector<retired_asset>();
+
+    m_mixBuffer      = new std::vector<float>(DINO_AUDIO_MAX_BUFFER_FRAMES * 2);
+    m_resampleBuffer = new std::vector<float>(DINO_AUDIO_MAX_BUFFER_FRAMES * 2);
+
+    Mix_SetPostMix(&dino::AudioMixer::mixCallback_, this);
 }
 
 dino::AudioMixer::~AudioMixer() {
-    if (m_isLooping) {
-        Mix_PauseMusic();
+    /* Once unregistered the callback no longer runs, everything below is ours. */
+    Mix_SetPostMix(nullptr, nullptr);
+
+    /* Replaced streams are retired and the latest is m_loopStream, queued commands own nothing. */
+    m_commands->drain();
+
+    for (auto& retired : *m_retiredAssets) {
+        delete retired.clip;
+        delete retired.stream;
     }
 
-    Mix_FreeMusic(m_loopAudio);
+    delete m_loopStream;
 
-    for (auto audio_it : *m_effectMap) {
-        Mix_FreeChunk(audio_it.second);
+    for (auto& effect : *m_effects) {
+        delete effect.clip;
     }
 
-    m_effectMap->clear();
-    delete m_effectMap;
+    m_effects->clear();
+
+    delete m_effects;
+    delete m_voices;
+    delete m_commands;
+    delete m_retiredAssets;
+    delete m_mixBuffer;
+    delete m_resampleBuffer;
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
     dino::Logger::debug("Audio mixer destroyed.");
 #endif
 }
 
-void dino::AudioMixer::loadEffectAudio(unsigned int effect_id, const std::string &audio_file) {
-    auto mix_chunk = Mix_LoadWAV(audio_file.c_str());
-    DINO_ASSERT_SDL_HANDLE(mix_chunk, dino::EngineError::E_TYPE_MIX_RESULT)
+bool dino::AudioMixer::pushCommand_(const dino::AudioCommand& command) {
+    collectRetired_();
+
+    if (!m_commands->push(command)) {
+        m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-    m_effectMap->insert(std::pair(effect_id, mix_chunk));
+    m_commandSequence++;
+    return true;
+}
+
+void dino::AudioMixer::collectRetired_() {
+    if (m_retiredAssets->empty()) {
+        return void();
+    }
+
+    unsigned long applied = m_appliedCommands.load(std::memory_order_acquire);
+
+    auto first_live = std::partition(m_retiredAssets->begin(), m_retiredAssets->end(), [applied](const retired_asset& retired) {
+        return retired.sequence <= applied;
+    });
+
+    for (auto retired = m_retiredAssets->begin(); retired != first_live; retired++) {
+        delete retired->clip;
+        delete retired->stream;
+    }
+
+    m_retiredAssets->erase(m_retiredAssets->begin(), first_live);
+}
+
+dino::AudioClip* dino::AudioMixer::decodeEffect(const std::string& audio_file) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+
+    /* SDL_mixer decodes and converts the file to the device format. */
+    return convertChunk_(Mix_LoadWAV(audio_file.c_str()));
+}
+
+dino::AudioClip* dino::AudioMixer::decodeEffect(const dino::FileView& audio_data) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+
+    SDL_RWops* source = SDL_RWFromConstMem(audio_data.data, static_cast<int>(audio_data.size));
+    return source != nullptr ? convertChunk_(Mix_LoadWAV_RW(source, 1)) : nullptr;
+}
+
+dino::AudioClip* dino::AudioMixer::convertChunk_(Mix_Chunk* mix_chunk) {
+    if (mix_chunk == nullptr) {
+        return nullptr;
+    }
+
+    auto clip = new dino::AudioClip();
+    int samples = static_cast<int>(mix_chunk->alen / sizeof(int16_t));
+
+    clip->frames = samples / 2;
+    clip->samples.resize(static_cast<std::size_t>(clip->frames) * 2);
+
+    dino::SampleKernels::convertS16(clip->samples.data(), reinterpret_cast<const int16_t*>(mix_chunk->abuf), clip->frames * 2);
+    Mix_FreeChunk(mix_chunk);
+
+    return clip;
+}
+
+void dino::AudioMixer::loadEffectAudio(unsigned int effect_id, const std::string &audio_file, int priority, int max_voices) {
+    auto clip = decodeEffect(audio_file);
+    DINO_ASSERT_SDL_HANDLE(clip, dino::EngineError::E_TYPE_MIX_RESULT)
+
+    replaceEffectClip(effect_id, clip);
+
+    auto& effect = m_effects->at(effect_id);
+
+    effect.priority  = priority;
+    effect.maxVoices = max_voices < 1 ? 1 : max_voices;
+}
+
+void dino::AudioMixer::loadEffectAudio(unsigned int effect_id, const dino::FileView& audio_data, int priority, int max_voices) {
+    auto clip = decodeEffect(audio_data);
+    DINO_ASSERT_SDL_HANDLE(clip, dino::EngineError::E_TYPE_MIX_RESULT)
+
+    replaceEffectClip(effect_id, clip);
+
+    auto& effect = m_effects->at(effect_id);
+
+    effect.priority  = priority;
+    effect.maxVoices = max_voices < 1 ? 1 : max_voices;
+}
+
+void dino::AudioMixer::replaceEffectClip(unsigned int effect_id, dino::AudioClip* clip) {
+    if (effect_id >= m_effects->size()) {
+        m_effects->resize(effect_id + 1);
+    }
+
+    auto& effect = m_effects->at(effect_id);
+
+    if (effect.clip != nullptr) {
+        dino::AudioCommand command;
+        command.type     = dino::AudioCommand::STOP_EFFECT;
+        command.effectId = static_cast<int>(effect_id);
+
+        if (!pushCommand_(command)) {
+            delete clip;
+            throw dino::EngineError("Audio command queue is full.", dino::EngineError::E_TYPE_MIX_RESULT);
+        }
+
+        /* Voices may still read the old clip until the stop is applied. */
+        m_retiredAssets->push_back({m_commandSequence, effect.clip, nullptr});
+    }
+
+    effect.clip = clip;
 }
 
 void dino::AudioMixer::pauseLoopAudio() {
-    if (m_isLooping) {
-        Mix_PauseMusic();
-        m_isLooping = false;
+    if (!m_isLooping) {
+        return void();
     }
+
+    dino::AudioCommand command;
+    command.type = dino::AudioCommand::PAUSE_MUSIC;
+
+    /* With the queue full the BGM keeps playing, so it is still reported as playing. */
+    m_isLooping = !pushCommand_(command);
 }
 
 void dino::AudioMixer::loadLoopAudio(const std::string &audio_file) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+
+    pauseLoopAudio();
+    setLoopStream_(new dino::AudioStream(audio_file, m_frequency));
+}
+
+void dino::AudioMixer::loadLoopAudio(const dino::FileView& audio_data) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+
+    pauseLoopAudio();
+
+    /* Decoded in place, a packed BGM is never copied. */
+    setLoopStream_(new dino::AudioStream(audio_data, m_frequency));
+}
+
+void dino::AudioMixer::unloadLoopAudio() {
     pauseLoopAudio();
 
-    if (m_loopAudio != nullptr) {
-        Mix_FreeMusic(m_loopAudio);
+    if (m_loopStream == nullptr) {
+        return void();
+    }
+
+    /* Closed before anything else, the caller may free the file right after. */
+    m_loopStream->close();
+
+    dino::AudioCommand command;
+    command.type = dino::AudioCommand::SET_MUSIC_STREAM;
+
+    /* With the queue full the closed stream stays in place and only plays silence. */
+    if (pushCommand_(command)) {
+        m_retiredAssets->push_back({m_commandSequence, nullptr, m_loopStream});
+        m_loopStream = nullptr;
+    }
+}
+
+void dino::AudioMixer::setLoopStream_(dino::AudioStream* loop_stream) {
+    dino::AudioCommand command;
+    command.type   = dino::AudioCommand::SET_MUSIC_STREAM;
+    command.stream = loop_stream;
+
+    if (!pushCommand_(command)) {
+        delete loop_stream;
+        throw dino::EngineError("Audio command queue is full.", dino::EngineError::E_TYPE_MIX_RESULT);
     }
 
-    m_loopAudio = Mix_LoadMUS(audio_file.c_str());
-    DINO_ASSERT_SDL_HANDLE(m_loopAudio, dino::EngineError::E_TYPE_MIX_RESULT)
+    if (m_loopStream != nullptr) {
+        m_loopStream->close();
+        m_retiredAssets->push_back({m_commandSequence, nullptr, m_loopStream});
+    }
 
-    m_isLooping = false;
+    m_loopStream = loop_stream;
+    m_isLooping  = false;
 }
 
 void dino::AudioMixer::playLoopAudio() {
-    if (m_isLooping || m_loopAudio == nullptr){
+    if (m_isLooping || m_loopStream == nullptr) {
         return void();
     }
 
-    int result = Mix_PlayMusic(m_loopAudio, -1);
-    DINO_ASSERT_SDL_RESULT(result)
+    dino::AudioCommand command;
+    command.type = dino::AudioCommand::PLAY_MUSIC;
 
-    m_isLooping = true;
+    m_isLooping = pushCommand_(command);
 }
 
-void dino::AudioMixer::playEffectAudio(unsigned int effect_id) {
-    Mix_Chunk* mix_chunk;
+void dino::AudioMixer::seekLoopAudio(double seconds) {
+    if (m_loopStream == nullptr) {
+        return void();
+    }
 
-    try {
-        mix_chunk = m_effectMap->at(effect_id);
+    dino::AudioCommand command;
+    command.type  = dino::AudioCommand::SEEK_MUSIC;
+    command.value = seconds;
 
-        if (mix_chunk == nullptr) {
-            return void();
-        }
-    } catch (std::out_of_range& /* ignored */) {
+    pushCommand_(command);
+}
+
+void dino::AudioMixer::setLoopGain(float gain) {
+    dino::AudioCommand command;
+    command.type = dino::AudioCommand::SET_MUSIC_GAIN;
+    command.gain = gain;
+
+    pushCommand_(command);
+}
+
+void dino::AudioMixer::playEffectAudio(unsigned int effect_id, float gain, float pan, float pitch) {
+    if (effect_id >= m_effects->size() || (*m_effects)[effect_id].clip == nullptr) {
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
-        dino::Logger::debug("Effect audio", effect_id, "does not exist.");
+        DINO_LOG(dino::Logger::DEBUG, "Effect audio {} does not exist.", effect_id);
 #endif
         return void();
     }
 
-    Mix_PlayChannel(-1, mix_chunk, 0);
+    auto& effect = (*m_effects)[effect_id];
+
+    /* Equal power panning keeps the loudness constant across the field. */
+    float angle = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * 0.25f * static_cast<float>(M_PI);
+
+    dino::AudioCommand command;
+    command.type      = dino::AudioCommand::PLAY_EFFECT;
+    command.effectId  = static_cast<int>(effect_id);
+    command.clip      = effect.clip;
+    command.priority  = effect.priority;
+    command.maxVoices = effect.maxVoices;
+    command.gain      = gain;
+    command.panLeft   = std::cos(angle);
+    command.panRight  = std::sin(angle);
+    command.value     = pitch > 0.0f ? pitch : 1.0;
+
+    pushCommand_(command);
+}
+
+void dino::AudioMixer::stopEffectAudio(unsigned int effect_id) {
+    dino::AudioCommand command;
+    command.type     = dino::AudioCommand::STOP_EFFECT;
+    command.effectId = static_cast<int>(effect_id);
+
+    pushCommand_(command);
+}
+
+void dino::AudioMixer::setEffectGain(unsigned int effect_id, float gain) {
+    dino::AudioCommand command;
+    command.type     = dino::AudioCommand::SET_EFFECT_GAIN;
+    command.effectId = static_cast<int>(effect_id);
+    command.gain     = gain;
+
+    pushCommand_(command);
+}
+
+int dino::AudioMixer::getActiveVoices() const {
+    return m_activeVoices.load(std::memory_order_relaxed);
+}
+
+dino::MixerStats dino::AudioMixer::getStats() const {
+    dino::MixerStats stats {};
+
+    stats.lastCallbackMs  = static_cast<double>(m_lastCallbackNs.load(std::memory_order_relaxed)) / 1.0e6;
+    stats.peakCallbackMs  = static_cast<double>(m_peakCallbackNs.load(std::memory_order_relaxed)) / 1.0e6;
+    stats.bufferMs        = static_cast<double>(m_callbackFrames.load(std::memory_order_relaxed)) * 1000.0 / m_frequency;
+    stats.callbacks       = m_callbacks.load(std::memory_order_relaxed);
+    stats.droppedCommands = m_droppedCommands.load(std::memory_order_relaxed);
+
+    if (m_loopStream != nullptr) {
+        stats.streamUnderruns = m_loopStream->getUnderruns();
+    }
+
+    return stats;
+}
+
+void dino::AudioMixer::applyCommands_() {
+    dino::AudioCommand command;
+    unsigned long applied = 0;
+
+    while (m_commands->pop(command)) {
+        applyCommand_(command);
+        applied++;
+    }
+
+    if (applied > 0) {
+        m_appliedCommands.fetch_add(applied, std::memory_order_release);
+    }
+}
+
+void dino::AudioMixer::applyCommand_(const dino::AudioCommand& command) {
+    switch (command.type) {
+        case dino::AudioCommand::PLAY_EFFECT: {
+            int index = allocateVoice_(command);
+
+            if (index < 0) {
+                break;
+            }
+
+            auto& voice = (*m_voices)[index];
+            m_voiceSequence++;
+
+            voice.effectId = command.effectId;
+            voice.priority = command.priority;
+            voice.sequence = m_voiceSequence;
+            voice.clip     = command.clip;
+            voice.position = 0.0;
+            voice.step     = command.value;
+            voice.gain     = command.gain;
+            voice.panLeft  = command.panLeft;
+            voice.panRight = command.panRight;
+            break;
+        }
+
+        case dino::AudioCommand::STOP_EFFECT:
+        case dino::AudioCommand::SET_EFFECT_GAIN:
+            for (auto& voice : *m_voices) {
+                if (voice.effectId != command.effectId) {
+                    continue;
+                }
+
+                if (command.type == dino::AudioCommand::SET_EFFECT_GAIN) {
+                    voice.gain = command.gain;
+                } else {
+                    voice.effectId = -1;
+                    voice.clip = nullptr;
+                }
+            }
+            break;
+
+        case dino::AudioCommand::PLAY_MUSIC:
+        case dino::AudioCommand::PAUSE_MUSIC:
+            if (m_activeStream != nullptr) {
+                m_activeStream->setPlaying(command.type == dino::AudioCommand::PLAY_MUSIC);
+            }
+            break;
+
+        case dino::AudioCommand::SEEK_MUSIC:
+            if (m_activeStream != nullptr) {
+                m_activeStream->seek(command.value);
+            }
+            break;
+
+        case dino::AudioCommand::SET_MUSIC_GAIN:
+            m_musicGain = command.gain;
+            break;
+
+        case dino::AudioCommand::SET_MUSIC_STREAM:
+            m_activeStream = command.stream;
+            break;
+
+        default:
+            break;
+    }
+}
+
+int dino::AudioMixer::allocateVoice_(const dino::AudioCommand& command) {
+    int free_voice  = -1;
+    int own_oldest  = -1;
+    int own_count   = 0;
+    int steal_voice = -1;
+
+    for (std::size_t slot = 0; slot < m_voices->size(); slot++) {
+        auto& voice = (*m_voices)[slot];
+        int index = static_cast<int>(slot);
+
+        if (voice.effectId < 0) {
+            free_voice = free_voice < 0 ? index : free_voice;
+            continue;
+        }
+
+        if (voice.effectId == command.effectId) {
+            own_count++;
+
+            if (own_oldest < 0 || voice.sequence < (*m_voices)[own_oldest].sequence) {
+                own_oldest = index;
+            }
+        }
+
+        if (voice.priority > command.priority) {
+            continue;
+        }
+
+        if (steal_voice < 0) {
+            steal_voice = index;
+            continue;
+        }
+
+        auto& candidate = (*m_voices)[steal_voice];
+
+        if (voice.priority < candidate.priority ||
+                (voice.priority == candidate.priority && voice.sequence < candidate.sequence)) {
+            steal_voice = index;
+        }
+    }
+
+    if (own_count >= command.maxVoices) {
+        return own_oldest;
+    }
+
+    return free_voice >= 0 ? free_voice : steal_voice;
+}
+
+void dino::AudioMixer::mixCallback_(void* userdata, Uint8* stream, int length) {
+    auto mixer = static_cast<dino::AudioMixer*>(userdata);
+    auto started_at = SDL_GetPerformanceCounter();
+
+    mixer->applyCommands_();
+
+    auto samples = reinterpret_cast<int16_t*>(stream);
+    int frames = length / static_cast<int>(2 * sizeof(int16_t));
+
+    mixer->m_callbackFrames.store(static_cast<uint64_t>(frames), std::memory_order_relaxed);
+
+    while (frames > 0) {
+        int block = std::min(frames, DINO_AUDIO_MAX_BUFFER_FRAMES);
+        mixer->mixVoices_(samples, block);
+
+        samples = samples + block * 2;
+        frames  = frames - block;
+    }
+
+    int active_voices = 0;
+
+    for (auto& voice : *(mixer->m_voices)) {
+        active_voices = voice.effectId >= 0 ? active_voices + 1 : active_voices;
+    }
+
+    mixer->m_activeVoices.store(active_voices, std::memory_order_relaxed);
+
+    auto elapsed = SDL_GetPerformanceCounter() - started_at;
+    auto elapsed_ns = static_cast<uint64_t>(static_cast<double>(elapsed) * 1.0e9 / static_cast<double>(SDL_GetPerformanceFrequency()));
+
+    mixer->m_lastCallbackNs.store(elapsed_ns, std::memory_order_relaxed);
+
+    if (elapsed_ns > mixer->m_peakCallbackNs.load(std::memory_order_relaxed)) {
+        mixer->m_peakCallbackNs.store(elapsed_ns, std::memory_order_relaxed);
+    }
+
+    mixer->m_callbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void dino::AudioMixer::mixVoices_(int16_t* stream, int frames) {
+    bool is_silent = true;
+
+    /* Reading also services a pending seek, so paused streams are read too. */
+    if (m_activeStream != nullptr) {
+        int streamed = m_activeStream->read(m_resampleBuffer->data(), frames);
+
+        if (streamed > 0) {
+            std::fill(m_mixBuffer->begin(), m_mixBuffer->begin() + frames * 2, 0.0f);
+            dino::SampleKernels::mixStereo(m_mixBuffer->data(), m_resampleBuffer->data(), streamed, m_musicGain, m_musicGain);
+
+            is_silent = false;
+        }
+    }
+
+    for (auto& voice : *m_voices) {
+        if (voice.effectId < 0) {
+            continue;
+        }
+
+        if (is_silent) {
+            std::fill(m_mixBuffer->begin(), m_mixBuffer->begin() + frames * 2, 0.0f);
+            is_silent = false;
+        }
+
+        mixVoice_(voice, frames);
+    }
+
+    if (!is_silent) {
+        dino::SampleKernels::mixIntoS16(stream, m_mixBuffer->data(), frames * 2);
+    }
+}
+
+void dino::AudioMixer::mixVoice_(dino::AudioVoice& voice, int frames) {
+    const float* source = voice.clip->samples.data();
+    float gain_left  = voice.gain * voice.panLeft;
+    float gain_right = voice.gain * voice.panRight;
+    int produced;
+
+    if (voice.step == 1.0) {
+        auto start = static_cast<int>(voice.position);
+        produced = std::clamp(voice.clip->frames - start, 0, frames);
+
+        dino::SampleKernels::mixStereo(m_mixBuffer->data(), source + start * 2, produced, gain_left, gain_right);
+        voice.position = voice.position + produced;
+
+    } else {
+        produced = dino::SampleKernels::resampleStereo(m_resampleBuffer->data(), source, voice.clip->frames,
+                &(voice.position), voice.step, frames);
+
+        dino::SampleKernels::mixStereo(m_mixBuffer->data(), m_resampleBuffer->data(), produced, gain_left, gain_right);
+    }
+
+    if (produced < frames) {
+        voice.effectId = -1;
+        voice.clip = nullptr;
+    }
 }
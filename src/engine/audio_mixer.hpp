@@ -29,10 +29,15 @@
 
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "platform/standard.hpp"
+#include "platform/spsc_ring.hpp"
+#include "platform/virtual_filesystem.hpp"
+#include "audio_stream.hpp"
 
 #if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
 #include <SDL.h>
@@ -42,10 +47,168 @@
 #include <SDL2/SDL_mixer.h>
 #endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
 
+#define DINO_AUDIO_DEFAULT_VOICES 16
+
+/* Commands the game thread may queue between two mixer callbacks. */
+#define DINO_AUDIO_COMMAND_QUEUE_SIZE 256
+
+/* Largest device buffer the mixer can process in one pass. */
+#define DINO_AUDIO_MAX_BUFFER_FRAMES 4096
+
 namespace dino {
 
+/**
+ * @brief Decoded PCM data of a sound effect.
+ *
+ * Samples are interleaved stereo floats at the device frequency.
+ */
+struct audio_clip {
+    std::vector<float> samples;
+    int frames = 0;
+};
+
+typedef struct audio_clip AudioClip;
+
+/**
+ * @brief A sound effect loaded into the mixer.
+ */
+struct audio_effect {
+    AudioClip* clip = nullptr;
+
+    /**
+     * @brief Effects with a higher priority may steal voices from lower ones.
+     */
+    int priority = 0;
+
+    /**
+     * @brief Maximum number of voices the effect may play on at once.
+     */
+    int maxVoices = 1;
+};
+
+typedef struct audio_effect AudioEffect;
+
+/**
+ * @brief A software voice and the effect playing on it.
+ */
+struct audio_voice {
+    /**
+     * @brief Effect playing on the voice, -1 if the voice is free.
+     */
+    int effectId = -1;
+
+    int priority = 0;
+
+    /**
+     * @brief Sequence number of the play request, used to find the oldest voice.
+     */
+    unsigned long sequence = 0;
+
+    const AudioClip* clip = nullptr;
+
+    /**
+     * @brief Read position in clip frames.
+     */
+    double position = 0.0;
+
+    /**
+     * @brief Clip frames consumed per output frame.
+     */
+    double step = 1.0;
+
+    float gain = 1.0f;
+
+    /**
+     * @brief Equal power pan factors of each channel.
+     */
+    float panLeft  = 1.0f;
+    float panRight = 1.0f;
+};
+
+typedef struct audio_voice AudioVoice;
+
+/**
+ * @brief A request sent from the game thread to the audio thread.
+ */
+struct audio_command {
+    enum CommandType : int {
+        PLAY_EFFECT = 0,
+        STOP_EFFECT,
+        SET_EFFECT_GAIN,
+        PLAY_MUSIC,
+        PAUSE_MUSIC,
+        SEEK_MUSIC,
+        SET_MUSIC_GAIN,
+        SET_MUSIC_STREAM
+    };
+
+    int type = PLAY_EFFECT;
+    int effectId = -1;
+
+    /**
+     * @brief Effect properties copied at request time, so the audio
+     * thread never reads the effect table.
+     */
+    const AudioClip* clip = nullptr;
+    int priority  = 0;
+    int maxVoices = 1;
+
+    float gain     = 1.0f;
+    float panLeft  = 1.0f;
+    float panRight = 1.0f;
+
+    /**
+     * @brief Playback rate of an effect, or seek position in seconds.
+     */
+    double value = 1.0;
+
+    AudioStream* stream = nullptr;
+};
+
+typedef struct audio_command AudioCommand;
+
+/**
+ * @brief Timing of the mixer callback.
+ */
+struct mixer_stats {
+    double lastCallbackMs = 0.0;
+    double peakCallbackMs = 0.0;
+
+    /**
+     * @brief Duration of audio produced by one callback.
+     *
+     * A callback taking longer than this causes an underrun.
+     */
+    double bufferMs = 0.0;
+
+    unsigned long callbacks = 0;
+
+    /**
+     * @brief Callbacks in which the streamed BGM was not decoded in time.
+     */
+    unsigned long streamUnderruns = 0;
+
+    /**
+     * @brief Commands dropped because the queue was full.
+     */
+    unsigned long droppedCommands = 0;
+};
+
+typedef struct mixer_stats MixerStats;
+
 /**
  * @brief Provides audio mixing and managing utilities.
+ *
+ * Sound effects are mixed by the engine itself in a post-mix callback
+ * that runs on the audio thread, using the vectorised kernels in
+ * dino::SampleKernels. The BGM is streamed into the same callback by
+ * dino::AudioStream, SDL_mixer only opens the device and
+ * decodes effects.
+ *
+ * The public functions must be called from a single thread, the game
+ * thread. They never take the audio device lock, requests are queued
+ * as dino::AudioCommand and applied by the audio thread at the start
+ * of the next callback.
  */
 class AudioMixer {
 
@@ -56,20 +219,172 @@ private:
     bool m_isLooping;
 
     /**
-     * @brief Holds the BGM bytes.
+     * @brief Streams the BGM.
+     *
+     * The latest stream handed to the audio thread, owned by the game thread.
+     */
+    AudioStream* m_loopStream = nullptr;
+
+    /**
+     * @brief Output frequency of the audio device.
+     */
+    int m_frequency = 44100;
+
+    /**
+     * @brief Holds additional sound effects indexed by their identifier.
+     */
+    std::vector<AudioEffect>* m_effects;
+
+    /**
+     * @brief Clips and streams replaced by the game thread, freed once the
+     * audio thread has applied the command that released them.
+     */
+    struct retired_asset {
+        unsigned long sequence;
+        AudioClip* clip;
+        AudioStream* stream;
+    };
+
+    std::vector<retired_asset>* m_retiredAssets;
+
+    /**
+     * @brief Carries requests from the game thread to the audio thread.
+     */
+    SpscRing<AudioCommand>* m_commands;
+
+    /**
+     * @brief Number of commands queued, owned by the game thread.
+     */
+    unsigned long m_commandSequence = 0;
+
+    std::atomic<unsigned long> m_droppedCommands {0};
+
+    /* ===-=== Audio thread state ===-=== */
+
+    /**
+     * @brief Number of commands applied, published by the audio thread.
+     */
+    std::atomic<unsigned long> m_appliedCommands {0};
+
+    /**
+     * @brief Number of busy voices, published by the audio thread.
+     */
+    std::atomic<int> m_activeVoices {0};
+
+    /**
+     * @brief Holds the software voices.
+     */
+    std::vector<AudioVoice>* m_voices;
+
+    /**
+     * @brief Incremented on every play request.
+     */
+    unsigned long m_voiceSequence = 0;
+
+    /**
+     * @brief The BGM stream being mixed.
+     */
+    AudioStream* m_activeStream = nullptr;
+
+    float m_musicGain = 1.0f;
+
+    /**
+     * @brief Float accumulation buffer of the mixer callback.
+     */
+    std::vector<float>* m_mixBuffer;
+
+    /**
+     * @brief Scratch buffer for resampled voices.
+     */
+    std::vector<float>* m_resampleBuffer;
+
+    /**
+     * @brief Callback timings in nanoseconds, written by the audio thread.
+     */
+    std::atomic<uint64_t> m_lastCallbackNs {0};
+    std::atomic<uint64_t> m_peakCallbackNs {0};
+    std::atomic<uint64_t> m_callbackFrames {0};
+    std::atomic<unsigned long> m_callbacks {0};
+
+    /**
+     * @brief Post-mix callback registered with SDL_mixer.
+     * @param userdata The mixer instance.
+     * @param stream Device buffer, silent when the callback starts.
+     * @param length Buffer length in bytes.
+     */
+    static void mixCallback_(void*, Uint8*, int);
+
+    /**
+     * @brief Applies every queued command. Audio thread only.
+     */
+    void applyCommands_();
+
+    /**
+     * @brief Applies a single command. Audio thread only.
+     * @param command The command.
      */
-    Mix_Music* m_loopAudio;
+    void applyCommand_(const AudioCommand&);
 
     /**
-     * @brief Holds additional sound effects mapped by an identifier.
+     * @brief Queues a command for the audio thread.
+     * @param command The command.
+     * @return True if queued, false if the queue is full.
      */
-    std::map<unsigned int, Mix_Chunk*>* m_effectMap;
+    bool pushCommand_(const AudioCommand&);
+
+    /**
+     * @brief Frees retired clips and streams the audio thread no longer uses.
+     */
+    void collectRetired_();
+
+    /**
+     * @brief Converts a chunk decoded by SDL_mixer into a clip.
+     * @param mix_chunk The chunk, freed by the call.
+     * @return The clip, nullptr if the chunk is nullptr.
+     */
+    static AudioClip* convertChunk_(Mix_Chunk*);
+
+    /**
+     * @brief Hands the BGM stream to the audio thread, retiring the previous one.
+     * @param loop_stream The stream, nullptr to leave the BGM silent.
+     * @throw dino::EngineError Thrown if the command queue is full.
+     *
+     * The previous stream is closed first, so its file is no longer read.
+     */
+    void setLoopStream_(AudioStream*);
+
+    /**
+     * @brief Mixes all active voices into the device buffer.
+     * @param stream Device buffer as signed 16 bit stereo samples.
+     * @param frames Number of frames in the buffer.
+     */
+    void mixVoices_(int16_t*, int);
+
+    /**
+     * @brief Mixes a single voice into the accumulation buffer.
+     * @param voice The voice.
+     * @param frames Number of frames wanted.
+     */
+    void mixVoice_(AudioVoice&, int);
+
+    /**
+     * @brief Picks the voice a new instance of an effect should play on.
+     * @param command The play command.
+     * @return Voice index, or -1 if the effect should not be played.
+     *
+     * The effect takes its own oldest voice once it reaches its voice
+     * limit. Otherwise a free voice is used, and if there is none the
+     * oldest voice among the lowest priority ones is stolen, provided
+     * its priority is not higher than the priority of the effect.
+     */
+    int allocateVoice_(const AudioCommand&);
 
 public:
     /**
      * @brief Initialises the instance.
+     * @param voice_count Number of voices available to effects.
      */
-    AudioMixer();
+    explicit AudioMixer(int voice_count = DINO_AUDIO_DEFAULT_VOICES);
 
     /**
      * @brief Cleans up when an instance is destroyed.
@@ -85,29 +400,143 @@ public:
 
     /**
      * @brief Loads an audio file and sets as game BGM.
-     * @param audio_file Absolute path to the WAV file.
+     * @param audio_file Absolute path to the audio file.
      * @throw dino::EngineError Thrown if audio loading fails.
+     *
+     * WAVE files are decoded in the background while they play, MP3
+     * and the other formats SDL_mixer reads are decoded by the call.
+     * See dino::AudioStream.
      */
     void loadLoopAudio(const std::string&);
 
+    /**
+     * @brief Loads an audio file in memory and sets as game BGM.
+     * @param audio_data Bytes of the audio file.
+     * @throw dino::EngineError Thrown if audio loading fails.
+     *
+     * WAVE files are streamed in place by dino::AudioStream, so the
+     * bytes must stay valid until the BGM is replaced or unloaded. Files
+     * of a mounted asset pack always do.
+     */
+    void loadLoopAudio(const FileView&);
+
+    /**
+     * @brief Stops the BGM and closes its file.
+     *
+     * Call before freeing the bytes of a BGM loaded from memory.
+     */
+    void unloadLoopAudio();
+
     /**
      * @brief Plays the loaded BGM infinitely or until paused.
      */
     void playLoopAudio();
 
+    /**
+     * @brief Checks if the BGM is playing.
+     * @return True if playing, false if paused or not loaded.
+     */
+    [[nodiscard]] bool isLoopPlaying() const {
+        return m_isLooping;
+    }
+
+    /**
+     * @brief Moves the playback position of the BGM.
+     * @param seconds Position from the start of the track.
+     */
+    void seekLoopAudio(double);
+
+    /**
+     * @brief Sets the volume of the BGM.
+     * @param gain Volume, 1 plays the BGM as recorded.
+     */
+    void setLoopGain(float);
+
     /**
      * Loads an audio file and maps it as an effect with and identifier.
      * @param effect_id Numeric identifier to identify this audio.
      * @param audio_file Absolute path to the WAV file.
+     * @param priority Voice stealing priority.
+     * @param max_voices Maximum number of simultaneous voices.
+     * @throw dino::EngineError Thrown if audio loading fails.
+     *
+     * Identifiers index a flat table, so they should be small and dense.
+     * Loading an identifier again replaces the previous effect.
+     */
+    void loadEffectAudio(unsigned int, const std::string&, int priority = 0, int max_voices = 1);
+
+    /**
+     * @brief Loads an audio file in memory and maps it as an effect with an identifier.
+     * @param effect_id Numeric identifier to identify this audio.
+     * @param audio_data Bytes of the WAV file, only read during the call.
+     * @param priority Voice stealing priority.
+     * @param max_voices Maximum number of simultaneous voices.
      * @throw dino::EngineError Thrown if audio loading fails.
      */
-    void loadEffectAudio(unsigned int, const std::string&);
+    void loadEffectAudio(unsigned int, const FileView&, int priority = 0, int max_voices = 1);
+
+    /**
+     * @brief Decodes an effect for replaceEffectClip(), safe to call from any thread.
+     * @param audio_file Absolute path to the WAV file.
+     * @return The clip, nullptr if decoding fails.
+     *
+     * The mixer must be open, the clip is converted to its device format.
+     */
+    static AudioClip* decodeEffect(const std::string&);
+
+    /**
+     * @brief Decodes an effect in memory, safe to call from any thread.
+     * @param audio_data Bytes of the WAV file.
+     * @return The clip, nullptr if decoding fails.
+     */
+    static AudioClip* decodeEffect(const FileView&);
+
+    /**
+     * @brief Swaps the clip of an effect, keeping its priority and voice limit.
+     * @param effect_id Numeric identifier of the effect.
+     * @param clip The new clip, owned by the mixer from now on.
+     * @throw dino::EngineError Thrown if the audio command queue is full, the clip is freed.
+     *
+     * Voices playing the old clip are stopped, the old clip is freed
+     * once the audio thread no longer reads it.
+     */
+    void replaceEffectClip(unsigned int, AudioClip*);
 
     /**
      * @brief Plays a sound effect identified by an id.
      * @param effect_id The sound effect identifier.
+     * @param gain Volume, 1 plays the effect as recorded.
+     * @param pan Stereo position from -1 (left) to 1 (right).
+     * @param pitch Playback rate, 1 plays the effect as recorded.
+     *
+     * The request is dropped if no voice can be allocated.
+     */
+    void playEffectAudio(unsigned int, float gain = 1.0f, float pan = 0.0f, float pitch = 1.0f);
+
+    /**
+     * @brief Stops every voice playing a sound effect.
+     * @param effect_id The sound effect identifier.
+     */
+    void stopEffectAudio(unsigned int);
+
+    /**
+     * @brief Changes the volume of the voices playing a sound effect.
+     * @param effect_id The sound effect identifier.
+     * @param gain Volume, 1 plays the effect as recorded.
+     */
+    void setEffectGain(unsigned int, float);
+
+    /**
+     * @brief Returns the number of voices currently playing.
+     * @return Number of busy voices as of the last callback.
+     */
+    [[nodiscard]] int getActiveVoices() const;
+
+    /**
+     * @brief Returns the timing of the mixer callback.
+     * @return The mixer statistics.
      */
-    void playEffectAudio(unsigned int);
+    [[nodiscard]] MixerStats getStats() const;
 };
 
-} // namespace dino
\ No newline at end of file
+} // namespace dino
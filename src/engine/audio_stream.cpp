@@ -0,0 +1,667 @@
+/**
+ * audio_stream.cpp - Streaming audio source definition
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "platform/standard.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL.h>
+#include <SDL_mixer.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+#include "platform/memory_tracker.hpp"
+#include "assert.hpp"
+#include "sample_kernels.hpp"
+#include "audio_stream.hpp"
+
+/* Format tags of the WAVE fmt chunk. */
+#define DINO_WAVE_FORMAT_PCM        0x0001
+#define DINO_WAVE_FORMAT_IMA_ADPCM  0x0011
+#define DINO_WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+namespace {
+
+/**
+ * @brief Layout of a RIFF WAVE file, read from its fmt and data chunks.
+ */
+struct wave_format {
+    int tag        = 0;
+    int channels   = 0;
+    int frequency  = 0;
+    int blockAlign = 0;
+    int bits       = 0;
+
+    /**
+     * @brief File offset of the first sample.
+     */
+    Sint64 dataStart = -1;
+
+    Uint32 dataBytes = 0;
+};
+
+typedef struct wave_format WaveFormat;
+
+/**
+ * @brief Reads the header of a RIFF WAVE file, leaving the file at the first sample.
+ * @param file The file, at its start.
+ * @param format Receives the layout.
+ * @return True if the file is a RIFF WAVE file with a data chunk.
+ */
+bool readWaveHeader_(SDL_RWops* file, WaveFormat* format) {
+    char riff[12];
+
+    if (SDL_RWread(file, riff, 1, sizeof(riff)) != sizeof(riff) ||
+            std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    char chunk_id[4];
+
+    while (SDL_RWread(file, chunk_id, 1, sizeof(chunk_id)) == sizeof(chunk_id)) {
+        Uint32 chunk_size = SDL_ReadLE32(file);
+        Sint64 chunk_end  = SDL_RWtell(file) + chunk_size + (chunk_size & 1);
+
+        if (std::memcmp(chunk_id, "data", 4) == 0) {
+            format->dataStart = SDL_RWtell(file);
+            format->dataBytes = chunk_size;
+
+            return true;
+        }
+
+        if (std::memcmp(chunk_id, "fmt ", 4) == 0) {
+            format->tag       = SDL_ReadLE16(file);
+            format->channels  = SDL_ReadLE16(file);
+            format->frequency = static_cast<int>(SDL_ReadLE32(file));
+
+            /* Skip the byte rate. */
+            SDL_ReadLE32(file);
+
+            format->blockAlign = SDL_ReadLE16(file);
+            format->bits = SDL_ReadLE16(file);
+        }
+
+        if (SDL_RWseek(file, chunk_end, RW_SEEK_SET) < 0) {
+            break;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Streams the data chunk of a 16 bit PCM RIFF WAVE file.
+ */
+class WaveDecoder : public dino::StreamDecoder {
+
+private:
+    SDL_RWops* m_file;
+
+    WaveFormat m_format;
+
+    Uint32 m_remainingBytes = 0;
+
+public:
+    /**
+     * @param file The file at its first sample, closed by the decoder.
+     * @param format Layout of the file, 16 bit PCM.
+     */
+    WaveDecoder(SDL_RWops* file, const WaveFormat& format) : m_file(file), m_format(format) {
+        m_format.blockAlign = m_format.channels * static_cast<int>(sizeof(int16_t));
+        m_remainingBytes = m_format.dataBytes;
+    }
+
+    ~WaveDecoder() override {
+        SDL_RWclose(m_file);
+    }
+
+    [[nodiscard]] int getFrequency() const override {
+        return m_format.frequency;
+    }
+
+    [[nodiscard]] int getChannels() const override {
+        return m_format.channels;
+    }
+
+    int decode(int16_t* samples, int frames) override {
+        auto block_align = static_cast<Uint32>(m_format.blockAlign);
+        frames = std::min(frames, static_cast<int>(m_remainingBytes / block_align));
+
+        if (frames <= 0) {
+            return 0;
+        }
+
+        auto decoded = SDL_RWread(m_file, samples, block_align, static_cast<std::size_t>(frames));
+        m_remainingBytes = m_remainingBytes - static_cast<Uint32>(decoded) * block_align;
+
+        return static_cast<int>(decoded);
+    }
+
+    bool seek(long frame) override {
+        auto block_align = static_cast<Uint32>(m_format.blockAlign);
+        auto offset = static_cast<Uint32>(std::clamp<long>(frame, 0, m_format.dataBytes / block_align)) * block_align;
+
+        m_remainingBytes = m_format.dataBytes - offset;
+
+        return SDL_RWseek(m_file, m_format.dataStart + offset, RW_SEEK_SET) >= 0;
+    }
+};
+
+/**
+ * @brief Streams a 4 bit IMA ADPCM RIFF WAVE file, a quarter of the size of 16 bit PCM.
+ *
+ * The file is a sequence of independent blocks, each decoded in full
+ * when the previous one runs out, so a seek only decodes one block.
+ */
+class AdpcmDecoder : public dino::StreamDecoder {
+
+private:
+    static constexpr int STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+        253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+        1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+        12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    static constexpr int INDEX_TABLE[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    SDL_RWops* m_file;
+
+    WaveFormat m_format;
+
+    /**
+     * @brief Frames in a full block, the first one is stored in the block header.
+     */
+    int m_blockFrames;
+
+    Uint32 m_remainingBytes = 0;
+
+    std::vector<Uint8> m_blockBytes;
+
+    /**
+     * @brief Interleaved samples of the current block.
+     */
+    std::vector<int16_t> m_blockSamples;
+
+    int m_decodedFrames = 0;
+    int m_blockPosition = 0;
+
+    /**
+     * @brief Decodes a nibble, updating the predictor and the step index of its channel.
+     */
+    static int16_t decodeNibble_(int nibble, int& predictor, int& index) {
+        int step = STEP_TABLE[index];
+        int diff = step >> 3;
+
+        diff = (nibble & 1) != 0 ? diff + (step >> 2) : diff;
+        diff = (nibble & 2) != 0 ? diff + (step >> 1) : diff;
+        diff = (nibble & 4) != 0 ? diff + step : diff;
+
+        predictor = std::clamp((nibble & 8) != 0 ? predictor - diff : predictor + diff, -32768, 32767);
+        index     = std::clamp(index + INDEX_TABLE[nibble], 0, 88);
+
+        return static_cast<int16_t>(predictor);
+    }
+
+    /**
+     * @brief Reads and decodes the next block, a truncated last block is decoded as far as it goes.
+     */
+    void decodeBlock_() {
+        int channels = m_format.channels;
+        auto length  = SDL_RWread(m_file, m_blockBytes.data(), 1, std::min<std::size_t>(m_remainingBytes, m_blockBytes.size()));
+
+        m_remainingBytes = m_remainingBytes - static_cast<Uint32>(length);
+        m_decodedFrames  = 0;
+        m_blockPosition  = 0;
+
+        int header = 4 * channels;
+
+        if (static_cast<int>(length) < header) {
+            m_remainingBytes = 0;
+            return void();
+        }
+
+        int predictor[2];
+        int index[2];
+
+        for (int channel = 0; channel < channels; channel++) {
+            const Uint8* bytes = &(m_blockBytes[4 * channel]);
+
+            predictor[channel] = static_cast<int16_t>(bytes[0] | (bytes[1] << 8));
+            index[channel]     = std::min<int>(bytes[2], 88);
+
+            m_blockSamples[channel] = static_cast<int16_t>(predictor[channel]);
+        }
+
+        /* Every channel takes turns with 4 bytes, 8 samples, low nibble first. */
+        int groups = (static_cast<int>(length) - header) / header;
+
+        for (int group = 0; group < groups; group++) {
+            for (int channel = 0; channel < channels; channel++) {
+                const Uint8* bytes = &(m_blockBytes[header + (group * channels + channel) * 4]);
+                int16_t* target = &(m_blockSamples[(1 + group * 8) * channels + channel]);
+
+                for (int offset = 0; offset < 4; offset++) {
+                    target[(offset * 2) * channels]     = decodeNibble_(bytes[offset] & 0x0F, predictor[channel], index[channel]);
+                    target[(offset * 2 + 1) * channels] = decodeNibble_(bytes[offset] >> 4, predictor[channel], index[channel]);
+                }
+            }
+        }
+
+        m_decodedFrames = 1 + groups * 8;
+    }
+
+    [[noreturn]] void fail_(const char* message) {
+        SDL_RWclose(m_file);
+        throw dino::EngineError(message, dino::EngineError::E_TYPE_MIX_RESULT);
+    }
+
+public:
+    /**
+     * @param file The file at its first block, closed by the decoder.
+     * @param format Layout of the file, IMA ADPCM.
+     * @throw dino::EngineError Thrown if the layout is not valid IMA ADPCM.
+     */
+    AdpcmDecoder(SDL_RWops* file, const WaveFormat& format) : m_file(file), m_format(format) {
+        int channels = m_format.channels;
+
+        if (m_format.bits != 4 || channels < 1 || channels > 2 || m_format.frequency <= 0 ||
+                m_format.blockAlign <= 4 * channels || m_format.blockAlign % (4 * channels) != 0) {
+            fail_("Only 4 bit mono or stereo IMA ADPCM WAVE files can be streamed.");
+        }
+
+        m_blockFrames = 1 + (m_format.blockAlign - 4 * channels) * 2 / channels;
+        m_remainingBytes = m_format.dataBytes;
+
+        m_blockBytes.resize(static_cast<std::size_t>(m_format.blockAlign));
+        m_blockSamples.resize(static_cast<std::size_t>(m_blockFrames * channels));
+    }
+
+    ~AdpcmDecoder() override {
+        SDL_RWclose(m_file);
+    }
+
+    [[nodiscard]] int getFrequency() const override {
+        return m_format.frequency;
+    }
+
+    [[nodiscard]] int getChannels() const override {
+        return m_format.channels;
+    }
+
+    int decode(int16_t* samples, int frames) override {
+        int decoded = 0;
+
+        while (decoded < frames) {
+            if (m_blockPosition == m_decodedFrames) {
+                if (m_remainingBytes == 0) {
+                    break;
+                }
+
+                decodeBlock_();
+                continue;
+            }
+
+            int count = std::min(frames - decoded, m_decodedFrames - m_blockPosition);
+            auto first = m_blockSamples.begin() + m_blockPosition * m_format.channels;
+
+            std::copy(first, first + count * m_format.channels, samples + decoded * m_format.channels);
+
+            decoded = decoded + count;
+            m_blockPosition = m_blockPosition + count;
+        }
+
+        return decoded;
+    }
+
+    bool seek(long frame) override {
+        auto block_align = static_cast<Uint32>(m_format.blockAlign);
+        auto block_count = static_cast<long>((m_format.dataBytes + block_align - 1) / block_align);
+        long block       = std::clamp<long>(frame / m_blockFrames, 0, block_count);
+
+        auto offset = static_cast<Uint32>(block) * block_align;
+
+        m_remainingBytes = m_format.dataBytes - std::min(offset, m_format.dataBytes);
+        m_decodedFrames  = 0;
+        m_blockPosition  = 0;
+
+        if (SDL_RWseek(m_file, m_format.dataStart + offset, RW_SEEK_SET) < 0) {
+            return false;
+        }
+
+        if (m_remainingBytes > 0) {
+            decodeBlock_();
+            m_blockPosition = std::min(static_cast<int>(std::max(frame, 0L) % m_blockFrames), m_decodedFrames);
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief Plays any other format SDL_mixer can load, e.g. MP3, Ogg Vorbis or FLAC.
+ *
+ * SDL_mixer has no incremental decoder for these, so the whole file is
+ * decoded to the device format up front and served from memory.
+ */
+class ChunkDecoder : public dino::StreamDecoder {
+
+private:
+    Mix_Chunk* m_chunk;
+
+    int m_frequency = 0;
+    int m_channels  = 0;
+
+    long m_frames   = 0;
+    long m_position = 0;
+
+public:
+    /**
+     * @param file The file, closed by the call.
+     * @throw dino::EngineError Thrown if SDL_mixer cannot decode the file.
+     */
+    explicit ChunkDecoder(SDL_RWops* file) {
+        m_chunk = Mix_LoadWAV_RW(file, 1);
+        DINO_ASSERT_SDL_HANDLE(m_chunk, dino::EngineError::E_TYPE_MIX_RESULT)
+
+        Uint16 format = 0;
+
+        if (Mix_QuerySpec(&m_frequency, &format, &m_channels) == 0 || format != AUDIO_S16SYS || m_channels < 1 || m_channels > 2) {
+            Mix_FreeChunk(m_chunk);
+            throw dino::EngineError("Audio device must be opened as signed 16 bit mono or stereo.", dino::EngineError::E_TYPE_MIX_RESULT);
+        }
+
+        m_frames = static_cast<long>(m_chunk->alen / (sizeof(int16_t) * static_cast<Uint32>(m_channels)));
+    }
+
+    ~ChunkDecoder() override {
+        Mix_FreeChunk(m_chunk);
+    }
+
+    [[nodiscard]] int getFrequency() const override {
+        return m_frequency;
+    }
+
+    [[nodiscard]] int getChannels() const override {
+        return m_channels;
+    }
+
+    int decode(int16_t* samples, int frames) override {
+        auto count = static_cast<int>(std::min<long>(frames, m_frames - m_position));
+        auto first = reinterpret_cast<const int16_t*>(m_chunk->abuf) + m_position * m_channels;
+
+        std::copy(first, first + count * m_channels, samples);
+        m_position = m_position + count;
+
+        return count;
+    }
+
+    bool seek(long frame) override {
+        m_position = std::clamp<long>(frame, 0, m_frames);
+        return true;
+    }
+};
+
+/**
+ * @brief Picks a decoder by the content of a file.
+ * @param file The file, owned by the decoder from now on.
+ * @return The decoder.
+ * @throw dino::EngineError Thrown if the file cannot be opened or decoded.
+ */
+dino::StreamDecoder* openDecoder_(SDL_RWops* file) {
+    DINO_ASSERT_SDL_HANDLE(file, dino::EngineError::E_TYPE_SDL_RESULT)
+
+    WaveFormat format {};
+
+    if (readWaveHeader_(file, &format)) {
+        bool is_pcm = format.tag == DINO_WAVE_FORMAT_PCM || format.tag == DINO_WAVE_FORMAT_EXTENSIBLE;
+
+        /* WAVE_FORMAT_EXTENSIBLE is still plain PCM at 16 bits. */
+        if (is_pcm && format.bits == 16 && format.channels >= 1 && format.channels <= 2 && format.frequency > 0) {
+            return new WaveDecoder(file, format);
+        }
+
+        if (format.tag == DINO_WAVE_FORMAT_IMA_ADPCM) {
+            return new AdpcmDecoder(file, format);
+        }
+    }
+
+    if (SDL_RWseek(file, 0, RW_SEEK_SET) < 0) {
+        SDL_RWclose(file);
+        throw dino::EngineError("Audio file cannot be rewound.", dino::EngineError::E_TYPE_SDL_RESULT);
+    }
+
+    return new ChunkDecoder(file);
+}
+
+} // namespace
+
+dino::AudioStream::AudioStream(const std::string& audio_file, int frequency, bool is_looping) :
+        m_isLooping(is_looping) {
+
+    dino::MemoryScope memory_scope(dino::MemoryTracker::AUDIO);
+
+    m_decoder = openDecoder_(SDL_RWFromFile(audio_file.c_str(), "rb"));
+    start_(frequency);
+}
+
+dino::AudioStream::AudioStream(const dino::FileView& audio_data, int frequency, bool is_looping) :
+        m_isLooping(is_looping) {
+
+    dino::MemoryScope memory_scope(dino::MemoryTracker::AUDIO);
+
+    m_decoder = openDecoder_(SDL_RWFromConstMem(audio_data.data, static_cast<int>(audio_data.size)));
+    start_(frequency);
+}
+
+void dino::AudioStream::start_(int frequency) {
+    m_sourceFrequency = m_decoder->getFrequency();
+    m_step = static_cast<double>(m_sourceFrequency) / static_cast<double>(frequency);
+
+    /* Worst case output of one chunk, the ring must hold at least two of them. */
+    auto output_frames = static_cast<std::size_t>(DINO_AUDIO_STREAM_CHUNK_FRAMES / m_step) + 4;
+    auto ring_frames   = std::max<std::size_t>(DINO_AUDIO_STREAM_RING_FRAMES, output_frames * 2);
+
+    m_ring = new dino::SpscRing<float>(ring_frames * 2);
+
+    m_decodeBuffer.resize(DINO_AUDIO_STREAM_CHUNK_FRAMES * 2);
+
+    /* One extra frame in front carries the last frame of the previous chunk. */
+    m_sourceBuffer.resize((DINO_AUDIO_STREAM_CHUNK_FRAMES + 1) * 2, 0.0f);
+    m_outputBuffer.resize(output_frames * 2);
+
+    /* The carried frame does not exist before the first chunk. */
+    m_position = 1.0;
+
+    m_decodeThread = new std::thread(&dino::AudioStream::decodeLoop_, this);
+}
+
+dino::AudioStream::~AudioStream() {
+    close();
+    delete m_ring;
+}
+
+void dino::AudioStream::close() {
+    m_isRunning.store(false);
+
+    if (m_decodeThread != nullptr && m_decodeThread->joinable()) {
+        m_decodeThread->join();
+    }
+
+    delete m_decodeThread;
+    delete m_decoder;
+
+    m_decodeThread = nullptr;
+    m_decoder = nullptr;
+
+    /* Nothing refills the ring, running dry is no longer an underrun. */
+    m_isExhausted.store(true, std::memory_order_release);
+}
+
+void dino::AudioStream::decodeLoop_() {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::AUDIO);
+
+    while (m_isRunning.load(std::memory_order_relaxed)) {
+        int seek_state = m_seekState.load(std::memory_order_acquire);
+
+        if (seek_state == SEEK_REQUESTED) {
+            m_decoder->seek(m_seekFrame.load(std::memory_order_relaxed));
+
+            /* The carried frame belongs to the old position. */
+            m_sourceBuffer[0] = 0.0f;
+            m_sourceBuffer[1] = 0.0f;
+            m_position = 1.0;
+
+            m_isExhausted.store(false, std::memory_order_relaxed);
+            m_seekState.store(SEEK_DONE, std::memory_order_release);
+        }
+
+        if (seek_state != SEEK_IDLE) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        bool has_space = m_ring->capacity() - m_ring->size() >= m_outputBuffer.size();
+
+        if (m_isExhausted.load(std::memory_order_relaxed) || !has_space) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        if (!decodeChunk_()) {
+            m_isExhausted.store(true, std::memory_order_release);
+        }
+    }
+}
+
+bool dino::AudioStream::decodeChunk_() {
+    int frames = m_decoder->decode(m_decodeBuffer.data(), DINO_AUDIO_STREAM_CHUNK_FRAMES);
+
+    if (frames <= 0) {
+        if (!m_isLooping || !m_decoder->seek(0)) {
+            return false;
+        }
+
+        frames = m_decoder->decode(m_decodeBuffer.data(), DINO_AUDIO_STREAM_CHUNK_FRAMES);
+
+        if (frames <= 0) {
+            return false;
+        }
+    }
+
+    float* source = m_sourceBuffer.data();
+
+    if (m_decoder->getChannels() == 2) {
+        dino::SampleKernels::convertS16(source + 2, m_decodeBuffer.data(), frames * 2);
+
+    } else {
+        dino::SampleKernels::convertS16(source + 2, m_decodeBuffer.data(), frames);
+
+        /* Widen to stereo in place, back to front so nothing is overwritten before it is read. */
+        for (int index = frames - 1; index >= 0; index--) {
+            float sample = source[2 + index];
+
+            source[2 + 2 * index]     = sample;
+            source[2 + 2 * index + 1] = sample;
+        }
+    }
+
+    if (m_step == 1.0) {
+        m_ring->write(source + 2, static_cast<std::size_t>(frames) * 2);
+
+    } else {
+        int capacity = static_cast<int>(m_outputBuffer.size() / 2);
+        int produced = dino::SampleKernels::resampleStereo(m_outputBuffer.data(), source, frames + 1, &m_position, m_step, capacity);
+
+        m_ring->write(m_outputBuffer.data(), static_cast<std::size_t>(produced) * 2);
+
+        /* The last frame becomes the carried frame of the next chunk. */
+        m_position = m_position - frames;
+    }
+
+    source[0] = source[2 * frames];
+    source[1] = source[2 * frames + 1];
+
+    return true;
+}
+
+void dino::AudioStream::setPlaying(bool is_playing) {
+    m_isPlaying.store(is_playing, std::memory_order_release);
+}
+
+bool dino::AudioStream::isPlaying() const {
+    return m_isPlaying.load(std::memory_order_acquire);
+}
+
+void dino::AudioStream::seek(double seconds) {
+    auto frame = static_cast<long>(std::max(seconds, 0.0) * m_sourceFrequency);
+
+    m_seekFrame.store(frame, std::memory_order_relaxed);
+    m_seekState.store(SEEK_REQUESTED, std::memory_order_release);
+}
+
+int dino::AudioStream::read(float* target, int frames) {
+    int seek_state = m_seekState.load(std::memory_order_acquire);
+
+    if (seek_state != SEEK_IDLE) {
+        m_ring->drain();
+
+        /* The decoder thread produces nothing until it is released. */
+        if (seek_state == SEEK_DONE) {
+            m_seekState.store(SEEK_IDLE, std::memory_order_release);
+        }
+
+        return 0;
+    }
+
+    if (!isPlaying()) {
+        return 0;
+    }
+
+    auto available = static_cast<int>(m_ring->read(target, static_cast<std::size_t>(frames) * 2) / 2);
+
+    if (available < frames && !m_isExhausted.load(std::memory_order_acquire)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return available;
+}
+
+unsigned long dino::AudioStream::getUnderruns() const {
+    return m_underruns.load(std::memory_order_relaxed);
+}
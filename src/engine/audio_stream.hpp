@@ -0,0 +1,259 @@
+/**
+ * audio_stream.hpp - Streaming audio source declaration
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "platform/spsc_ring.hpp"
+#include "platform/virtual_filesystem.hpp"
+
+/* Frames decoded per pass of the decoder thread. */
+#define DINO_AUDIO_STREAM_CHUNK_FRAMES 2048
+
+/* Frames buffered between the decoder thread and the mixer, about 370 ms at 44.1 kHz. */
+#define DINO_AUDIO_STREAM_RING_FRAMES 16384
+
+namespace dino {
+
+/**
+ * @brief Decodes an audio file incrementally into signed 16 bit samples.
+ */
+class StreamDecoder {
+
+public:
+    virtual ~StreamDecoder() = default;
+
+    /**
+     * @brief Returns the sample rate of the file.
+     * @return Frequency in Hz.
+     */
+    [[nodiscard]] virtual int getFrequency() const = 0;
+
+    /**
+     * @brief Returns the number of channels in the file.
+     * @return 1 for mono, 2 for stereo.
+     */
+    [[nodiscard]] virtual int getChannels() const = 0;
+
+    /**
+     * @brief Decodes the next frames of the file.
+     * @param samples Receives interleaved samples.
+     * @param frames Maximum number of frames.
+     * @return Number of frames decoded, 0 at the end of the file.
+     */
+    virtual int decode(int16_t*, int) = 0;
+
+    /**
+     * @brief Moves to a frame of the file.
+     * @param frame The frame, 0 rewinds to the start.
+     * @return True on success, false otherwise.
+     */
+    virtual bool seek(long) = 0;
+};
+
+/**
+ * @brief Plays a long audio file without loading it fully.
+ *
+ * A background thread decodes the file in small chunks, converts them
+ * to stereo floats at the device frequency and pushes them into a
+ * lock-free ring buffer. The mixer callback pulls from the ring, so
+ * memory use is fixed regardless of the track length.
+ *
+ * Looping is handled by the decoder thread, which rewinds the file
+ * as soon as it runs out. The resampler carries its state across the
+ * loop point, so there is no gap or click between iterations.
+ *
+ * The decoder is picked by the content of the file. 16 bit PCM and
+ * 4 bit IMA ADPCM WAVE files are decoded incrementally. Any other
+ * format SDL_mixer can load, e.g. MP3, is decoded up front into memory
+ * instead, so such a stream does not have a fixed footprint.
+ */
+class AudioStream {
+
+private:
+    StreamDecoder* m_decoder;
+
+    SpscRing<float>* m_ring;
+
+    std::thread* m_decodeThread = nullptr;
+
+    std::atomic<bool> m_isRunning {true};
+    std::atomic<bool> m_isPlaying {false};
+
+    /**
+     * @brief Set by the decoder thread once the file can no longer be read.
+     */
+    std::atomic<bool> m_isExhausted {false};
+
+    /**
+     * @brief Seek handshake between the mixer and the decoder thread.
+     *
+     * The mixer requests a seek, the decoder thread seeks and stops
+     * producing, the mixer discards the stale frames and releases it.
+     */
+    enum SeekState : int {
+        SEEK_IDLE = 0,
+        SEEK_REQUESTED,
+        SEEK_DONE
+    };
+
+    std::atomic<int> m_seekState {SEEK_IDLE};
+    std::atomic<long> m_seekFrame {0};
+
+    /**
+     * @brief Number of callbacks the ring could not satisfy.
+     */
+    std::atomic<unsigned long> m_underruns {0};
+
+    bool m_isLooping;
+
+    /**
+     * @brief Sample rate of the file, kept for seeks once the decoder is closed.
+     */
+    int m_sourceFrequency = 0;
+
+    /**
+     * @brief Decoder thread buffers.
+     */
+    std::vector<int16_t> m_decodeBuffer;
+    std::vector<float> m_sourceBuffer;
+    std::vector<float> m_outputBuffer;
+
+    /**
+     * @brief File frames consumed per device frame.
+     */
+    double m_step;
+
+    /**
+     * @brief Resampler read position, relative to the chunk being resampled.
+     */
+    double m_position = 0.0;
+
+    /**
+     * @brief Sizes the buffers for the opened decoder and starts the decoder thread.
+     * @param frequency Output frequency of the audio device.
+     */
+    void start_(int);
+
+    /**
+     * @brief Runs on the decoder thread until the stream is closed.
+     */
+    void decodeLoop_();
+
+    /**
+     * @brief Decodes and queues one chunk.
+     * @return True if a chunk was queued, false at the end of a non-looping file.
+     */
+    bool decodeChunk_();
+
+public:
+    /**
+     * @brief Opens a file and starts decoding it in the background.
+     * @param audio_file Path to the audio file.
+     * @param frequency Output frequency of the audio device.
+     * @param is_looping Restarts the file when it ends if true.
+     * @throw dino::EngineError Thrown if the file cannot be opened or decoded.
+     *
+     * The constructor only reads the header of a streamed WAVE file,
+     * decoding starts on the background thread. Other formats are
+     * decoded by the constructor.
+     */
+    AudioStream(const std::string&, int, bool is_looping = true);
+
+    /**
+     * @brief Decodes a file in memory in the background.
+     * @param audio_data Bytes of the audio file, read for as long as the stream is open.
+     * @param frequency Output frequency of the audio device.
+     * @param is_looping Restarts the file when it ends if true.
+     * @throw dino::EngineError Thrown if the file cannot be decoded.
+     *
+     * Meant for files in a memory mapped asset pack, WAVE files are
+     * streamed in place without a copy.
+     */
+    AudioStream(const FileView&, int, bool is_looping = true);
+
+    /**
+     * @brief Stops the decoder thread and closes the file.
+     */
+    ~AudioStream();
+
+    AudioStream(const AudioStream&) = delete;
+
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    /**
+     * @brief Stops the decoder thread and closes the file, from the thread that owns the stream.
+     *
+     * The file is never read again, so its bytes can be freed. The mixer
+     * may keep reading the frames already decoded, then gets silence.
+     */
+    void close();
+
+    /**
+     * @brief Starts or pauses consumption by the mixer.
+     * @param is_playing True to play, false to pause.
+     */
+    void setPlaying(bool);
+
+    /**
+     * @brief Checks if the stream is being consumed.
+     * @return True if playing, false otherwise.
+     */
+    [[nodiscard]] bool isPlaying() const;
+
+    /**
+     * @brief Moves the playback position. Called only by the mixer callback.
+     * @param seconds Position from the start of the file.
+     *
+     * Frames decoded before the seek are discarded, the stream is silent
+     * until the decoder thread has refilled the ring.
+     */
+    void seek(double);
+
+    /**
+     * @brief Pulls decoded frames. Called only by the mixer callback.
+     * @param target Receives interleaved stereo floats.
+     * @param frames Number of frames wanted.
+     * @return Number of frames available, the remainder should be silence.
+     */
+    int read(float*, int);
+
+    /**
+     * @brief Returns the number of times the decoder fell behind.
+     * @return Underrun count.
+     */
+    [[nodiscard]] unsigned long getUnderruns() const;
+};
+
+} // namespace dino
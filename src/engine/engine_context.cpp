@@ -40,6 +40,7 @@
 #include "assert.hpp"
 #include "except.hpp"
 #include "graphics_driver.hpp"
+#include "sample_kernels.hpp"
 #include "engine_context.hpp"
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
@@ -49,8 +50,9 @@
 bool dino::EngineContext::s_isInitialised = false;
 std::vector<dino::Renderer*> dino::EngineContext::s_renderers {};
 std::vector<dino::AudioMixer*> dino::EngineContext::s_mixers  {};
+int dino::EngineContext::s_audioBufferFrames = DINO_AUDIO_DEFAULT_BUFFER_FRAMES;
 
-void dino::EngineContext::initialise() {
+void dino::EngineContext::initialise(int audio_buffer_frames) {
     if (isInitialised()) {
         return void();
     }
@@ -60,9 +62,22 @@ void dino::EngineContext::initialise() {
 
     dino::GraphicsDriver::initialise();
 
-    result = Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048);
+    s_audioBufferFrames = DINO_AUDIO_MIN_BUFFER_FRAMES;
+
+    while (s_audioBufferFrames < audio_buffer_frames && s_audioBufferFrames < DINO_AUDIO_MAX_BUFFER_FRAMES) {
+        s_audioBufferFrames = s_audioBufferFrames * 2;
+    }
+
+    /* The engine mixer works on signed 16 bit stereo only. */
+    result = Mix_OpenAudio(44100, AUDIO_S16SYS, 2, s_audioBufferFrames);
     DINO_ASSERT_SDL_RESULT(result)
 
+    dino::SampleKernels::initialise();
+
+#if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
+    dino::Logger::debug("Audio buffer:", s_audioBufferFrames, "frames, sample kernels:", dino::SampleKernels::getName());
+#endif
+
     s_isInitialised = true;
 }
 
@@ -100,23 +115,20 @@ dino::Renderer* dino::EngineContext::createRenderer(dino::TargetWindow* target)
     return renderer;
 }
 
-dino::AudioMixer* dino::EngineContext::createMixer() {
+dino::AudioMixer* dino::EngineContext::createMixer(int voice_count) {
     if (!s_isInitialised) {
         throw dino::EngineError("Engine context must be initialised first.", dino::EngineError::E_TYPE_GENERAL);
     }
 
-    auto mixer = new AudioMixer();
+    auto mixer = new AudioMixer(voice_count);
     s_mixers.push_back(mixer);
 
     return mixer;
 }
 
-dino::EngineContext::Event dino::EngineContext::pollEvent() {
-    SDL_Event sdl_event {};
+dino::EngineContext::Event dino::EngineContext::translateEvent_(const SDL_Event& sdl_event) {
     dino::EngineContext::Event dino_event {dino::EngineContext::Event::UNKNOWN};
 
-    SDL_PollEvent(&sdl_event);
-
     if (sdl_event.type == SDL_QUIT) {
         dino_event.kind = dino::EngineContext::Event::PROCESS_QUIT;
         return dino_event;
@@ -148,6 +160,29 @@ dino::EngineContext::Event dino::EngineContext::pollEvent() {
     return dino_event;
 }
 
+dino::EngineContext::Event dino::EngineContext::pollEvent() {
+    SDL_Event sdl_event {};
+    SDL_PollEvent(&sdl_event);
+
+    return translateEvent_(sdl_event);
+}
+
+void dino::EngineContext::pollEvents(std::pmr::vector<dino::EngineContext::Event>* batch) {
+    SDL_Event sdl_event {};
+
+    while (SDL_PollEvent(&sdl_event) == 1) {
+        auto dino_event = translateEvent_(sdl_event);
+
+        if (dino_event.kind != dino::EngineContext::Event::UNKNOWN) {
+            batch->push_back(dino_event);
+        }
+    }
+}
+
 bool dino::EngineContext::isInitialised() {
     return s_isInitialised;
 }
+
+int dino::EngineContext::getAudioBufferFrames() {
+    return s_audioBufferFrames;
+}
@@ -30,9 +30,13 @@
 #pragma once
 
 #include <vector>
+#include <memory_resource>
 #include "renderer.hpp"
 #include "audio_mixer.hpp"
 
+#define DINO_AUDIO_DEFAULT_BUFFER_FRAMES 512
+#define DINO_AUDIO_MIN_BUFFER_FRAMES 256
+
 namespace dino {
 
 /**
@@ -74,14 +78,31 @@ private: /* ===-=== Private Members ===-=== */
      */
     static std::vector<AudioMixer*> s_mixers;
 
+    /**
+     * @brief Size of the audio device buffer in frames.
+     */
+    static int s_audioBufferFrames;
+
+    /**
+     * @brief Translates an SDL event to a context event.
+     * @param sdl_event The SDL event.
+     * @return The context event.
+     */
+    static struct context_event translateEvent_(const SDL_Event&);
+
 public: /* ===-=== Public Members ===-=== */
     typedef struct context_event Event;
 
     /**
      * @brief Initialises the engine context.
+     * @param audio_buffer_frames Audio device buffer size in frames.
      * @throw dino::EngineError Thrown if the engine fails to initialise.
+     *
+     * The buffer size is rounded up to a power of two between 256 and
+     * DINO_AUDIO_MAX_BUFFER_FRAMES. Smaller buffers lower the latency
+     * of sound effects at the cost of more frequent mixer callbacks.
      */
-    static void initialise();
+    static void initialise(int audio_buffer_frames = DINO_AUDIO_DEFAULT_BUFFER_FRAMES);
 
     /**
      * @brief Destroys and cleans up the engine context.
@@ -101,10 +122,11 @@ public: /* ===-=== Public Members ===-=== */
 
     /**
      * @brief Creates an audio mixer.
+     * @param voice_count Number of voices available to sound effects.
      * @return New audio mixer.
      * @throw dino::EngineError Thrown if mixer can not be created.
      */
-    static AudioMixer* createMixer();
+    static AudioMixer* createMixer(int voice_count = DINO_AUDIO_DEFAULT_VOICES);
 
     /**
      * @brief Polls events from the global context.
@@ -112,11 +134,26 @@ public: /* ===-=== Public Members ===-=== */
      */
     static EngineContext::Event pollEvent();
 
+    /**
+     * @brief Drains all pending events from the global context.
+     * @param batch Receives the known events in the order they occurred.
+     *
+     * Unknown events are dropped. The batch is typically backed by
+     * a frame arena so that polling does not allocate.
+     */
+    static void pollEvents(std::pmr::vector<EngineContext::Event>*);
+
     /**
      * @brief Checks if the context is already initialised or not.
      * @return True if initialised, false otherwise.
      */
     static bool isInitialised();
+
+    /**
+     * @brief Returns the audio device buffer size.
+     * @return Buffer size in frames.
+     */
+    static int getAudioBufferFrames();
 };
 
 } // namespace dino
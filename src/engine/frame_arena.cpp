@@ -0,0 +1,153 @@
+/**
+ * frame_arena.cpp - Linear allocator for per-frame transient data
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <cstdint>
+#include <new>
+#include "frame_arena.hpp"
+
+dino::FrameArenaResource::FrameArenaResource(dino::FrameArena* arena) : m_arena(arena) {}
+
+void* dino::FrameArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return m_arena->allocate(bytes, alignment);
+}
+
+void dino::FrameArenaResource::do_deallocate(void* /* ignored */, std::size_t /* ignored */, std::size_t /* ignored */) {
+    /* Memory is reclaimed when the arena buffer is reset. */
+}
+
+bool dino::FrameArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+dino::FrameArena::FrameArena(std::size_t capacity) :
+        m_capacity(capacity),
+        m_resource(this) {
+
+    for (auto& buffer : m_buffers) {
+        buffer.data = static_cast<std::byte*>(::operator new(m_capacity, std::align_val_t(alignof(std::max_align_t))));
+    }
+}
+
+dino::FrameArena::~FrameArena() {
+    for (auto& buffer : m_buffers) {
+        resetBuffer_(buffer);
+        ::operator delete(buffer.data, std::align_val_t(alignof(std::max_align_t)));
+    }
+}
+
+void dino::FrameArena::resetBuffer_(arena_buffer& buffer) {
+    while (buffer.overflow != nullptr) {
+        auto block = buffer.overflow;
+        buffer.overflow = block->next;
+
+        ::operator delete(block, std::align_val_t(block->alignment));
+    }
+
+    buffer.offset = 0;
+    buffer.stats  = FrameArenaStats {};
+}
+
+void dino::FrameArena::beginFrame() {
+    auto& finished = m_buffers[m_current];
+
+    if (finished.stats.bytesUsed > m_peakBytes) {
+        m_peakBytes = finished.stats.bytesUsed;
+    }
+
+    if (finished.stats.overflowAllocations > 0) {
+        m_overflowFrames++;
+    }
+
+    m_current = m_current ^ 1;
+    resetBuffer_(m_buffers[m_current]);
+}
+
+void* dino::FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    auto& buffer = m_buffers[m_current];
+
+    /* The buffer itself is only aligned to max_align_t, so the address is rounded, not the offset. */
+    auto address = reinterpret_cast<std::uintptr_t>(buffer.data) + buffer.offset;
+    std::size_t offset = ((address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1)) - reinterpret_cast<std::uintptr_t>(buffer.data);
+
+    if (offset + bytes > m_capacity) {
+        return allocateOverflow_(bytes, alignment);
+    }
+
+    buffer.offset = offset + bytes;
+    buffer.stats.allocations++;
+    buffer.stats.bytesUsed = buffer.offset;
+
+    return buffer.data + offset;
+}
+
+void* dino::FrameArena::allocateOverflow_(std::size_t bytes, std::size_t alignment) {
+    auto& buffer = m_buffers[m_current];
+
+    if (alignment < alignof(overflow_block)) {
+        alignment = alignof(overflow_block);
+    }
+
+    /* The header is padded so that the payload keeps its alignment. */
+    std::size_t header = (sizeof(overflow_block) + alignment - 1) & ~(alignment - 1);
+
+    auto block = static_cast<overflow_block*>(::operator new(header + bytes, std::align_val_t(alignment)));
+    block->next      = buffer.overflow;
+    block->size      = header + bytes;
+    block->alignment = alignment;
+
+    buffer.overflow = block;
+    buffer.stats.allocations++;
+    buffer.stats.overflowAllocations++;
+
+    return reinterpret_cast<std::byte*>(block) + header;
+}
+
+std::pmr::memory_resource* dino::FrameArena::getResource() {
+    return &m_resource;
+}
+
+const dino::FrameArenaStats* dino::FrameArena::getStats() const {
+    return &(m_buffers[m_current].stats);
+}
+
+const dino::FrameArenaStats* dino::FrameArena::getLastStats() const {
+    return &(m_buffers[m_current ^ 1].stats);
+}
+
+std::size_t dino::FrameArena::getPeakBytes() const {
+    return m_peakBytes;
+}
+
+uint64_t dino::FrameArena::getOverflowFrames() const {
+    return m_overflowFrames;
+}
+
+std::size_t dino::FrameArena::getCapacity() const {
+    return m_capacity;
+}
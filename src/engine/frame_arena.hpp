@@ -0,0 +1,225 @@
+/**
+ * frame_arena.hpp - Linear allocator for per-frame transient data
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace dino {
+
+class FrameArena;
+
+/**
+ * @brief Allocation counters of a frame arena.
+ */
+struct frame_arena_stats {
+    /**
+     * @brief Number of allocations served in the frame.
+     */
+    std::size_t allocations = 0;
+
+    /**
+     * @brief Bytes of the arena buffer used in the frame.
+     */
+    std::size_t bytesUsed = 0;
+
+    /**
+     * @brief Allocations that did not fit and went to the heap.
+     *
+     * A frame with zero overflow allocations did not touch the heap.
+     */
+    std::size_t overflowAllocations = 0;
+};
+
+typedef struct frame_arena_stats FrameArenaStats;
+
+/**
+ * @brief Exposes a frame arena as a polymorphic memory resource.
+ *
+ * Deallocation is a no-op, the memory is reclaimed when the
+ * arena buffer is reset.
+ */
+class FrameArenaResource : public std::pmr::memory_resource {
+
+private:
+    FrameArena* m_arena;
+
+protected:
+    void* do_allocate(std::size_t, std::size_t) override;
+
+    void do_deallocate(void*, std::size_t, std::size_t) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+
+public:
+    /**
+     * @brief Wraps a frame arena.
+     * @param arena The frame arena.
+     */
+    explicit FrameArenaResource(FrameArena*);
+};
+
+/**
+ * @brief Double-buffered linear allocator for per-frame data.
+ *
+ * Every frame allocates by bumping an offset into one of two fixed
+ * buffers. Calling beginFrame() flips to the other buffer and resets
+ * it, so memory handed out in a frame stays valid until the end of
+ * the following frame. Requests that do not fit in the buffer fall
+ * back to the heap and are counted as overflow allocations.
+ */
+class FrameArena {
+
+private: /* ===-=== Private Members ===-=== */
+
+    /**
+     * @brief Header of a heap block allocated on overflow.
+     */
+    struct overflow_block {
+        overflow_block* next;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    /**
+     * @brief One of the two arena buffers.
+     */
+    struct arena_buffer {
+        std::byte* data = nullptr;
+        std::size_t offset = 0;
+        overflow_block* overflow = nullptr;
+        FrameArenaStats stats {};
+    };
+
+    std::size_t m_capacity;
+
+    arena_buffer m_buffers[2];
+
+    /**
+     * @brief Index of the buffer used by the current frame.
+     */
+    int m_current = 0;
+
+    /**
+     * @brief Highest number of bytes used in a single frame.
+     */
+    std::size_t m_peakBytes = 0;
+
+    /**
+     * @brief Number of frames that had to allocate from the heap.
+     */
+    uint64_t m_overflowFrames = 0;
+
+    FrameArenaResource m_resource;
+
+    /**
+     * @brief Frees the overflow blocks and rewinds a buffer.
+     * @param buffer The buffer to be reset.
+     */
+    static void resetBuffer_(arena_buffer&);
+
+    /**
+     * @brief Allocates a block from the heap and links it to the current buffer.
+     * @param bytes Number of bytes.
+     * @param alignment Alignment in bytes.
+     * @return The allocated memory.
+     */
+    void* allocateOverflow_(std::size_t, std::size_t);
+
+public: /* ===-=== Public Members ===-=== */
+    /**
+     * @brief Allocates both arena buffers.
+     * @param capacity Size of each buffer in bytes.
+     */
+    explicit FrameArena(std::size_t);
+
+    /**
+     * @brief Releases both arena buffers.
+     */
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Starts a new frame.
+     *
+     * Everything allocated two frames ago is released.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Allocates memory for the current frame.
+     * @param bytes Number of bytes.
+     * @param alignment Alignment in bytes, must be a power of two.
+     * @return The allocated memory.
+     */
+    void* allocate(std::size_t, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Returns the arena as a polymorphic memory resource.
+     * @return The memory resource.
+     */
+    std::pmr::memory_resource* getResource();
+
+    /**
+     * @brief Returns the counters of the current frame.
+     * @return The frame counters.
+     */
+    [[nodiscard]] const FrameArenaStats* getStats() const;
+
+    /**
+     * @brief Returns the counters of the previous frame.
+     * @return The frame counters.
+     */
+    [[nodiscard]] const FrameArenaStats* getLastStats() const;
+
+    /**
+     * @brief Returns the highest number of bytes used in a frame.
+     * @return Peak usage in bytes.
+     */
+    [[nodiscard]] std::size_t getPeakBytes() const;
+
+    /**
+     * @brief Returns the number of frames that allocated from the heap.
+     * @return Number of frames.
+     */
+    [[nodiscard]] uint64_t getOverflowFrames() const;
+
+    /**
+     * @brief Returns the size of each arena buffer.
+     * @return Capacity in bytes.
+     */
+    [[nodiscard]] std::size_t getCapacity() const;
+};
+
+} // namespace dino
@@ -0,0 +1,128 @@
+/**
+ * geometry.hpp - Constexpr vector and rectangle math
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+namespace dino {
+
+/**
+ * @brief A point or displacement in pixels.
+ */
+struct vector2 {
+    int x = 0;
+    int y = 0;
+
+    constexpr vector2 operator+(const vector2& other) const {
+        return vector2 {x + other.x, y + other.y};
+    }
+
+    constexpr vector2 operator-(const vector2& other) const {
+        return vector2 {x - other.x, y - other.y};
+    }
+
+    constexpr bool operator==(const vector2& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+typedef struct vector2 Vector2;
+
+/**
+ * @brief An axis aligned rectangle in pixels.
+ *
+ * The layout matches SDL_Rect so a rectangle can be passed to SDL
+ * without conversion. Edges are half open: a rectangle covers
+ * [x, x + w) horizontally and [y, y + h) vertically.
+ */
+struct rect2 {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+
+    [[nodiscard]] constexpr int right() const {
+        return x + w;
+    }
+
+    [[nodiscard]] constexpr int bottom() const {
+        return y + h;
+    }
+
+    [[nodiscard]] constexpr Vector2 position() const {
+        return Vector2 {x, y};
+    }
+
+    /**
+     * @brief Returns the rectangle moved by a displacement.
+     * @param offset The displacement.
+     * @return The moved rectangle.
+     */
+    [[nodiscard]] constexpr rect2 translate(const Vector2& offset) const {
+        return rect2 {x + offset.x, y + offset.y, w, h};
+    }
+
+    /**
+     * @brief Checks if two rectangles overlap.
+     * @param other The other rectangle.
+     * @return True if they share at least one pixel.
+     */
+    [[nodiscard]] constexpr bool intersects(const rect2& other) const {
+        return x < other.right() && other.x < right() && y < other.bottom() && other.y < bottom();
+    }
+
+    /**
+     * @brief Checks if a point lies inside the rectangle.
+     * @param point The point.
+     * @return True if inside.
+     */
+    [[nodiscard]] constexpr bool contains(const Vector2& point) const {
+        return point.x >= x && point.x < right() && point.y >= y && point.y < bottom();
+    }
+
+    /**
+     * @brief Restarts a rectangle that scrolled past a left edge.
+     * @param edge_x The left edge.
+     * @param restart_x X coordinate to restart from.
+     * @return The rectangle at restart_x if it is fully left of edge_x, unchanged otherwise.
+     *
+     * The test compiles to a select rather than a branch, so loops over
+     * tiles can be vectorised.
+     */
+    [[nodiscard]] constexpr rect2 wrapLeft(int edge_x, int restart_x) const {
+        return rect2 {right() <= edge_x ? restart_x : x, y, w, h};
+    }
+};
+
+typedef struct rect2 Rect2;
+
+static_assert(Rect2 {0, 0, 10, 10}.intersects(Rect2 {9, 9, 4, 4}));
+static_assert(!Rect2 {0, 0, 10, 10}.intersects(Rect2 {10, 0, 4, 4}));
+static_assert(Rect2 {-10, 5, 10, 10}.wrapLeft(0, 90).x == 90);
+
+} // namespace dino
@@ -37,16 +37,20 @@
 
 #include "platform/logger.hpp"
 #include "assert.hpp"
+#include "except.hpp"
 #include "graphics_driver.hpp"
 
-// IMPLEMENTATION IS INCOMPLETE
+std::vector<dino::DisplayCaps> dino::GraphicsDriver::s_displays {};
 
-dino::DisplayCaps dino::GraphicsDriver::s_displayCaps {};
+std::size_t dino::GraphicsDriver::s_selected = 0;
 
 void dino::GraphicsDriver::initDisplay_() {
     int display_len = SDL_GetNumVideoDisplays();
     DINO_ASSERT_SDL_RESULT(display_len);
 
+    s_displays.clear();
+    s_selected = 0;
+
     for (int index = 0; index < display_len; index++) {
         SDL_DisplayMode display_mode;
         SDL_Rect display_bounds {};
@@ -57,14 +61,45 @@ void dino::GraphicsDriver::initDisplay_() {
         result = SDL_GetDisplayBounds(index, &display_bounds);
         DINO_ASSERT_SDL_RESULT(result);
 
-        if (display_bounds.x == 0 && display_bounds.y == 0) {
-            s_displayCaps.displayIndex = index;
-            s_displayCaps.screenWidth  = display_bounds.w;
-            s_displayCaps.screenHeight = display_bounds.h;
-            s_displayCaps.displayName  = std::string(SDL_GetDisplayName(index));
+        DisplayCaps caps {};
+
+        caps.displayIndex = index;
+        caps.screenWidth  = display_bounds.w;
+        caps.screenHeight = display_bounds.h;
+        caps.boundsX      = display_bounds.x;
+        caps.boundsY      = display_bounds.y;
+        caps.refreshRate  = display_mode.refresh_rate;
+
+        const char* display_name = SDL_GetDisplayName(index);
+        caps.displayName = display_name != nullptr ? std::string(display_name) : std::string();
+
+        /* Not every driver reports DPI, the fields stay 0 then. */
+        if (SDL_GetDisplayDPI(index, &caps.diagonalDpi, &caps.horizontalDpi, &caps.verticalDpi) < 0) {
+            caps.diagonalDpi   = 0.0f;
+            caps.horizontalDpi = 0.0f;
+            caps.verticalDpi   = 0.0f;
+        }
+
+        /* SDL lists the modes largest first. */
+        int mode_len = SDL_GetNumDisplayModes(index);
+
+        for (int mode_index = 0; mode_index < mode_len; mode_index++) {
+            SDL_DisplayMode mode;
 
-            break;
+            if (SDL_GetDisplayMode(index, mode_index, &mode) == 0) {
+                caps.modes.push_back(DisplayMode {mode.w, mode.h, mode.refresh_rate, mode.format});
+            }
         }
+
+        if (caps.isPrimary() && !s_displays.empty() && !s_displays[s_selected].isPrimary()) {
+            s_selected = s_displays.size();
+        }
+
+        s_displays.push_back(caps);
+    }
+
+    if (s_displays.empty()) {
+        throw dino::EngineError("No display is connected!", dino::EngineError::E_TYPE_SDL_RESULT);
     }
 }
 
@@ -77,19 +112,51 @@ void dino::GraphicsDriver::initialise() {
 }
 
 void dino::GraphicsDriver::quit() {
+    s_displays.clear();
+    s_selected = 0;
+
     SDL_VideoQuit();
     SDL_Quit();
 }
 
+int dino::GraphicsDriver::getDisplayCount() {
+    return static_cast<int>(s_displays.size());
+}
+
 void dino::GraphicsDriver::printInfo() {
     dino::Logger::print("Display Information");
     dino::Logger::print("*******************");
-    dino::Logger::print("Index: ", s_displayCaps.displayIndex);
-    dino::Logger::print("Name: ", s_displayCaps.displayName);
-    dino::Logger::print("Resolution: ", s_displayCaps.screenWidth, "x", s_displayCaps.screenHeight);
-    dino::Logger::print("\n");
+
+    for (std::size_t index = 0; index < s_displays.size(); index++) {
+        const DisplayCaps& caps = s_displays[index];
+
+        dino::Logger::print("Index: ", caps.displayIndex, index == s_selected ? " (selected)" : "");
+        dino::Logger::print("Name: ", caps.displayName);
+        dino::Logger::print("Resolution: ", caps.screenWidth, "x", caps.screenHeight, " @ ", caps.refreshRate, " Hz");
+        dino::Logger::print("Position: ", caps.boundsX, ",", caps.boundsY);
+        dino::Logger::print("DPI: ", caps.diagonalDpi, " (", caps.horizontalDpi, "x", caps.verticalDpi, ")");
+        dino::Logger::print("Modes: ", caps.modes.size());
+        dino::Logger::print("\n");
+    }
 }
 
 const dino::DisplayCaps *dino::GraphicsDriver::getDisplayCaps() {
-    return &s_displayCaps;
+    static const DisplayCaps no_display {};
+    return s_displays.empty() ? &no_display : &s_displays[s_selected];
+}
+
+const dino::DisplayCaps *dino::GraphicsDriver::getDisplayCaps(int display_index) {
+    if (display_index < 0 || display_index >= getDisplayCount()) {
+        throw dino::EngineError("Display index is out of range!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    return &s_displays[display_index];
+}
+
+void dino::GraphicsDriver::selectDisplay(int display_index) {
+    if (display_index < 0 || display_index >= getDisplayCount()) {
+        throw dino::EngineError("Display index is out of range!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    s_selected = static_cast<std::size_t>(display_index);
 }
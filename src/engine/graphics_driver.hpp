@@ -29,36 +29,130 @@
 
 #pragma once
 
-// IMPLEMENTATION IS INCOMPLETE
-
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace dino {
 
+/**
+ * @brief A mode the display can be switched to.
+ */
+struct display_mode {
+    int width = 0;
+    int height = 0;
+
+    /**
+     * @brief Refresh rate in Hz, 0 if unknown.
+     */
+    int refreshRate = 0;
+
+    uint32_t pixelFormat = 0;
+};
+
+typedef struct display_mode DisplayMode;
+
+/**
+ * @brief Capabilities of a connected display.
+ */
 struct display_caps {
     int displayIndex = -1;
     std::string displayName;
 
+    /**
+     * @brief Desktop resolution of the display.
+     */
     int screenWidth = 0;
     int screenHeight = 0;
+
+    /**
+     * @brief Position of the display on the virtual desktop.
+     */
+    int boundsX = 0;
+    int boundsY = 0;
+
+    /**
+     * @brief Desktop refresh rate in Hz, 0 if unknown.
+     */
+    int refreshRate = 0;
+
+    /**
+     * @brief Dots per inch, 0 if the driver cannot tell.
+     */
+    float diagonalDpi = 0.0f;
+    float horizontalDpi = 0.0f;
+    float verticalDpi = 0.0f;
+
+    /**
+     * @brief Modes supported in fullscreen, largest first.
+     */
+    std::vector<DisplayMode> modes;
+
+    /**
+     * @brief Checks if this is the primary display.
+     * @return True if the display sits at the origin of the virtual desktop.
+     */
+    [[nodiscard]] bool isPrimary() const {
+        return boundsX == 0 && boundsY == 0;
+    }
 };
 
 typedef struct display_caps DisplayCaps;
 
+/**
+ * @brief Enumerates the displays and tracks the one the game runs on.
+ */
 class GraphicsDriver {
 
 private:
-    static DisplayCaps s_displayCaps;
+    static std::vector<DisplayCaps> s_displays;
+
+    /**
+     * @brief Index into s_displays of the selected display.
+     */
+    static std::size_t s_selected;
 
     static void initDisplay_();
 
 public:
+    /**
+     * @brief Initialises the video subsystem and enumerates the displays.
+     * @throw EngineError Thrown if no display can be queried.
+     *
+     * The primary display is selected until selectDisplay() is called.
+     */
     static void initialise();
 
     static void quit();
 
+    /**
+     * @brief Returns the number of connected displays.
+     * @return Number of displays found by initialise().
+     */
+    static int getDisplayCount();
+
+    /**
+     * @brief Returns the capabilities of the selected display.
+     * @return The display capabilities.
+     */
     static const DisplayCaps* getDisplayCaps();
 
+    /**
+     * @brief Returns the capabilities of a display.
+     * @param display_index Index of the display.
+     * @return The display capabilities.
+     * @throw EngineError Thrown if there is no such display.
+     */
+    static const DisplayCaps* getDisplayCaps(int);
+
+    /**
+     * @brief Selects the display windows are created on.
+     * @param display_index Index of the display.
+     * @throw EngineError Thrown if there is no such display.
+     */
+    static void selectDisplay(int);
+
     static void printInfo();
 };
 
@@ -0,0 +1,238 @@
+/**
+ * object_pool.hpp - Fixed capacity object pool
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace dino {
+
+/**
+ * @brief Refers to an object acquired from an object pool.
+ *
+ * A handle becomes stale as soon as the object is released or
+ * the pool is reset, even if the slot is acquired again later.
+ */
+struct pool_handle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+};
+
+typedef struct pool_handle PoolHandle;
+
+/**
+ * @brief Pool of reusable objects stored in a contiguous array.
+ *
+ * Objects are never constructed or destroyed by acquire() and
+ * release(); the pool only tracks which slots are in use. Free
+ * slots are chained through the slots themselves, so recycling
+ * never allocates.
+ *
+ * @tparam T Object type.
+ * @tparam Capacity Maximum number of objects.
+ */
+template<typename T, std::size_t Capacity>
+class ObjectPool {
+
+private: /* ===-=== Private Members ===-=== */
+    static constexpr uint32_t NIL_INDEX = UINT32_MAX;
+
+    struct pool_slot {
+        T value {};
+
+        /**
+         * @brief Bumped every time the slot is acquired or released.
+         */
+        uint32_t generation = 0;
+
+        /**
+         * @brief Pool epoch in which the slot was last acquired.
+         */
+        uint32_t epoch = 0;
+
+        /**
+         * @brief Next slot in the free list.
+         */
+        uint32_t next = NIL_INDEX;
+
+        bool isActive = false;
+    };
+
+    std::array<pool_slot, Capacity> m_slots {};
+
+    /**
+     * @brief Head of the free list of released slots.
+     */
+    uint32_t m_freeHead = NIL_INDEX;
+
+    /**
+     * @brief Number of slots handed out at least once since the last reset.
+     *
+     * Slots at or above this index are free without being in the free list.
+     */
+    uint32_t m_highWater = 0;
+
+    /**
+     * @brief Incremented on every reset to invalidate all slots at once.
+     */
+    uint32_t m_epoch = 1;
+
+    std::size_t m_activeCount = 0;
+
+    [[nodiscard]] bool isLive_(const pool_slot& slot) const {
+        return slot.isActive && slot.epoch == m_epoch;
+    }
+
+public: /* ===-=== Public Members ===-=== */
+    /**
+     * @brief Acquires a free object from the pool.
+     * @param handle Receives the handle to the acquired object.
+     * @return Pointer to the object, or nullptr if the pool is exhausted.
+     */
+    T* acquire(PoolHandle& handle) {
+        uint32_t index;
+
+        if (m_freeHead != NIL_INDEX) {
+            index = m_freeHead;
+            m_freeHead = m_slots[index].next;
+
+        } else if (m_highWater < Capacity) {
+            index = m_highWater;
+            m_highWater++;
+
+        } else {
+            return nullptr;
+        }
+
+        auto& slot = m_slots[index];
+
+        slot.generation = slot.generation + 1;
+        slot.epoch      = m_epoch;
+        slot.next       = NIL_INDEX;
+        slot.isActive   = true;
+
+        m_activeCount++;
+
+        handle.index      = index;
+        handle.generation = slot.generation;
+
+        return &(slot.value);
+    }
+
+    /**
+     * @brief Returns an object to the pool.
+     * @param handle Handle to the object.
+     * @return True if released, false if the handle is stale.
+     */
+    bool release(const PoolHandle& handle) {
+        if (get(handle) == nullptr) {
+            return false;
+        }
+
+        auto& slot = m_slots[handle.index];
+
+        slot.generation = slot.generation + 1;
+        slot.isActive   = false;
+        slot.next       = m_freeHead;
+
+        m_freeHead = handle.index;
+        m_activeCount--;
+
+        return true;
+    }
+
+    /**
+     * @brief Resolves a handle to the object.
+     * @param handle Handle to the object.
+     * @return Pointer to the object, or nullptr if the handle is stale.
+     */
+    T* get(const PoolHandle& handle) {
+        if (handle.index >= m_highWater) {
+            return nullptr;
+        }
+
+        auto& slot = m_slots[handle.index];
+
+        if (!isLive_(slot) || slot.generation != handle.generation) {
+            return nullptr;
+        }
+
+        return &(slot.value);
+    }
+
+    /**
+     * @brief Releases every object in the pool at once.
+     *
+     * The object values are left untouched and all handles
+     * handed out before the reset become stale.
+     */
+    void reset() {
+        m_epoch       = m_epoch + 1;
+        m_freeHead    = NIL_INDEX;
+        m_highWater   = 0;
+        m_activeCount = 0;
+    }
+
+    /**
+     * @brief Calls a function for every acquired object.
+     * @param callback Invoked as callback(handle, object).
+     *
+     * The callback may release the object it is given.
+     */
+    template<typename F>
+    void forEach(F&& callback) {
+        for (uint32_t index = 0; index < m_highWater; index++) {
+            auto& slot = m_slots[index];
+
+            if (isLive_(slot)) {
+                callback(PoolHandle {index, slot.generation}, slot.value);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of acquired objects.
+     * @return Number of acquired objects.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return m_activeCount;
+    }
+
+    /**
+     * @brief Returns the maximum number of objects.
+     * @return Pool capacity.
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() {
+        return Capacity;
+    }
+};
+
+} // namespace dino
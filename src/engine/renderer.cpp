@@ -27,7 +27,10 @@
  * ========================================================================
  */
 
+#include <algorithm>
 #include <cmath>
+
+#include "platform/memory_tracker.hpp"
 #include "renderer.hpp"
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
@@ -35,11 +38,22 @@
 #endif
 
 dino::Renderer::Renderer(dino::TargetWindow* target) {
-    m_renderer = SDL_CreateRenderer(target->window, -1, SDL_RENDERER_ACCELERATED);
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    m_renderer = SDL_CreateRenderer(target->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+    DINO_ASSERT_SDL_HANDLE(m_renderer, dino::EngineError::E_TYPE_SDL_RESULT)
+}
+
+dino::Renderer::Renderer(SDL_Surface* surface) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    m_renderer = SDL_CreateSoftwareRenderer(surface);
     DINO_ASSERT_SDL_HANDLE(m_renderer, dino::EngineError::E_TYPE_SDL_RESULT)
 }
 
 dino::Renderer::~Renderer() {
+    delete m_frameTarget;
+    delete m_resolution;
     SDL_DestroyRenderer(m_renderer);
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
@@ -47,10 +61,134 @@ dino::Renderer::~Renderer() {
 #endif
 }
 
+void dino::Renderer::fitViewport_(int output_width, int output_height) {
+    m_outputWidth  = output_width;
+    m_outputHeight = output_height;
+
+    double scale = std::min(static_cast<double>(output_width) / m_logicalWidth,
+                            static_cast<double>(output_height) / m_logicalHeight);
+
+    bool is_integer = m_scaleMode == SCALE_INTEGER && scale >= 1.0;
+    m_fittedScale   = m_renderScale;
+
+    if (is_integer) {
+        scale = std::floor(scale);
+    }
+
+    m_viewport.w = static_cast<int>(m_logicalWidth * scale);
+    m_viewport.h = static_cast<int>(m_logicalHeight * scale);
+    m_viewport.x = (output_width - m_viewport.w) / 2;
+    m_viewport.y = (output_height - m_viewport.h) / 2;
+
+    /* A frame drawn below its logical size is never pixel exact, filter it either way. */
+    bool is_nearest = is_integer && m_renderScale == 1.0f;
+    SDL_SetTextureScaleMode(m_frameTarget->getTexture(), is_nearest ? SDL_ScaleModeNearest : SDL_ScaleModeLinear);
+
+#if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
+    dino::Logger::debug("Logical frame", m_logicalWidth, "x", m_logicalHeight, "at scale", m_renderScale, "shown at", m_viewport.w, "x", m_viewport.h);
+#endif
+}
+
+void dino::Renderer::createFrame_() {
+    SDL_SetRenderTarget(m_renderer, nullptr);
+    delete m_frameTarget;
+
+    /* Sized for the largest scale once, so scale changes never reallocate. */
+    float max_scale = m_resolution != nullptr ? m_resolution->getRules()->maxScale : 1.0f;
+
+    m_frameTarget = dino::SpriteMaterial::createTarget(m_renderer,
+            static_cast<int>(std::ceil(static_cast<float>(m_logicalWidth) * max_scale)),
+            static_cast<int>(std::ceil(static_cast<float>(m_logicalHeight) * max_scale)));
+
+    /* The frame covers its viewport completely, blending it would only cost fill rate. */
+    SDL_SetTextureBlendMode(m_frameTarget->getTexture(), SDL_BLENDMODE_NONE);
+
+    m_outputWidth  = 0;
+    m_outputHeight = 0;
+}
+
+void dino::Renderer::bindFrame_() {
+    SDL_SetRenderTarget(m_renderer, m_frameTarget->getTexture());
+
+    /* Binding a target resets the scale on older SDL versions, so it is set on every bind. */
+    SDL_RenderSetScale(m_renderer, m_renderScale, m_renderScale);
+}
+
+void dino::Renderer::setLogicalSize(int width, int height, dino::Renderer::ScaleMode scale_mode) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    if (width <= 0 || height <= 0) {
+        SDL_SetRenderTarget(m_renderer, nullptr);
+
+        delete m_frameTarget;
+        delete m_resolution;
+
+        m_frameTarget   = nullptr;
+        m_resolution    = nullptr;
+        m_renderScale   = 1.0f;
+        m_logicalWidth  = 0;
+        m_logicalHeight = 0;
+
+        return void();
+    }
+
+    m_logicalWidth  = width;
+    m_logicalHeight = height;
+    m_scaleMode     = scale_mode;
+
+    this->createFrame_();
+}
+
+void dino::Renderer::setDynamicResolution(const dino::ResolutionRules* rules) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    if (rules != nullptr && m_frameTarget == nullptr) {
+        throw dino::EngineError("Dynamic resolution needs a logical size!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    auto resolution = rules != nullptr ? new dino::ResolutionController(*rules) : nullptr;
+
+    delete m_resolution;
+    m_resolution  = resolution;
+    m_renderScale = m_resolution != nullptr ? m_resolution->getScale() : 1.0f;
+
+    if (m_frameTarget != nullptr) {
+        this->createFrame_();
+    }
+}
+
+int dino::Renderer::getWidth() const {
+    if (m_frameTarget != nullptr) {
+        return m_logicalWidth;
+    }
+
+    int output_width = 0;
+    SDL_GetRendererOutputSize(m_renderer, &output_width, nullptr);
+
+    return output_width;
+}
+
+int dino::Renderer::getHeight() const {
+    if (m_frameTarget != nullptr) {
+        return m_logicalHeight;
+    }
+
+    int output_height = 0;
+    SDL_GetRendererOutputSize(m_renderer, nullptr, &output_height);
+
+    return output_height;
+}
+
 dino::SpriteMaterial *dino::Renderer::loadSprite(const std::string& image_file) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
     return dino::SpriteMaterial::loadImage(m_renderer, image_file);
 }
 
+dino::SpriteMaterial *dino::Renderer::loadSprite(const dino::FileView& image_data) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::ASSETS);
+    return dino::SpriteMaterial::loadImage(m_renderer, image_data);
+}
+
 void dino::Renderer::clear() {
     SDL_SetRenderDrawColor(m_renderer, 0x5E, 0x82, 0xAC, 0xff);
     int result = SDL_RenderClear(m_renderer);
@@ -58,10 +196,18 @@ void dino::Renderer::clear() {
 }
 
 void dino::Renderer::begin() {
+    m_frameStart = SDL_GetPerformanceCounter();
+
+    if (m_frameTarget != nullptr) {
+        this->bindFrame_();
+    }
+
     this->clear();
 }
 
 void dino::Renderer::draw(std::vector<dino::SpriteMaterial*>* materials) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
     for (auto sprite : *materials) {
         auto const properties = sprite->getProperties();
         auto const attachment = sprite->getAttachment();
@@ -72,14 +218,63 @@ void dino::Renderer::draw(std::vector<dino::SpriteMaterial*>* materials) {
 }
 
 void dino::Renderer::draw(dino::SpriteMaterial* material) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
     auto const properties = material->getProperties();
     auto const attachment = material->getAttachment();
     SDL_RenderCopy(m_renderer, material->getTexture(), properties, attachment);
 }
 
+void dino::Renderer::draw(dino::SpriteBatch* batch) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    batch->prepare();
+
+    auto const vertices = batch->getVertices();
+
+    for (auto const& draw : *batch->getDraws()) {
+        int result = SDL_RenderGeometry(m_renderer, draw.texture, vertices->data() + draw.firstVertex,
+                static_cast<int>(draw.instances * 4), batch->getIndices(), static_cast<int>(draw.instances * 6));
+
+        DINO_ASSERT_SDL_RESULT(result)
+    }
+}
+
 void dino::Renderer::commit() {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+
+    if (m_frameTarget != nullptr) {
+        int output_width  = 0;
+        int output_height = 0;
+
+        SDL_SetRenderTarget(m_renderer, nullptr);
+        SDL_GetRendererOutputSize(m_renderer, &output_width, &output_height);
+
+        if (output_width != m_outputWidth || output_height != m_outputHeight || m_renderScale != m_fittedScale) {
+            this->fitViewport_(output_width, output_height);
+        }
+
+        SDL_Rect source {0, 0,
+                static_cast<int>(std::lround(static_cast<float>(m_logicalWidth) * m_renderScale)),
+                static_cast<int>(std::lround(static_cast<float>(m_logicalHeight) * m_renderScale))};
+
+        /* Clears the letterbox bars around the viewport. */
+        SDL_SetRenderDrawColor(m_renderer, 0x00, 0x00, 0x00, 0xff);
+        SDL_RenderClear(m_renderer);
+
+        int result = SDL_RenderCopy(m_renderer, m_frameTarget->getTexture(), &source, &m_viewport);
+        DINO_ASSERT_SDL_RESULT(result)
+    }
+
     SDL_RenderPresent(m_renderer);
 
+    /* Present waits for the GPU once it falls behind, so this covers both sides of the frame. */
+    m_frameMs = static_cast<float>(1000.0 * static_cast<double>(SDL_GetPerformanceCounter() - m_frameStart) / static_cast<double>(SDL_GetPerformanceFrequency()));
+
+    if (m_resolution != nullptr) {
+        m_renderScale = m_resolution->update(m_frameMs);
+    }
+
     uint32_t frames_sec = 240;
     uint32_t start_time = SDL_GetTicks();
 
@@ -90,25 +285,33 @@ void dino::Renderer::commit() {
     //SDL_Delay(4);
 }
 
-void dino::Renderer::blindScreen() {
-    unsigned int color_code;
-    double radians = 0.0f;
-
-#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
-    while (radians <= M_PI) {
+dino::SpriteMaterial* dino::Renderer::createTarget(int width, int height) {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::RENDERER);
+    return dino::SpriteMaterial::createTarget(m_renderer, width, height);
+}
 
-#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1 
-    while (radians <= M_PIf) {
-#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
-        int result = SDL_RenderClear(m_renderer);
-        DINO_ASSERT_SDL_RESULT(result)
+void dino::Renderer::setTarget(dino::SpriteMaterial* target) {
+    if (target == nullptr && m_frameTarget != nullptr) {
+        this->bindFrame_();
+        return void();
+    }
 
-        color_code = static_cast<unsigned int>(125.0 * std::sin(radians));
+    int result = SDL_SetRenderTarget(m_renderer, target != nullptr ? target->getTexture() : nullptr);
+    DINO_ASSERT_SDL_RESULT(result)
 
-        SDL_SetRenderDrawColor(m_renderer, color_code, 0x44, 0x44, 0xFF);
-        SDL_RenderPresent(m_renderer);
-        SDL_Delay(2);
+    SDL_RenderSetScale(m_renderer, 1.0f, 1.0f);
+}
 
-        radians = radians + 0.01f;
+void dino::Renderer::drawOverlay(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) {
+    if (alpha == 0) {
+        return void();
     }
+
+    SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(m_renderer, red, green, blue, alpha);
+
+    int result = SDL_RenderFillRect(m_renderer, nullptr);
+    DINO_ASSERT_SDL_RESULT(result)
+
+    SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
 }
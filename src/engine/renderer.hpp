@@ -41,6 +41,8 @@
 #endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
 
 #include "assert.hpp"
+#include "resolution_controller.hpp"
+#include "sprite_batch.hpp"
 #include "sprite_material.hpp"
 
 namespace dino {
@@ -54,17 +56,20 @@ struct target_window {
     SDL_Window* window = nullptr;
 
     /**
-     * @brief Creates a window of specified width and height.
+     * @brief Creates a fullscreen window on a display.
      *
-     * @param title     Window title.
-     * @param width     Window width.
-     * @param height    Window height.
+     * @param title         Window title.
+     * @param width         Window width.
+     * @param height        Window height.
+     * @param display_index Display to open the window on.
      */
-    target_window(const std::string& title, int width, int height) {
+    target_window(const std::string& title, int width, int height, int display_index = 0) {
         this->width = width;
         this->height = height;
 
-        this->window = SDL_CreateWindow(title.c_str(), 0, 0, this->width, this->height, SDL_WINDOW_FULLSCREEN | SDL_WINDOW_FULLSCREEN_DESKTOP);
+        int position = static_cast<int>(SDL_WINDOWPOS_CENTERED_DISPLAY(display_index));
+
+        this->window = SDL_CreateWindow(title.c_str(), position, position, this->width, this->height, SDL_WINDOW_FULLSCREEN | SDL_WINDOW_FULLSCREEN_DESKTOP);
         DINO_ASSERT_SDL_HANDLE(this->window, dino::EngineError::E_TYPE_SDL_RESULT)
     }
 };
@@ -82,7 +87,82 @@ private:
      */
     SDL_Renderer* m_renderer;
 
+    /**
+     * @brief Off-screen target of the logical resolution, nullptr draws to the output directly.
+     */
+    SpriteMaterial* m_frameTarget = nullptr;
+
+    int m_logicalWidth = 0;
+    int m_logicalHeight = 0;
+
+    int m_scaleMode = 0;
+
+    /**
+     * @brief Output size the viewport was last fitted to.
+     */
+    int m_outputWidth = 0;
+    int m_outputHeight = 0;
+
+    /**
+     * @brief Area of the output the frame target is scaled into.
+     */
+    SDL_Rect m_viewport {};
+
+    /**
+     * @brief Adjusts the render scale to the frame time, nullptr keeps it fixed.
+     */
+    ResolutionController* m_resolution = nullptr;
+
+    /**
+     * @brief Fraction of the logical resolution the frame is drawn at.
+     */
+    float m_renderScale = 1.0f;
+
+    /**
+     * @brief Render scale the viewport was last fitted for.
+     */
+    float m_fittedScale = 0.0f;
+
+    uint64_t m_frameStart = 0;
+
+    /**
+     * @brief Time from begin() until the last frame was presented.
+     */
+    float m_frameMs = 0.0f;
+
+    /**
+     * @brief Creates the frame target for the logical size and the largest render scale.
+     */
+    void createFrame_();
+
+    /**
+     * @brief Binds the frame target at the current render scale.
+     */
+    void bindFrame_();
+
+    /**
+     * @brief Fits the viewport to the output and picks the texture filter.
+     * @param output_width Output width in pixels.
+     * @param output_height Output height in pixels.
+     */
+    void fitViewport_(int, int);
+
 public:
+    /**
+     * @brief How the logical resolution is scaled to the output.
+     */
+    enum ScaleMode : int {
+        /**
+         * @brief Largest whole multiple that fits, nearest filtering. Pixels stay sharp.
+         */
+        SCALE_INTEGER = 0,
+
+        /**
+         * @brief Fills the output as far as the aspect ratio allows, linear filtering.
+         */
+        SCALE_LINEAR
+    };
+
     /**
      * @brief Initialises with a target window.
      * @param window The window handle.
@@ -90,6 +170,15 @@ public:
      */
     explicit Renderer(dino::TargetWindow*);
 
+    /**
+     * @brief Initialises with a software renderer drawing into a surface.
+     * @param surface The target surface, must outlive the renderer.
+     * @throw EngineError Thrown if the constructor fails.
+     *
+     * Used to render without a window, e.g. by benchmarks and tests.
+     */
+    explicit Renderer(SDL_Surface*);
+
     /**
      * @brief Cleans up when an instance is destroyed.
      *
@@ -97,6 +186,62 @@ public:
      */
     ~Renderer();
 
+    /**
+     * @brief Renders every frame at a fixed resolution.
+     * @param width Logical width, 0 renders at the output resolution again.
+     * @param height Logical height.
+     * @param scale_mode How the frame is scaled to the output.
+     * @throw EngineError Thrown if the off-screen target cannot be created.
+     *
+     * The frame is drawn into an off-screen target of the logical size
+     * and scaled to the output by commit(), letterboxed if the aspect
+     * ratios differ. Fill rate then depends on the logical size only,
+     * not on the resolution of the display. SCALE_INTEGER falls back to
+     * linear downscaling when the output is smaller than the frame.
+     */
+    void setLogicalSize(int, int, ScaleMode scale_mode = SCALE_LINEAR);
+
+    /**
+     * @brief Returns the width the game draws at.
+     * @return Logical width if set, output width otherwise.
+     */
+    [[nodiscard]] int getWidth() const;
+
+    /**
+     * @brief Scales the frame with its cost to hold a frame time budget.
+     * @param rules Budget and scale bounds, nullptr draws at the logical size again.
+     * @throw EngineError Thrown if no logical size is set or the rules are invalid.
+     *
+     * The time from begin() to the end of commit() is fed to a resolution
+     * controller, which picks the fraction of the logical size the next
+     * frame is drawn at. Coordinates stay logical, the renderer scales
+     * them. A maximum scale above 1 draws above the logical size when
+     * the budget allows it, e.g. at native resolution on a 4K display.
+     */
+    void setDynamicResolution(const ResolutionRules*);
+
+    /**
+     * @brief Returns the dynamic resolution controller.
+     * @return The controller, nullptr if the resolution is fixed.
+     */
+    [[nodiscard]] const ResolutionController* getResolution() const {
+        return m_resolution;
+    }
+
+    /**
+     * @brief Returns the time taken by the last frame.
+     * @return Milliseconds from begin() until the frame was presented.
+     */
+    [[nodiscard]] float getFrameMs() const {
+        return m_frameMs;
+    }
+
+    /**
+     * @brief Returns the height the game draws at.
+     * @return Logical height if set, output height otherwise.
+     */
+    [[nodiscard]] int getHeight() const;
+
     /**
      * @brief Loads a sprite material from an image.
      * @param image_file Absolute path to the image.
@@ -106,14 +251,22 @@ public:
     SpriteMaterial* loadSprite(const std::string&);
 
     /**
-     * @brief Clears the screen before rendering the next frame.
+     * @brief Loads a sprite material from an image in memory.
+     * @param image_data Bytes of the image file, e.g. from dino::VirtualFilesystem::read().
+     * @return The sprite material.
+     * @throw EngineError Thrown if sprite can not be loaded.
+     */
+    SpriteMaterial* loadSprite(const FileView&);
+
+    /**
+     * @brief Clears the bound target before rendering the next frame.
      */
     void clear();
 
     /**
      * @brief Begins rendering a frame.
      *
-     * The method is an alias for the Renderer::clear() method.
+     * Binds the frame target if a logical size is set, then clears it.
      */
     void begin();
 
@@ -131,14 +284,52 @@ public:
      */
     void draw(SpriteMaterial*);
 
+    /**
+     * @brief Draws a sprite batch in layer order.
+     * @param batch The batch, prepared first if it has changed.
+     * @throw EngineError Thrown if any draw fails.
+     *
+     * Issues one geometry draw per run of instances that share a texture.
+     */
+    void draw(SpriteBatch*);
+
     /**
      * @brief Draws the sprites on the screen.
      *
+     * With a logical size set, the frame target is scaled to the output first.
      */
     void commit();
 
-    // TODO Improve implementation
-    void blindScreen();
+    /**
+     * @brief Creates an off-screen target of the given size.
+     * @param width Target width in pixels.
+     * @param height Target height in pixels.
+     * @return A sprite material that can be bound with setTarget() and drawn like any other.
+     * @throw EngineError Thrown if the target cannot be created.
+     *
+     * The contents are lost if SDL reports SDL_RENDER_TARGETS_RESET,
+     * so targets should only cache what can be drawn again.
+     */
+    SpriteMaterial* createTarget(int, int);
+
+    /**
+     * @brief Redirects drawing into an off-screen target.
+     * @param target Target created by createTarget(), nullptr for the frame.
+     * @throw EngineError Thrown if the target cannot be bound.
+     */
+    void setTarget(SpriteMaterial*);
+
+    /**
+     * @brief Blends a colour over the whole target.
+     * @param red Red component.
+     * @param green Green component.
+     * @param blue Blue component.
+     * @param alpha Opacity, 0 draws nothing.
+     *
+     * Drawn once per frame with a changing alpha, this fades the
+     * frame in or out without holding up the main loop.
+     */
+    void drawOverlay(uint8_t, uint8_t, uint8_t, uint8_t);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * resolution_controller.cpp - Frame time driven render scale controller
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "except.hpp"
+#include "resolution_controller.hpp"
+
+namespace {
+
+/* Absorbs float error when a scale is divided back into steps. */
+constexpr float STEP_EPSILON = 0.001f;
+
+} // namespace
+
+dino::ResolutionController::ResolutionController(const dino::ResolutionRules& rules) {
+    if (rules.budgetMs <= 0.0f || rules.step <= 0.0f || rules.minScale <= 0.0f || rules.minScale > rules.maxScale) {
+        throw dino::EngineError("Invalid resolution controller bounds!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    if (rules.smoothing <= 0.0f || rules.smoothing > 1.0f || rules.cooldownFrames < 0) {
+        throw dino::EngineError("Invalid resolution controller tuning!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    m_rules = rules;
+    this->reset();
+}
+
+float dino::ResolutionController::snap_(float scale, bool is_rounding_up) const {
+    float steps = scale / m_rules.step;
+    steps = is_rounding_up ? std::ceil(steps - STEP_EPSILON) : std::floor(steps + STEP_EPSILON);
+
+    return std::clamp(steps * m_rules.step, m_rules.minScale, m_rules.maxScale);
+}
+
+void dino::ResolutionController::scaleDown_() {
+    if (m_scale > m_rules.minScale) {
+        /* The cost of a frame follows its area, so each side shrinks by the square root of the overrun. */
+        float wanted = m_scale * std::sqrt(m_rules.budgetMs / m_averageMs);
+
+        /* An upscale undone this soon overshot, wait twice as long before the next one. */
+        if (m_framesSinceUpscale <= m_upscaleCooldown * 2) {
+            m_upscaleCooldown = std::min(m_upscaleCooldown * 2, m_rules.maxCooldownFrames);
+        }
+
+        m_scale = std::min(snap_(wanted, false), snap_(m_scale - m_rules.step, false));
+
+    } else if (m_rules.reduceQuality && !m_isReduced) {
+        m_isReduced = true;
+
+    } else {
+        return void();
+    }
+
+    m_changes++;
+    m_cooldown = m_rules.cooldownFrames;
+}
+
+void dino::ResolutionController::scaleUp_() {
+    if (m_isReduced) {
+        m_isReduced = false;
+
+    } else if (m_scale < m_rules.maxScale) {
+        m_scale = snap_(m_scale + m_rules.step, false);
+        m_framesSinceUpscale = 0;
+
+    } else {
+        return void();
+    }
+
+    m_changes++;
+    m_cooldown = m_upscaleCooldown;
+}
+
+float dino::ResolutionController::update(float frame_ms) {
+    if (!m_hasSample) {
+        m_averageMs = frame_ms;
+        m_hasSample = true;
+
+    } else {
+        m_averageMs = m_averageMs + m_rules.smoothing * (frame_ms - m_averageMs);
+    }
+
+    if (m_framesSinceUpscale < INT_MAX) {
+        m_framesSinceUpscale++;
+    }
+
+    /* Held long enough, earlier overshoots no longer say anything about the load. */
+    if (m_framesSinceUpscale == m_rules.maxCooldownFrames * 2) {
+        m_upscaleCooldown = m_rules.cooldownFrames;
+    }
+
+    if (m_cooldown > 0) {
+        m_cooldown--;
+        return m_scale;
+    }
+
+    if (m_averageMs > m_rules.budgetMs) {
+        this->scaleDown_();
+
+    } else if (m_averageMs < m_rules.budgetMs * m_rules.upscaleRatio) {
+        this->scaleUp_();
+    }
+
+    return m_scale;
+}
+
+void dino::ResolutionController::reset() {
+    m_scale     = m_rules.maxScale;
+    m_averageMs = 0.0f;
+    m_hasSample = false;
+    m_isReduced = false;
+    m_cooldown  = 0;
+    m_changes   = 0;
+
+    m_upscaleCooldown    = m_rules.cooldownFrames;
+    m_framesSinceUpscale = INT_MAX;
+}
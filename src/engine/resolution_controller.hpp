@@ -0,0 +1,189 @@
+/**
+ * resolution_controller.hpp - Frame time driven render scale controller
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+namespace dino {
+
+/**
+ * @brief Bounds and tuning of a resolution controller.
+ */
+struct resolution_rules {
+    /**
+     * @brief Frame time to hold in milliseconds.
+     */
+    float budgetMs = 16.667f;
+
+    /**
+     * @brief Render scale bounds, relative to the logical resolution.
+     */
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+
+    /**
+     * @brief Scale increment, every scale is a multiple of it.
+     */
+    float step = 0.05f;
+
+    /**
+     * @brief Fraction of the budget the frame time must drop below before scaling up.
+     */
+    float upscaleRatio = 0.75f;
+
+    /**
+     * @brief Weight of the newest frame in the moving average.
+     */
+    float smoothing = 0.1f;
+
+    /**
+     * @brief Frames to wait after a change before judging again.
+     */
+    int cooldownFrames = 30;
+
+    /**
+     * @brief Longest wait before scaling up, after repeated overshoots.
+     */
+    int maxCooldownFrames = 960;
+
+    /**
+     * @brief Allows reduced quality once the minimum scale is still too slow.
+     */
+    bool reduceQuality = true;
+};
+
+typedef struct resolution_rules ResolutionRules;
+
+/**
+ * @brief Picks a render scale that keeps the frame time inside a budget.
+ *
+ * Frame times are smoothed with a moving average. Over budget, the scale
+ * drops in proportion to the overrun, since the cost of a frame grows with
+ * its area. The scale only goes up again one step at a time once the frame
+ * time is well under budget, so the band between the two thresholds holds
+ * it steady.
+ *
+ * Every change is followed by a cooldown that lets the average settle. An
+ * upscale that has to be undone soon after doubles the wait before the
+ * next one, which stops the scale from flipping between two neighbours.
+ */
+class ResolutionController {
+
+private:
+    ResolutionRules m_rules;
+
+    float m_scale;
+    float m_averageMs = 0.0f;
+
+    bool m_hasSample = false;
+    bool m_isReduced = false;
+
+    int m_cooldown = 0;
+
+    /**
+     * @brief Current wait after an upscale, grows with every overshoot.
+     */
+    int m_upscaleCooldown;
+
+    /**
+     * @brief Frames since the scale last went up.
+     */
+    int m_framesSinceUpscale;
+
+    unsigned long m_changes = 0;
+
+    /**
+     * @brief Snaps a scale to a multiple of the step inside the bounds.
+     * @param scale The scale.
+     * @param is_rounding_up Rounds up if true, down otherwise.
+     * @return The snapped scale.
+     */
+    [[nodiscard]] float snap_(float, bool) const;
+
+    void scaleDown_();
+
+    void scaleUp_();
+
+public:
+    /**
+     * @brief Starts at the maximum scale.
+     * @param rules Bounds and tuning.
+     * @throw EngineError Thrown if the bounds or the budget are invalid.
+     */
+    explicit ResolutionController(const ResolutionRules&);
+
+    /**
+     * @brief Feeds the time taken by a frame.
+     * @param frame_ms Frame time in milliseconds.
+     * @return Scale to render the next frame at.
+     */
+    float update(float);
+
+    /**
+     * @brief Returns to the maximum scale and forgets the history.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the scale to render at.
+     * @return Scale between the minimum and maximum.
+     */
+    [[nodiscard]] float getScale() const {
+        return m_scale;
+    }
+
+    /**
+     * @brief Checks if optional detail should be left out.
+     * @return True once the minimum scale alone did not fit the budget.
+     */
+    [[nodiscard]] bool isReduced() const {
+        return m_isReduced;
+    }
+
+    /**
+     * @brief Returns the smoothed frame time.
+     * @return Frame time in milliseconds.
+     */
+    [[nodiscard]] float getAverageMs() const {
+        return m_averageMs;
+    }
+
+    /**
+     * @brief Returns the number of scale or quality changes.
+     * @return Change count since construction or reset.
+     */
+    [[nodiscard]] unsigned long getChanges() const {
+        return m_changes;
+    }
+
+    [[nodiscard]] const ResolutionRules* getRules() const {
+        return &m_rules;
+    }
+};
+
+} // namespace dino
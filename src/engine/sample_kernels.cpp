@@ -0,0 +1,255 @@
+/**
+ * sample_kernels.cpp - Vectorised PCM sample processing
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "platform/standard.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <SDL2/SDL.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DINO_SAMPLE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#include "sample_kernels.hpp"
+
+namespace {
+
+/* ===-=== Scalar kernels ===-=== */
+
+int16_t saturateS16_(float sample) {
+    float scaled = std::nearbyint(sample * 32767.0f);
+    return static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+}
+
+void mixStereoScalar_(float* target, const float* source, int frames, float gain_left, float gain_right) {
+    for (int frame = 0; frame < frames; frame++) {
+        target[2 * frame]     += source[2 * frame] * gain_left;
+        target[2 * frame + 1] += source[2 * frame + 1] * gain_right;
+    }
+}
+
+int resampleStereoScalar_(float* target, const float* source, int source_frames, double* position, double step, int frames) {
+    double cursor = *position;
+    int produced = 0;
+
+    while (produced < frames) {
+        auto index = static_cast<int>(cursor);
+
+        if (index + 1 >= source_frames) {
+            break;
+        }
+
+        auto weight = static_cast<float>(cursor - index);
+        const float* frame = source + 2 * index;
+
+        target[2 * produced]     = frame[0] + (frame[2] - frame[0]) * weight;
+        target[2 * produced + 1] = frame[1] + (frame[3] - frame[1]) * weight;
+
+        cursor = cursor + step;
+        produced++;
+    }
+
+    *position = cursor;
+    return produced;
+}
+
+void mixIntoS16Scalar_(int16_t* target, const float* source, int samples) {
+    for (int index = 0; index < samples; index++) {
+        int mixed = target[index] + saturateS16_(source[index]);
+        target[index] = static_cast<int16_t>(std::clamp(mixed, -32768, 32767));
+    }
+}
+
+void convertS16Scalar_(float* target, const int16_t* source, int samples) {
+    for (int index = 0; index < samples; index++) {
+        target[index] = static_cast<float>(source[index]) * (1.0f / 32768.0f);
+    }
+}
+
+#if defined(DINO_SAMPLE_KERNELS_X86) && DINO_SAMPLE_KERNELS_X86 == 1
+
+/* ===-=== SSE kernels ===-=== */
+
+void mixStereoSse_(float* target, const float* source, int frames, float gain_left, float gain_right) {
+    const __m128 gains = _mm_setr_ps(gain_left, gain_right, gain_left, gain_right);
+    const int samples = frames * 2;
+    int index = 0;
+
+    for (; index + 4 <= samples; index += 4) {
+        __m128 mixed = _mm_add_ps(_mm_loadu_ps(target + index), _mm_mul_ps(_mm_loadu_ps(source + index), gains));
+        _mm_storeu_ps(target + index, mixed);
+    }
+
+    mixStereoScalar_(target + index, source + index, (samples - index) / 2, gain_left, gain_right);
+}
+
+int resampleStereoSse_(float* target, const float* source, int source_frames, double* position, double step, int frames) {
+    double cursor = *position;
+    int produced = 0;
+
+    /* Two output frames per iteration, both need their next source frame. */
+    while (produced + 2 <= frames) {
+        auto index_a = static_cast<int>(cursor);
+        auto index_b = static_cast<int>(cursor + step);
+
+        if (index_b + 1 >= source_frames) {
+            break;
+        }
+
+        auto weight_a = static_cast<float>(cursor - index_a);
+        auto weight_b = static_cast<float>(cursor + step - index_b);
+
+        __m128 current = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(),
+                reinterpret_cast<const __m64*>(source + 2 * index_a)),
+                reinterpret_cast<const __m64*>(source + 2 * index_b));
+
+        __m128 next = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(),
+                reinterpret_cast<const __m64*>(source + 2 * index_a + 2)),
+                reinterpret_cast<const __m64*>(source + 2 * index_b + 2));
+
+        __m128 weights = _mm_setr_ps(weight_a, weight_a, weight_b, weight_b);
+        __m128 blended = _mm_add_ps(current, _mm_mul_ps(_mm_sub_ps(next, current), weights));
+
+        _mm_storeu_ps(target + 2 * produced, blended);
+
+        cursor = cursor + 2 * step;
+        produced = produced + 2;
+    }
+
+    *position = cursor;
+    return produced + resampleStereoScalar_(target + 2 * produced, source, source_frames, position, step, frames - produced);
+}
+
+void mixIntoS16Sse_(int16_t* target, const float* source, int samples) {
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    int index = 0;
+
+    for (; index + 8 <= samples; index += 8) {
+        __m128i low  = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + index), scale));
+        __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + index + 4), scale));
+
+        __m128i packed = _mm_packs_epi32(low, high);
+        __m128i mixed  = _mm_adds_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(target + index)), packed);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + index), mixed);
+    }
+
+    mixIntoS16Scalar_(target + index, source + index, samples - index);
+}
+
+void convertS16Sse_(float* target, const int16_t* source, int samples) {
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    int index = 0;
+
+    for (; index + 8 <= samples; index += 8) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+
+        /* Sign extend by unpacking into the high half and shifting back. */
+        __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+
+        _mm_storeu_ps(target + index, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(target + index + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+
+    convertS16Scalar_(target + index, source + index, samples - index);
+}
+
+/* ===-=== AVX kernels ===-=== */
+
+__attribute__((target("avx")))
+void mixStereoAvx_(float* target, const float* source, int frames, float gain_left, float gain_right) {
+    const __m256 gains = _mm256_setr_ps(gain_left, gain_right, gain_left, gain_right,
+                                        gain_left, gain_right, gain_left, gain_right);
+    const int samples = frames * 2;
+    int index = 0;
+
+    for (; index + 8 <= samples; index += 8) {
+        __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(target + index), _mm256_mul_ps(_mm256_loadu_ps(source + index), gains));
+        _mm256_storeu_ps(target + index, mixed);
+    }
+
+    mixStereoSse_(target + index, source + index, (samples - index) / 2, gain_left, gain_right);
+}
+
+__attribute__((target("avx")))
+void mixIntoS16Avx_(int16_t* target, const float* source, int samples) {
+    const __m256 scale = _mm256_set1_ps(32767.0f);
+    int index = 0;
+
+    for (; index + 8 <= samples; index += 8) {
+        __m256i converted = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(source + index), scale));
+
+        /* AVX has no 256 bit integer packing, finish on the two halves. */
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(converted), _mm256_extractf128_si256(converted, 1));
+        __m128i mixed  = _mm_adds_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(target + index)), packed);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + index), mixed);
+    }
+
+    mixIntoS16Scalar_(target + index, source + index, samples - index);
+}
+
+#endif // DINO_SAMPLE_KERNELS_X86
+
+} // namespace
+
+const char* dino::SampleKernels::s_name = "scalar";
+dino::SampleKernels::MixStereoFn dino::SampleKernels::s_mixStereo = mixStereoScalar_;
+dino::SampleKernels::ResampleStereoFn dino::SampleKernels::s_resampleStereo = resampleStereoScalar_;
+dino::SampleKernels::MixIntoS16Fn dino::SampleKernels::s_mixIntoS16 = mixIntoS16Scalar_;
+dino::SampleKernels::ConvertS16Fn dino::SampleKernels::s_convertS16 = convertS16Scalar_;
+
+void dino::SampleKernels::initialise() {
+#if defined(DINO_SAMPLE_KERNELS_X86) && DINO_SAMPLE_KERNELS_X86 == 1
+    /* SSE2 is part of the x86-64 baseline. */
+    s_name           = "sse";
+    s_mixStereo      = mixStereoSse_;
+    s_resampleStereo = resampleStereoSse_;
+    s_mixIntoS16     = mixIntoS16Sse_;
+    s_convertS16     = convertS16Sse_;
+
+    if (SDL_HasAVX() == SDL_TRUE) {
+        s_name       = "avx";
+        s_mixStereo  = mixStereoAvx_;
+        s_mixIntoS16 = mixIntoS16Avx_;
+    }
+#endif
+}
+
+const char* dino::SampleKernels::getName() {
+    return s_name;
+}
@@ -0,0 +1,120 @@
+/**
+ * sample_kernels.hpp - Vectorised PCM sample processing
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dino {
+
+/**
+ * @brief Sample processing kernels for interleaved stereo float PCM.
+ *
+ * Every kernel has a scalar and an SSE variant, mixing and the S16
+ * mix-down also have an AVX variant. Resampling and S16 conversion stay
+ * on SSE when AVX is picked. The fastest variant supported by the CPU
+ * is picked once by initialise().
+ */
+class SampleKernels {
+
+private:
+    typedef void (*MixStereoFn)(float*, const float*, int, float, float);
+    typedef int  (*ResampleStereoFn)(float*, const float*, int, double*, double, int);
+    typedef void (*MixIntoS16Fn)(int16_t*, const float*, int);
+    typedef void (*ConvertS16Fn)(float*, const int16_t*, int);
+
+    static const char* s_name;
+    static MixStereoFn s_mixStereo;
+    static ResampleStereoFn s_resampleStereo;
+    static MixIntoS16Fn s_mixIntoS16;
+    static ConvertS16Fn s_convertS16;
+
+public:
+    /**
+     * @brief Selects the kernel variants for the running CPU.
+     */
+    static void initialise();
+
+    /**
+     * @brief Returns the name of the selected kernel variant.
+     * @return Variant name, "avx" also covers the SSE kernels without an AVX variant.
+     */
+    static const char* getName();
+
+    /**
+     * @brief Adds a stereo buffer to another with a gain per channel.
+     * @param target Destination buffer.
+     * @param source Source buffer.
+     * @param frames Number of stereo frames.
+     * @param gain_left Gain of the left channel.
+     * @param gain_right Gain of the right channel.
+     */
+    static void mixStereo(float* target, const float* source, int frames, float gain_left, float gain_right) {
+        s_mixStereo(target, source, frames, gain_left, gain_right);
+    }
+
+    /**
+     * @brief Resamples a stereo buffer with linear interpolation.
+     * @param target Destination buffer.
+     * @param source Source buffer.
+     * @param source_frames Number of frames in the source.
+     * @param position Read position in source frames, advanced by the call.
+     * @param step Source frames consumed per output frame.
+     * @param frames Number of output frames wanted.
+     * @return Number of output frames produced before the source ran out.
+     */
+    static int resampleStereo(float* target, const float* source, int source_frames, double* position, double step, int frames) {
+        return s_resampleStereo(target, source, source_frames, position, step, frames);
+    }
+
+    /**
+     * @brief Adds float samples to signed 16 bit samples.
+     * @param target Destination buffer.
+     * @param source Source buffer in the range -1 to 1.
+     * @param samples Number of samples, not frames.
+     *
+     * Both the conversion and the addition saturate, which hard
+     * clips the mix to the 16 bit range.
+     */
+    static void mixIntoS16(int16_t* target, const float* source, int samples) {
+        s_mixIntoS16(target, source, samples);
+    }
+
+    /**
+     * @brief Converts signed 16 bit samples to float samples.
+     * @param target Destination buffer.
+     * @param source Source buffer.
+     * @param samples Number of samples, not frames.
+     */
+    static void convertS16(float* target, const int16_t* source, int samples) {
+        s_convertS16(target, source, samples);
+    }
+};
+
+} // namespace dino
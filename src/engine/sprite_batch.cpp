@@ -0,0 +1,282 @@
+/**
+ * sprite_batch.cpp - Sorted and batched sprite submission
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "except.hpp"
+#include "sprite_batch.hpp"
+
+namespace {
+
+constexpr float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+/* Corners of a quad in drawing order, as halves of its width and height. */
+constexpr float QUAD_CORNERS[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+/* Swaps in empty storage from the same resource, the old block is left to the arena. */
+template <typename T>
+void renew_(std::pmr::vector<T>& vector) {
+    std::pmr::vector<T> storage {vector.get_allocator()};
+    vector.swap(storage);
+}
+
+} // namespace
+
+dino::SpriteBatch::SpriteBatch(std::size_t capacity, std::pmr::memory_resource* frame_resource) :
+        m_frameResource(frame_resource),
+        m_capacity(capacity),
+        m_instances(frame_resource != nullptr ? frame_resource : std::pmr::get_default_resource()),
+        m_textureIds(m_instances.get_allocator()),
+        m_keys(m_instances.get_allocator()),
+        m_order(m_instances.get_allocator()),
+        m_scratchKeys(m_instances.get_allocator()),
+        m_scratchOrder(m_instances.get_allocator()),
+        m_vertices(m_instances.get_allocator()),
+        m_draws(m_instances.get_allocator()) {
+
+    reserve_();
+    m_indices.reserve(capacity * 6);
+}
+
+uint16_t dino::SpriteBatch::textureId_(SDL_Texture* texture) {
+    for (std::size_t index = 0; index < m_textures.size(); index++) {
+        if (m_textures[index].texture == texture) {
+            return static_cast<uint16_t>(index);
+        }
+    }
+
+    if (m_textures.size() > UINT16_MAX) {
+        throw dino::EngineError("Too many textures in one sprite batch!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    int width  = 0;
+    int height = 0;
+
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    m_textures.push_back(texture_entry {texture, static_cast<float>(width), static_cast<float>(height)});
+
+    return static_cast<uint16_t>(m_textures.size() - 1);
+}
+
+void dino::SpriteBatch::sort_() {
+    std::size_t length = m_instances.size();
+
+    m_keys.resize(length);
+    m_order.resize(length);
+    m_scratchKeys.resize(length);
+    m_scratchOrder.resize(length);
+
+    for (std::size_t index = 0; index < length; index++) {
+        m_keys[index]  = static_cast<uint32_t>(m_instances[index].layer) << 16 | m_textureIds[index];
+        m_order[index] = static_cast<uint32_t>(index);
+    }
+
+    for (unsigned int shift = 0; shift < 32; shift += 8) {
+        std::array<std::size_t, 256> offsets {};
+
+        for (auto key : m_keys) {
+            offsets[(key >> shift) & 0xff]++;
+        }
+
+        /* A byte shared by every key would leave the order as it is, most frames skip all but two passes. */
+        if (offsets[(m_keys[0] >> shift) & 0xff] == length) {
+            continue;
+        }
+
+        std::size_t total = 0;
+
+        for (auto& offset : offsets) {
+            std::size_t count = offset;
+            offset = total;
+            total  = total + count;
+        }
+
+        for (std::size_t index = 0; index < length; index++) {
+            std::size_t target = offsets[(m_keys[index] >> shift) & 0xff]++;
+
+            m_scratchKeys[target]  = m_keys[index];
+            m_scratchOrder[target] = m_order[index];
+        }
+
+        std::swap(m_keys, m_scratchKeys);
+        std::swap(m_order, m_scratchOrder);
+    }
+}
+
+void dino::SpriteBatch::reserve_() {
+    m_instances.reserve(m_capacity);
+    m_textureIds.reserve(m_capacity);
+    m_keys.reserve(m_capacity);
+    m_order.reserve(m_capacity);
+    m_scratchKeys.reserve(m_capacity);
+    m_scratchOrder.reserve(m_capacity);
+    m_vertices.reserve(m_capacity * 4);
+    m_draws.reserve(m_capacity);
+}
+
+void dino::SpriteBatch::appendQuad_(const dino::SpriteInstance& instance, const texture_entry& texture) {
+    SDL_Rect source = instance.source;
+
+    if (source.w <= 0 || source.h <= 0) {
+        source = SDL_Rect {0, 0, static_cast<int>(texture.width), static_cast<int>(texture.height)};
+    }
+
+    float left   = static_cast<float>(source.x) / texture.width;
+    float right  = static_cast<float>(source.x + source.w) / texture.width;
+    float top    = static_cast<float>(source.y) / texture.height;
+    float bottom = static_cast<float>(source.y + source.h) / texture.height;
+
+    if (instance.flip & SDL_FLIP_HORIZONTAL) {
+        std::swap(left, right);
+    }
+
+    if (instance.flip & SDL_FLIP_VERTICAL) {
+        std::swap(top, bottom);
+    }
+
+    const float tex_coords[4][2] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+
+    float half_width  = instance.target.w / 2.0f;
+    float half_height = instance.target.h / 2.0f;
+    float centre_x    = instance.target.x + half_width;
+    float centre_y    = instance.target.y + half_height;
+
+    float cosine = 1.0f;
+    float sine   = 0.0f;
+
+    if (instance.angle != 0.0f) {
+        cosine = std::cos(instance.angle * DEGREES_TO_RADIANS);
+        sine   = std::sin(instance.angle * DEGREES_TO_RADIANS);
+    }
+
+    for (int corner = 0; corner < 4; corner++) {
+        float offset_x = QUAD_CORNERS[corner][0] * half_width;
+        float offset_y = QUAD_CORNERS[corner][1] * half_height;
+
+        SDL_Vertex vertex;
+        vertex.position.x  = centre_x + offset_x * cosine - offset_y * sine;
+        vertex.position.y  = centre_y + offset_x * sine + offset_y * cosine;
+        vertex.color       = instance.tint;
+        vertex.tex_coord.x = tex_coords[corner][0];
+        vertex.tex_coord.y = tex_coords[corner][1];
+
+        m_vertices.push_back(vertex);
+    }
+}
+
+void dino::SpriteBatch::clear() {
+    m_textures.clear();
+    m_isPrepared = false;
+
+    if (m_frameResource == nullptr) {
+        m_instances.clear();
+        m_textureIds.clear();
+        m_vertices.clear();
+        m_draws.clear();
+
+        return void();
+    }
+
+    /* The storage of the last frame is released by the arena, size the next one after the busiest frame. */
+    m_capacity = std::max(m_capacity, m_instances.size());
+
+    renew_(m_instances);
+    renew_(m_textureIds);
+    renew_(m_keys);
+    renew_(m_order);
+    renew_(m_scratchKeys);
+    renew_(m_scratchOrder);
+    renew_(m_vertices);
+    renew_(m_draws);
+
+    reserve_();
+}
+
+void dino::SpriteBatch::add(const dino::SpriteInstance& instance) {
+    if (instance.texture == nullptr) {
+        throw dino::EngineError("Sprite instance has no texture!", dino::EngineError::E_TYPE_GENERAL);
+    }
+
+    m_textureIds.push_back(textureId_(instance.texture));
+    m_instances.push_back(instance);
+
+    m_isPrepared = false;
+}
+
+void dino::SpriteBatch::add(const dino::SpriteMaterial* material, uint16_t layer) {
+    auto const attachment = material->getAttachment();
+
+    dino::SpriteInstance instance;
+    instance.texture = material->getTexture();
+    instance.source  = *material->getProperties();
+    instance.layer   = layer;
+    instance.target  = SDL_FRect {static_cast<float>(attachment->x), static_cast<float>(attachment->y),
+                                  static_cast<float>(attachment->w), static_cast<float>(attachment->h)};
+
+    this->add(instance);
+}
+
+void dino::SpriteBatch::prepare() {
+    if (m_isPrepared) {
+        return void();
+    }
+
+    m_vertices.clear();
+    m_draws.clear();
+    m_isPrepared = true;
+
+    if (m_instances.empty()) {
+        return void();
+    }
+
+    this->sort_();
+
+    for (auto index : m_order) {
+        auto const& texture = m_textures[m_textureIds[index]];
+
+        if (m_draws.empty() || m_draws.back().texture != texture.texture) {
+            m_draws.push_back(dino::SpriteDraw {texture.texture, m_vertices.size(), 0});
+        }
+
+        appendQuad_(m_instances[index], texture);
+        m_draws.back().instances++;
+    }
+
+    /* Every draw starts at its own first vertex, so the indices of the longest batch serve all of them. */
+    for (std::size_t quad = m_indices.size() / 6; quad < m_instances.size(); quad++) {
+        int first = static_cast<int>(quad * 4);
+
+        for (int offset : {0, 1, 2, 2, 3, 0}) {
+            m_indices.push_back(first + offset);
+        }
+    }
+}
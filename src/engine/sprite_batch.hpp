@@ -0,0 +1,270 @@
+/**
+ * sprite_batch.hpp - Sorted and batched sprite submission
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "platform/standard.hpp"
+
+#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <SDL.h>
+#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1 
+#include <SDL2/SDL.h>
+#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+
+#include "sprite_material.hpp"
+
+/* Instances a batch reserves room for up front. */
+#define DINO_SPRITE_BATCH_CAPACITY 256
+
+namespace dino {
+
+/**
+ * @brief One sprite to be drawn by a sprite batch.
+ */
+struct sprite_instance {
+    SDL_Texture* texture = nullptr;
+
+    /**
+     * @brief Region of the texture, an empty rectangle uses the whole texture.
+     */
+    SDL_Rect source {};
+
+    /**
+     * @brief Region of the target the sprite covers.
+     */
+    SDL_FRect target {};
+
+    /**
+     * @brief Draw order, higher layers are drawn over lower ones.
+     */
+    uint16_t layer = 0;
+
+    /**
+     * @brief Multiplied with the texture colour, the alpha fades the sprite.
+     */
+    SDL_Color tint {0xff, 0xff, 0xff, 0xff};
+
+    /**
+     * @brief Combination of SDL_FLIP_HORIZONTAL and SDL_FLIP_VERTICAL.
+     */
+    int flip = SDL_FLIP_NONE;
+
+    /**
+     * @brief Clockwise rotation about the centre of the target in degrees.
+     */
+    float angle = 0.0f;
+};
+
+typedef struct sprite_instance SpriteInstance;
+
+/**
+ * @brief A run of instances that share a texture, drawn with one call.
+ */
+struct sprite_draw {
+    SDL_Texture* texture = nullptr;
+
+    /**
+     * @brief First vertex of the run, every instance has four.
+     */
+    std::size_t firstVertex = 0;
+
+    std::size_t instances = 0;
+};
+
+typedef struct sprite_draw SpriteDraw;
+
+/**
+ * @brief Collects the sprites of a frame and turns them into few draw calls.
+ *
+ * Instances can be added in any order. prepare() sorts them by layer
+ * and then by texture with a radix sort, so the result only depends on
+ * the layers and the textures in use, and builds one quad per instance.
+ * Consecutive instances of a texture become a single geometry draw.
+ *
+ * The sort is stable. Instances of one texture on one layer keep the
+ * order they were added in, while different textures on one layer are
+ * drawn in the order their textures were first added.
+ *
+ * The instances, sort keys and vertices of a frame can come from a
+ * frame arena. clear() then takes fresh storage from the arena, so it
+ * has to be called every frame after FrameArena::beginFrame() and
+ * before the batch is used.
+ */
+class SpriteBatch {
+
+private:
+    /**
+     * @brief Per-frame storage, the default resource keeps the memory across frames instead.
+     */
+    std::pmr::memory_resource* m_frameResource;
+
+    /**
+     * @brief Instances the per-frame storage is taken for, the most seen in a frame.
+     */
+    std::size_t m_capacity;
+
+    std::pmr::vector<SpriteInstance> m_instances;
+
+    /**
+     * @brief Textures seen since the last clear, the index is the texture part of the sort key.
+     */
+    struct texture_entry {
+        SDL_Texture* texture;
+        float width;
+        float height;
+    };
+
+    std::vector<texture_entry> m_textures;
+
+    /**
+     * @brief Texture index of each instance.
+     */
+    std::pmr::vector<uint16_t> m_textureIds;
+
+    /**
+     * @brief Sort keys and instance indices, with scratch space for the radix passes.
+     */
+    std::pmr::vector<uint32_t> m_keys;
+    std::pmr::vector<uint32_t> m_order;
+    std::pmr::vector<uint32_t> m_scratchKeys;
+    std::pmr::vector<uint32_t> m_scratchOrder;
+
+    std::pmr::vector<SDL_Vertex> m_vertices;
+
+    /**
+     * @brief Two triangles per quad, shared by every draw since vertices are passed per run.
+     */
+    std::vector<int> m_indices;
+
+    std::pmr::vector<SpriteDraw> m_draws;
+
+    bool m_isPrepared = false;
+
+    /**
+     * @brief Returns the index of a texture, adding it if it is new.
+     * @param texture The texture.
+     * @return Index into m_textures.
+     * @throw EngineError Thrown if the batch already holds 65536 textures.
+     */
+    uint16_t textureId_(SDL_Texture*);
+
+    /**
+     * @brief Sorts m_order by the keys, least significant byte first.
+     */
+    void sort_();
+
+    /**
+     * @brief Reserves room for m_capacity instances in the per-frame storage.
+     */
+    void reserve_();
+
+    /**
+     * @brief Appends the four vertices of an instance.
+     * @param instance The instance.
+     * @param texture Texture entry of the instance.
+     */
+    void appendQuad_(const SpriteInstance&, const texture_entry&);
+
+public:
+    /**
+     * @brief Reserves room for a number of instances.
+     * @param capacity Instances per frame expected, the batch grows past it if needed.
+     * @param frame_resource Resource of the per-frame storage, usually FrameArena::getResource().
+     */
+    explicit SpriteBatch(std::size_t capacity = DINO_SPRITE_BATCH_CAPACITY, std::pmr::memory_resource* frame_resource = nullptr);
+
+    /**
+     * @brief Removes every instance.
+     *
+     * Keeps the memory, or takes new storage from the frame resource
+     * when the batch has one.
+     */
+    void clear();
+
+    /**
+     * @brief Adds an instance.
+     * @param instance The instance.
+     * @throw EngineError Thrown if the instance has no texture.
+     */
+    void add(const SpriteInstance&);
+
+    /**
+     * @brief Adds a sprite material at its scissor and attachment.
+     * @param material The sprite material.
+     * @param layer Draw order.
+     */
+    void add(const SpriteMaterial*, uint16_t);
+
+    /**
+     * @brief Sorts the instances and builds their geometry.
+     *
+     * Called by Renderer::draw(), does nothing if the batch has not
+     * changed since the last call.
+     */
+    void prepare();
+
+    /**
+     * @brief Returns the number of instances.
+     * @return Instances added since the last clear.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return m_instances.size();
+    }
+
+    /**
+     * @brief Returns the vertices built by prepare().
+     * @return Four vertices per instance, in draw order.
+     */
+    [[nodiscard]] const std::pmr::vector<SDL_Vertex>* getVertices() const {
+        return &m_vertices;
+    }
+
+    /**
+     * @brief Returns the indices of the quads of one draw.
+     * @return Six indices per instance, relative to the first vertex of the draw.
+     */
+    [[nodiscard]] const int* getIndices() const {
+        return m_indices.data();
+    }
+
+    /**
+     * @brief Returns the draws built by prepare().
+     * @return One entry per run of instances sharing a texture.
+     */
+    [[nodiscard]] const std::pmr::vector<SpriteDraw>* getDraws() const {
+        return &m_draws;
+    }
+};
+
+} // namespace dino
@@ -27,6 +27,7 @@
  * ==============================================================================
  */
 
+#include <cstring>
 #include <vector>
 
 #include "assert.hpp"
@@ -70,14 +71,218 @@ dino::SpriteMaterial::SpriteMaterial(SDL_Texture* texture, const SDL_Rect& prope
     m_isCloned = true;
 }
 
+dino::SpriteMaterial::SpriteMaterial(SDL_Texture* texture) {
+    m_texture = texture;
+
+    SDL_QueryTexture(m_texture, nullptr, nullptr, &(m_scissor.w), &(m_scissor.h));
+
+    m_attachment.w = m_scissor.w;
+    m_attachment.h = m_scissor.h;
+
+    s_counter = s_counter + 1;
+}
+
+SDL_Texture* dino::SpriteMaterial::createTexture_(SDL_Renderer* renderer, uint32_t pixel_format, int width, int height, const void* pixels, int pitch) {
+    SDL_RendererInfo info {};
+    Uint32 texture_format = SDL_PIXELFORMAT_ARGB8888;
+
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.num_texture_formats > 0) {
+        texture_format = info.texture_formats[0];
+
+        for (Uint32 index = 0; index < info.num_texture_formats; index++) {
+            if (info.texture_formats[index] == pixel_format) {
+                texture_format = pixel_format;
+            }
+        }
+    }
+
+    SDL_Texture* texture;
+
+    if (texture_format == pixel_format) {
+        texture = SDL_CreateTexture(renderer, texture_format, SDL_TEXTUREACCESS_STATIC, width, height);
+        DINO_ASSERT_SDL_HANDLE(texture, dino::EngineError::E_TYPE_SDL_RESULT)
+
+        if (SDL_UpdateTexture(texture, nullptr, pixels, pitch) != 0) {
+            SDL_DestroyTexture(texture);
+            throw dino::EngineError(SDL_GetError(), dino::EngineError::E_TYPE_SDL_RESULT);
+        }
+
+    } else {
+        texture = SDL_CreateTexture(renderer, texture_format, SDL_TEXTUREACCESS_STREAMING, width, height);
+        DINO_ASSERT_SDL_HANDLE(texture, dino::EngineError::E_TYPE_SDL_RESULT)
+
+        void* texture_pixels = nullptr;
+        int texture_pitch = 0;
+
+        /* Converted in one pass into the texture, no intermediate image. */
+        bool is_converted = SDL_LockTexture(texture, nullptr, &texture_pixels, &texture_pitch) == 0 &&
+                SDL_ConvertPixels(width, height, pixel_format, pixels, pitch, texture_format, texture_pixels, texture_pitch) == 0;
+
+        if (texture_pixels != nullptr) {
+            SDL_UnlockTexture(texture);
+        }
+
+        if (!is_converted) {
+            SDL_DestroyTexture(texture);
+            throw dino::EngineError(SDL_GetError(), dino::EngineError::E_TYPE_SDL_RESULT);
+        }
+    }
+
+    if (SDL_ISPIXELFORMAT_ALPHA(pixel_format)) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+
+    return texture;
+}
+
+dino::SpriteMaterial* dino::SpriteMaterial::fromSurface_(SDL_Renderer* renderer, SDL_Surface* surface) {
+    DINO_ASSERT_SDL_HANDLE(surface, dino::EngineError::E_TYPE_SDL_RESULT)
+
+    /* Palettes and colour keys need the conversion SDL does for surfaces. */
+    if (SDL_ISPIXELFORMAT_INDEXED(surface->format->format) || SDL_HasColorKey(surface)) {
+        dino::SpriteMaterial* material;
+
+        try {
+            material = new dino::SpriteMaterial(renderer, surface);
+        } catch (...) {
+            SDL_FreeSurface(surface);
+            throw;
+        }
+
+        SDL_FreeSurface(surface);
+        return material;
+    }
+
+    SDL_Texture* texture = nullptr;
+
+    try {
+        SDL_LockSurface(surface);
+        texture = createTexture_(renderer, surface->format->format, surface->w, surface->h, surface->pixels, surface->pitch);
+    } catch (...) {
+        SDL_UnlockSurface(surface);
+        SDL_FreeSurface(surface);
+        throw;
+    }
+
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+
+    return new dino::SpriteMaterial(texture);
+}
+
 dino::SpriteMaterial *dino::SpriteMaterial::loadImage(SDL_Renderer *renderer, const std::string& file_path) {
+    return fromSurface_(renderer, IMG_Load(file_path.c_str()));
+}
+
+dino::SpriteMaterial *dino::SpriteMaterial::loadImage(SDL_Renderer *renderer, const dino::FileView& image_data) {
+    dino::RawImageHeader header {};
+
+    if (image_data.size >= sizeof(header)) {
+        std::memcpy(&header, image_data.data, sizeof(header));
+    }
+
+    /* Raw images are uploaded straight from the bytes given. */
+    if (std::memcmp(header.magic, DINO_RAW_IMAGE_MAGIC, sizeof(header.magic)) == 0) {
+        uint64_t row_size = static_cast<uint64_t>(header.width) * SDL_BYTESPERPIXEL(header.pixelFormat);
+
+        if (SDL_ISPIXELFORMAT_INDEXED(header.pixelFormat) || SDL_ISPIXELFORMAT_FOURCC(header.pixelFormat) || row_size == 0 ||
+                header.pitch < row_size || header.height > INT32_MAX || header.width > INT32_MAX ||
+                static_cast<uint64_t>(header.pitch) * header.height > image_data.size - sizeof(header)) {
+            throw dino::EngineError("Raw image is truncated or corrupt.", dino::EngineError::E_TYPE_GENERAL);
+        }
+
+        SDL_Texture* texture = createTexture_(renderer, header.pixelFormat, static_cast<int>(header.width),
+                static_cast<int>(header.height), image_data.data + sizeof(header), static_cast<int>(header.pitch));
+
+        return new dino::SpriteMaterial(texture);
+    }
+
+    SDL_RWops* source = SDL_RWFromConstMem(image_data.data, static_cast<int>(image_data.size));
+    DINO_ASSERT_SDL_HANDLE(source, dino::EngineError::E_TYPE_SDL_RESULT)
+
+    return fromSurface_(renderer, IMG_Load_RW(source, 1));
+}
+
+dino::SpriteMaterial* dino::SpriteMaterial::createTarget(SDL_Renderer* renderer, int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    DINO_ASSERT_SDL_HANDLE(texture, dino::EngineError::E_TYPE_SDL_RESULT)
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    return new dino::SpriteMaterial(texture);
+}
+
+SDL_Surface* dino::SpriteMaterial::decodeImage(const std::string& file_path, uint32_t pixel_format) {
     SDL_Surface* surface = IMG_Load(file_path.c_str());
-    DINO_ASSERT_SDL_HANDLE(surface, dino::EngineError::E_TYPE_SDL_RESULT)
 
-    auto material = new dino::SpriteMaterial(renderer, surface);
+    if (surface == nullptr) {
+        return nullptr;
+    }
+
+    /* Converted here, the upload on the render thread is then a plain copy. */
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, pixel_format, 0);
+    SDL_FreeSurface(surface);
+
+    return converted;
+}
+
+bool dino::SpriteMaterial::encodeRaw(const dino::FileView& image_data, uint32_t pixel_format, std::vector<uint8_t>* raw_image) {
+    SDL_RWops* source = SDL_RWFromConstMem(image_data.data, static_cast<int>(image_data.size));
+    SDL_Surface* surface = source != nullptr ? IMG_Load_RW(source, 1) : nullptr;
+
+    if (surface == nullptr) {
+        return false;
+    }
 
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, pixel_format, 0);
     SDL_FreeSurface(surface);
-    return material;
+
+    if (converted == nullptr) {
+        return false;
+    }
+
+    dino::RawImageHeader header {};
+    std::memcpy(header.magic, DINO_RAW_IMAGE_MAGIC, sizeof(header.magic));
+
+    header.pixelFormat = pixel_format;
+    header.width  = converted->w;
+    header.height = converted->h;
+    header.pitch  = converted->w * SDL_BYTESPERPIXEL(pixel_format);
+
+    raw_image->resize(sizeof(header) + static_cast<std::size_t>(header.pitch) * header.height);
+    std::memcpy(raw_image->data(), &header, sizeof(header));
+
+    SDL_LockSurface(converted);
+
+    for (uint32_t row = 0; row < header.height; row++) {
+        std::memcpy(raw_image->data() + sizeof(header) + static_cast<std::size_t>(row) * header.pitch,
+                static_cast<const uint8_t*>(converted->pixels) + static_cast<std::size_t>(row) * converted->pitch, header.pitch);
+    }
+
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+
+    return true;
+}
+
+uint32_t dino::SpriteMaterial::getPixelFormat() const {
+    Uint32 pixel_format = SDL_PIXELFORMAT_UNKNOWN;
+    SDL_QueryTexture(m_texture, &pixel_format, nullptr, nullptr, nullptr);
+
+    return pixel_format;
+}
+
+bool dino::SpriteMaterial::updatePixels(SDL_Surface* surface) {
+    int width  = 0;
+    int height = 0;
+
+    SDL_QueryTexture(m_texture, nullptr, nullptr, &width, &height);
+
+    if (surface->w != width || surface->h != height || surface->format->format != getPixelFormat()) {
+        return false;
+    }
+
+    return SDL_UpdateTexture(m_texture, nullptr, surface->pixels, surface->pitch) == 0;
 }
 
 dino::SpriteMaterial::~SpriteMaterial() {
@@ -96,10 +301,6 @@ dino::SpriteMaterial* dino::SpriteMaterial::clone() {
     return new SpriteMaterial(m_texture, m_scissor, m_attachment);
 }
 
-SDL_Texture *dino::SpriteMaterial::getTexture() const {
-    return m_texture;
-}
-
 void dino::SpriteMaterial::setAttachment(int pos_x, int pos_y, int width, int height) {
     m_attachment.x = pos_x;
     m_attachment.y = pos_y;
@@ -107,51 +308,9 @@ void dino::SpriteMaterial::setAttachment(int pos_x, int pos_y, int width, int he
     m_attachment.h = height;
 }
 
-void dino::SpriteMaterial::setAttachment(int pos_x, int pos_y) {
-    m_attachment.x = pos_x;
-    m_attachment.y = pos_y;
-}
-
 void dino::SpriteMaterial::setScissor(int pos_x, int pos_y, int width, int height) {
     m_scissor.x = pos_x;
     m_scissor.y = pos_y;
     m_scissor.w = width;
     m_scissor.h = height;
 }
-
-void dino::SpriteMaterial::setScissor(int pos_x, int pox_y) {
-    m_scissor.x = pos_x;
-    m_scissor.y = pox_y;
-}
-
-const SDL_Rect* dino::SpriteMaterial::getProperties() const {
-    return &m_scissor;
-}
-
-int dino::SpriteMaterial::getWidth() const {
-    return m_scissor.w;
-}
-
-int dino::SpriteMaterial::getHeight() const {
-    return m_scissor.h;
-}
-
-int dino::SpriteMaterial::getPositionX() const {
-    return m_attachment.x;
-}
-
-int dino::SpriteMaterial::getPositionY() const {
-    return m_attachment.y;
-}
-
-const SDL_Rect* dino::SpriteMaterial::getAttachment() const {
-    return &m_attachment;
-}
-
-int dino::SpriteMaterial::getScissorX() const {
-    return m_scissor.x;
-}
-
-int dino::SpriteMaterial::getScissorY() const {
-    return m_scissor.y;
-}
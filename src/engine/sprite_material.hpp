@@ -29,9 +29,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "platform/standard.hpp"
+#include "platform/virtual_filesystem.hpp"
+#include "geometry.hpp"
 
 #if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
 #include <SDL.h>
@@ -39,8 +43,31 @@
 #include <SDL2/SDL.h>
 #endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
 
+/* Raw images hold pixels already in a texture format, see SpriteMaterial::encodeRaw(). */
+#define DINO_RAW_IMAGE_MAGIC "DTEX"
+#define DINO_RAW_IMAGE_EXTENSION ".dtex"
+
+/* Header size of a raw image, keeps the pixels 16 byte aligned inside an asset pack. */
+#define DINO_RAW_IMAGE_HEADER_SIZE 32
+
 namespace dino {
 
+/**
+ * @brief Header of a raw image, followed by the rows of pixels.
+ */
+struct raw_image_header {
+    char magic[4];
+    uint32_t pixelFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;
+    uint8_t reserved[12];
+};
+
+typedef struct raw_image_header RawImageHeader;
+
+static_assert(sizeof(RawImageHeader) == DINO_RAW_IMAGE_HEADER_SIZE, "Raw image header must keep the pixels aligned.");
+
 /**
  * @brief Wraps a SDL texture for rendering on to the screen.
  */
@@ -98,6 +125,38 @@ private: /* ===-=== Private Members ===-=== */
      */
     explicit SpriteMaterial(SDL_Texture*, const SDL_Rect&, const SDL_Rect&);
 
+    /**
+     * @brief Constructs an instance taking ownership of a SDL texture.
+     * @param texture SDL texture to be wrapped and destroyed with the instance.
+     */
+    explicit SpriteMaterial(SDL_Texture*);
+
+    /**
+     * @brief Creates a texture holding the given pixels.
+     * @param renderer Handle to the current SDL window renderer.
+     * @param pixel_format Format of the pixels.
+     * @param width Width in pixels.
+     * @param height Height in pixels.
+     * @param pixels The rows of pixels.
+     * @param pitch Bytes per row.
+     * @return The texture.
+     * @throw dino::EngineError Thrown if the texture cannot be created.
+     *
+     * Pixels in a format the renderer supports are uploaded as they are.
+     * Other formats are converted straight into the locked texture in
+     * the native format of the renderer.
+     */
+    static SDL_Texture* createTexture_(SDL_Renderer*, uint32_t, int, int, const void*, int);
+
+    /**
+     * @brief Creates a texture from a decoded image.
+     * @param renderer Handle to the current SDL window renderer.
+     * @param surface The decoded image, freed by the call.
+     * @return An instance holding the image.
+     * @throw dino::EngineError Thrown if the image is nullptr or the texture cannot be created.
+     */
+    static SpriteMaterial* fromSurface_(SDL_Renderer*, SDL_Surface*);
+
 public: /* ===-=== Public Members ===-=== */
     /**
      * @brief Creates an instance holding a texture created from an image.
@@ -108,6 +167,42 @@ public: /* ===-=== Public Members ===-=== */
      */
     static SpriteMaterial* loadImage(SDL_Renderer*, const std::string&);
 
+    /**
+     * @brief Creates an instance holding a texture created from an image in memory.
+     * @param renderer Handle to the current SDL window renderer.
+     * @param image_data Bytes of an image file or a raw image, only read during the call.
+     * @return An instance with the specified image data.
+     * @throw dino::EngineError Thrown if image loading fails.
+     */
+    static SpriteMaterial* loadImage(SDL_Renderer*, const FileView&);
+
+    /**
+     * @brief Creates an instance holding a texture that can be rendered into.
+     * @param renderer Handle to the current SDL window renderer.
+     * @param width Texture width in pixels.
+     * @param height Texture height in pixels.
+     * @return An instance with a transparent render target texture.
+     * @throw dino::EngineError Thrown if the texture cannot be created.
+     */
+    static SpriteMaterial* createTarget(SDL_Renderer*, int, int);
+
+    /**
+     * @brief Decodes an image for updatePixels(), safe to call from any thread.
+     * @param file_path Absolute path to the image file.
+     * @param pixel_format Format to convert to, see getPixelFormat().
+     * @return The decoded image to be freed with SDL_FreeSurface(), nullptr if decoding fails.
+     */
+    static SDL_Surface* decodeImage(const std::string&, uint32_t);
+
+    /**
+     * @brief Converts an image file into a raw image, loaded without decoding.
+     * @param image_data Bytes of the image file.
+     * @param pixel_format Format to store, the native format of the target renderer avoids any conversion.
+     * @param raw_image Receives the header and the pixels.
+     * @return True on success, false if the image cannot be decoded or converted.
+     */
+    static bool encodeRaw(const FileView&, uint32_t, std::vector<uint8_t>*);
+
     /**
      * @brief Cleans up when an instance is destroyed.
      *
@@ -141,7 +236,10 @@ public: /* ===-=== Public Members ===-=== */
      * @param pos_x The X coordinate in pixels.
      * @param pos_y The Y coordinate in pixels.
      */
-    void setAttachment(int, int);
+    void setAttachment(int pos_x, int pos_y) {
+        m_attachment.x = pos_x;
+        m_attachment.y = pos_y;
+    }
 
     /**
      * @brief Sets the full scissor coordinates in pixels
@@ -157,61 +255,115 @@ public: /* ===-=== Public Members ===-=== */
      * @param pos_x The X coordinate in pixels.
      * @param pox_y The Y coordinate in pixels.
      */
-    void setScissor(int pos_x, int pox_y);
+    void setScissor(int pos_x, int pox_y) {
+        m_scissor.x = pos_x;
+        m_scissor.y = pox_y;
+    }
 
     /**
      * @brief Returns the SDL texture.
      * @return SDL texture.
      */
-    [[nodiscard]] SDL_Texture* getTexture() const;
+    [[nodiscard]] SDL_Texture* getTexture() const {
+        return m_texture;
+    }
+
+    /**
+     * @brief Returns the pixel format of the texture.
+     * @return One of the SDL_PIXELFORMAT values.
+     */
+    [[nodiscard]] uint32_t getPixelFormat() const;
+
+    /**
+     * @brief Replaces the pixels of the texture in place.
+     * @param surface Image from decodeImage(), of the same size and format as the texture.
+     * @return True if replaced, false if the size or the format differs.
+     *
+     * The texture handle does not change, so every clone shows the new
+     * pixels. Must be called on the thread that renders.
+     */
+    bool updatePixels(SDL_Surface*);
 
     /**
      * @brief Returns the texture properties.
      * @return The texture property structure.
      */
-    [[nodiscard]] const SDL_Rect* getProperties() const;
+    [[nodiscard]] const SDL_Rect* getProperties() const {
+        return &m_scissor;
+    }
 
     /**
      * @brief Returns the attachment details.
      * @return The attachment details.
      */
-    [[nodiscard]] const SDL_Rect* getAttachment() const;
+    [[nodiscard]] const SDL_Rect* getAttachment() const {
+        return &m_attachment;
+    }
 
     /**
      * @brief Returns the texture width in pixels.
      * @return The texture width.
      */
-    [[nodiscard]] int getWidth() const;
+    [[nodiscard]] int getWidth() const {
+        return m_scissor.w;
+    }
 
     /**
      * @brief Returns the texture height in pixels.
      * @return The texture height.
      */
-    [[nodiscard]] int getHeight() const;
+    [[nodiscard]] int getHeight() const {
+        return m_scissor.h;
+    }
 
     /**
      * @brief Returns the X axis value of attachment property.
      * @return The X axis value in pixels.
      */
-    [[nodiscard]] int getPositionX() const;
+    [[nodiscard]] int getPositionX() const {
+        return m_attachment.x;
+    }
 
     /**
      * @brief Returns the Y axis value of attachment property.
      * @return The Y axis value in pixels.
      */
-    [[nodiscard]] int getPositionY() const;
+    [[nodiscard]] int getPositionY() const {
+        return m_attachment.y;
+    }
 
     /**
      * @brief Returns the X axis value of scissor rectangle.
      * @return The X axis value in pixels.
      */
-    [[nodiscard]] int getScissorX() const;
+    [[nodiscard]] int getScissorX() const {
+        return m_scissor.x;
+    }
 
     /**
      * @brief Returns the Y axis value of scissor rectangle.
      * @return The Y axis value in pixels.
      */
-    [[nodiscard]] int getScissorY() const;
+    [[nodiscard]] int getScissorY() const {
+        return m_scissor.y;
+    }
+
+    /**
+     * @brief Returns where the sprite is drawn on the screen.
+     * @return The attachment as a rectangle.
+     */
+    [[nodiscard]] Rect2 getBounds() const {
+        return Rect2 {m_attachment.x, m_attachment.y, m_attachment.w, m_attachment.h};
+    }
+
+    /**
+     * @brief Moves the attachment to a position.
+     * @param position The top left corner in pixels.
+     */
+    void setPosition(const Vector2& position) {
+        m_attachment.x = position.x;
+        m_attachment.y = position.y;
+    }
 };
 
 } // namespace dino
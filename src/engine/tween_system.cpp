@@ -0,0 +1,188 @@
+/**
+ * tween_system.cpp - Property tweens advanced per tick
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "tween_system.hpp"
+
+namespace {
+
+constexpr float PI = 3.14159265358979f;
+
+} // namespace
+
+float dino::TweenSystem::ease(int easing, float progress) {
+    switch (easing) {
+        case EASE_IN_QUAD:
+            return progress * progress;
+
+        case EASE_OUT_QUAD:
+            return progress * (2.0f - progress);
+
+        case EASE_IN_OUT_QUAD:
+            return progress < 0.5f ?
+                2.0f * progress * progress :
+                1.0f - 2.0f * (1.0f - progress) * (1.0f - progress);
+
+        case EASE_IN_OUT_SINE:
+            return 0.5f - 0.5f * std::cos(PI * progress);
+
+        case SINE_ARC:
+            return std::sin(PI * progress);
+
+        default:
+            return progress;
+    }
+}
+
+dino::TweenSystem::TweenSystem(std::size_t capacity) {
+    m_ids.reserve(capacity);
+    m_targets.reserve(capacity);
+    m_from.reserve(capacity);
+    m_delta.reserve(capacity);
+    m_elapsed.reserve(capacity);
+    m_duration.reserve(capacity);
+    m_easing.reserve(capacity);
+    m_repeat.reserve(capacity);
+    m_callbacks.reserve(capacity);
+    m_finished.reserve(capacity);
+}
+
+void dino::TweenSystem::remove_(std::size_t index) {
+    std::size_t last = m_ids.size() - 1;
+
+    if (index != last) {
+        m_ids[index]       = m_ids[last];
+        m_targets[index]   = m_targets[last];
+        m_from[index]      = m_from[last];
+        m_delta[index]     = m_delta[last];
+        m_elapsed[index]   = m_elapsed[last];
+        m_duration[index]  = m_duration[last];
+        m_easing[index]    = m_easing[last];
+        m_repeat[index]    = m_repeat[last];
+        m_callbacks[index] = std::move(m_callbacks[last]);
+    }
+
+    m_ids.pop_back();
+    m_targets.pop_back();
+    m_from.pop_back();
+    m_delta.pop_back();
+    m_elapsed.pop_back();
+    m_duration.pop_back();
+    m_easing.pop_back();
+    m_repeat.pop_back();
+    m_callbacks.pop_back();
+}
+
+uint32_t dino::TweenSystem::start(dino::TweenSpec spec) {
+    uint32_t tween_id = m_nextId;
+    m_nextId = m_nextId == UINT32_MAX ? 1 : m_nextId + 1;
+
+    *spec.target = spec.from + (spec.to - spec.from) * ease(spec.easing, 0.0f);
+
+    m_ids.push_back(tween_id);
+    m_targets.push_back(spec.target);
+    m_from.push_back(spec.from);
+    m_delta.push_back(spec.to - spec.from);
+    m_elapsed.push_back(0.0f);
+    m_duration.push_back(std::max(spec.duration, 0.001f));
+    m_easing.push_back(spec.easing);
+    m_repeat.push_back(spec.repeat);
+    m_callbacks.push_back(std::move(spec.onComplete));
+
+    return tween_id;
+}
+
+bool dino::TweenSystem::cancel(uint32_t tween_id) {
+    auto found = std::find(m_ids.begin(), m_ids.end(), tween_id);
+
+    if (found == m_ids.end()) {
+        return false;
+    }
+
+    remove_(static_cast<std::size_t>(found - m_ids.begin()));
+    return true;
+}
+
+bool dino::TweenSystem::isActive(uint32_t tween_id) const {
+    return tween_id != 0 && std::find(m_ids.begin(), m_ids.end(), tween_id) != m_ids.end();
+}
+
+void dino::TweenSystem::update(float delta_ms) {
+    std::size_t index = 0;
+
+    while (index < m_ids.size()) {
+        float elapsed = m_elapsed[index] + delta_ms;
+
+        if (elapsed >= m_duration[index] && m_repeat[index] != 0) {
+            elapsed = std::fmod(elapsed, m_duration[index]);
+            m_repeat[index] = m_repeat[index] > 0 ? m_repeat[index] - 1 : m_repeat[index];
+        }
+
+        float progress = std::min(elapsed / m_duration[index], 1.0f);
+
+        *m_targets[index] = m_from[index] + m_delta[index] * ease(m_easing[index], progress);
+        m_elapsed[index] = elapsed;
+
+        if (progress < 1.0f) {
+            index = index + 1;
+            continue;
+        }
+
+        if (m_callbacks[index]) {
+            m_finished.push_back(std::move(m_callbacks[index]));
+        }
+
+        remove_(index);
+    }
+
+    for (auto& callback : m_finished) {
+        callback();
+    }
+
+    m_finished.clear();
+}
+
+void dino::TweenSystem::clear() {
+    m_ids.clear();
+    m_targets.clear();
+    m_from.clear();
+    m_delta.clear();
+    m_elapsed.clear();
+    m_duration.clear();
+    m_easing.clear();
+    m_repeat.clear();
+    m_callbacks.clear();
+}
+
+std::size_t dino::TweenSystem::size() const {
+    return m_ids.size();
+}
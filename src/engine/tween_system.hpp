@@ -0,0 +1,180 @@
+/**
+ * tween_system.hpp - Property tweens advanced per tick
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace dino {
+
+/**
+ * @brief Describes a tween to be started.
+ *
+ * A tween moves a float from one value to another over a duration.
+ * Positions, alpha and colour channels are all tweened as floats
+ * owned by the caller, who applies them once per frame.
+ */
+struct tween_spec {
+    /**
+     * @brief Value written on every tick, must outlive the tween.
+     */
+    float* target = nullptr;
+
+    float from = 0.0f;
+    float to   = 1.0f;
+
+    /**
+     * @brief Length of one run in milliseconds.
+     */
+    float duration = 0.0f;
+
+    /**
+     * @brief One of TweenSystem::Easing.
+     */
+    int easing = 0;
+
+    /**
+     * @brief Runs after the first, -1 repeats until cancelled.
+     */
+    int repeat = 0;
+
+    /**
+     * @brief Called once the last run has finished, never on cancel.
+     */
+    std::function<void()> onComplete;
+};
+
+typedef struct tween_spec TweenSpec;
+
+/**
+ * @brief Advances any number of tweens from the main loop.
+ *
+ * Tweens are stored in packed parallel arrays and advanced together
+ * by update(), so animations need neither threads nor blocking loops.
+ * Finished tweens are removed by moving the last tween into their slot.
+ *
+ * Completion callbacks run at the end of update(), after every tween
+ * has been advanced, so they may start or cancel tweens freely.
+ */
+class TweenSystem {
+
+public:
+    enum Easing : int {
+        LINEAR = 0,
+        EASE_IN_QUAD,
+        EASE_OUT_QUAD,
+        EASE_IN_OUT_QUAD,
+        EASE_IN_OUT_SINE,
+
+        /**
+         * @brief Rises to the end value half way and returns, like a jump.
+         */
+        SINE_ARC
+    };
+
+private:
+    std::vector<uint32_t> m_ids;
+    std::vector<float*> m_targets;
+    std::vector<float> m_from;
+    std::vector<float> m_delta;
+    std::vector<float> m_elapsed;
+    std::vector<float> m_duration;
+    std::vector<int> m_easing;
+    std::vector<int> m_repeat;
+    std::vector<std::function<void()>> m_callbacks;
+
+    /**
+     * @brief Callbacks of the tweens finished by the current update.
+     */
+    std::vector<std::function<void()>> m_finished;
+
+    uint32_t m_nextId = 1;
+
+    /**
+     * @brief Removes the tween at an index by moving the last tween into it.
+     */
+    void remove_(std::size_t);
+
+public:
+    /**
+     * @brief Maps linear progress through an easing curve.
+     * @param easing One of TweenSystem::Easing.
+     * @param progress Progress from 0 to 1.
+     * @return Eased progress.
+     */
+    static float ease(int, float);
+
+    /**
+     * @brief Reserves room for a number of tweens.
+     * @param capacity Expected number of concurrent tweens.
+     */
+    explicit TweenSystem(std::size_t capacity = 64);
+
+    /**
+     * @brief Starts a tween and writes its start value.
+     * @param spec The tween.
+     * @return Identifier of the tween, never 0.
+     */
+    uint32_t start(TweenSpec);
+
+    /**
+     * @brief Stops a tween where it is, without calling its callback.
+     * @param tween_id Identifier returned by start().
+     * @return True if the tween was running.
+     */
+    bool cancel(uint32_t);
+
+    /**
+     * @brief Checks if a tween is still running.
+     * @param tween_id Identifier returned by start().
+     * @return True if running.
+     */
+    [[nodiscard]] bool isActive(uint32_t) const;
+
+    /**
+     * @brief Advances every tween.
+     * @param delta_ms Time since the previous update in milliseconds.
+     */
+    void update(float);
+
+    /**
+     * @brief Stops every tween without calling callbacks.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of running tweens.
+     * @return Number of tweens.
+     */
+    [[nodiscard]] std::size_t size() const;
+};
+
+} // namespace dino
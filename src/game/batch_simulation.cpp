@@ -0,0 +1,300 @@
+/**
+ * batch_simulation.cpp - Headless simulation instances stepped in lockstep
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "batch_simulation.hpp"
+
+namespace {
+
+/**
+ * @brief Derives the layout seed of an episode, SplitMix64 finaliser.
+ */
+unsigned int episodeSeed(uint64_t seed, int instance, uint32_t episode) {
+    uint64_t value = seed + (static_cast<uint64_t>(instance) << 32) + episode;
+
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    value = value ^ (value >> 31);
+
+    return static_cast<unsigned int>(value ^ (value >> 32));
+}
+
+} // namespace
+
+dino::BatchSimulation::BatchSimulation(const dino::WorldLayout& layout, const dino::BatchConfig& config) :
+        m_layout(layout),
+        m_config(config) {
+
+    if (config.instances < 1 || config.frameSkip < 1 || config.threads < 0 || config.maxEpisodeTicks < 0) {
+        throw std::runtime_error("Batch settings are out of range!");
+    }
+
+    auto instance_count = static_cast<std::size_t>(config.instances);
+
+    /* Sized once, the simulations keep pointers into the states. */
+    m_states.resize(instance_count);
+    m_episodes.assign(instance_count, 0);
+    m_episodeTicks.assign(instance_count, 0);
+    m_observations.assign(instance_count * DINO_BATCH_OBSERVATION_SIZE, 0.0f);
+    m_rewards.assign(instance_count, 0.0f);
+    m_dones.assign(instance_count, 0);
+
+    m_simulations = dino::CacheLineAllocator<dino::WorldSimulation>().allocate(instance_count);
+
+    int constructed = 0;
+
+    try {
+        for (; constructed < config.instances; constructed++) {
+            auto seed = episodeSeed(config.seed, constructed, 0);
+            new (&(m_simulations[constructed])) dino::WorldSimulation(layout, &(m_states[constructed]), seed);
+
+            observe_(constructed);
+        }
+
+    } catch (...) {
+        for (int instance = 0; instance < constructed; instance++) {
+            m_simulations[instance].~WorldSimulation();
+        }
+
+        dino::CacheLineAllocator<dino::WorldSimulation>().deallocate(m_simulations, instance_count);
+        throw;
+    }
+
+    /* No more threads than chunks, the rest would have nothing to do. */
+    int chunk_size   = getChunkSize();
+    int thread_count = config.threads > 0 ? config.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int chunk_count  = (config.instances + chunk_size - 1) / chunk_size;
+
+    thread_count = std::min(thread_count, chunk_count);
+
+    int chunks_per_range = chunk_count / thread_count;
+    int extra_chunks     = chunk_count % thread_count;
+    int next_start       = 0;
+
+    for (int range = 0; range < thread_count; range++) {
+        m_rangeStart.push_back(next_start);
+        next_start = next_start + (chunks_per_range + (range < extra_chunks ? 1 : 0)) * chunk_size;
+    }
+
+    m_rangeStart.push_back(config.instances);
+
+    /* The calling thread steps the first range itself. */
+    for (int range = 1; range < thread_count; range++) {
+        m_workers.push_back(new std::thread(&dino::BatchSimulation::workLoop_, this, range));
+    }
+}
+
+dino::BatchSimulation::~BatchSimulation() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+    }
+
+    m_startSignal.notify_all();
+
+    for (auto worker : m_workers) {
+        worker->join();
+        delete worker;
+    }
+
+    for (int instance = 0; instance < m_config.instances; instance++) {
+        m_simulations[instance].~WorldSimulation();
+    }
+
+    dino::CacheLineAllocator<dino::WorldSimulation>().deallocate(m_simulations, static_cast<std::size_t>(m_config.instances));
+}
+
+void dino::BatchSimulation::workLoop_(int range) {
+    uint64_t generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startSignal.wait(lock, [&] () { return !m_isRunning || m_generation != generation; });
+
+            if (!m_isRunning) {
+                return void();
+            }
+
+            generation = m_generation;
+        }
+
+        stepRange_(range);
+
+        bool is_last;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending--;
+            is_last = m_pending == 0;
+        }
+
+        if (is_last) {
+            m_doneSignal.notify_one();
+        }
+    }
+}
+
+void dino::BatchSimulation::stepRange_(int range) {
+    uint64_t ticks = 0;
+
+    for (int instance = m_rangeStart[range]; instance < m_rangeStart[range + 1]; instance++) {
+        auto& simulation = m_simulations[instance];
+        uint8_t action   = m_actions[instance];
+
+        float reward = 0.0f;
+        uint8_t done = 0;
+
+        for (int tick = 0; tick < m_config.frameSkip && done == 0; tick++) {
+            uint8_t events = simulation.step(action);
+            ticks++;
+
+            if ((events & dino::WorldSimulation::EVENT_COLLISION) != 0) {
+                reward = reward + m_config.collisionReward;
+                done = 1;
+                continue;
+            }
+
+            reward = reward + m_config.tickReward;
+            m_episodeTicks[instance]++;
+
+            if (m_config.maxEpisodeTicks > 0 && m_episodeTicks[instance] >= static_cast<uint32_t>(m_config.maxEpisodeTicks)) {
+                done = 1;
+            }
+        }
+
+        m_rewards[instance] = reward;
+        m_dones[instance]   = done;
+
+        if (done != 0) {
+            resetInstance_(instance);
+        }
+
+        observe_(instance);
+    }
+
+    m_tickCount.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+void dino::BatchSimulation::resetInstance_(int instance) {
+    m_episodes[instance]++;
+    m_episodeTicks[instance] = 0;
+
+    m_simulations[instance].reset(episodeSeed(m_config.seed, instance, m_episodes[instance]));
+}
+
+void dino::BatchSimulation::observe_(int instance) {
+    auto& state = m_states[instance];
+    float* observation = &(m_observations[static_cast<std::size_t>(instance) * DINO_BATCH_OBSERVATION_SIZE]);
+
+    int player_right = m_layout.playerX + m_layout.playerWidth;
+    int nearest      = m_layout.viewWidth;
+    int second       = m_layout.viewWidth;
+
+    /* Obstacles are not kept in order, keep the two closest that have not passed the player. */
+    state.obstacles.forEach([&] (dino::PoolHandle /* ignored */, dino::ObstacleEntity& obstacle) {
+        if (obstacle.posX + m_layout.obstacleWidth <= m_layout.playerX) {
+            return void();
+        }
+
+        int distance = std::max(obstacle.posX - player_right, 0);
+
+        if (distance < nearest) {
+            second  = nearest;
+            nearest = distance;
+
+        } else if (distance < second) {
+            second = distance;
+        }
+    });
+
+    float view_width = static_cast<float>(m_layout.viewWidth);
+
+    observation[0] = static_cast<float>(m_simulations[instance].getPlayer()->getLiftY()) / DINO_PLAYER_JUMP_HEIGHT;
+    observation[1] = state.player.isJumping != 0 ? state.player.jumpMs / DINO_PLAYER_JUMP_DURATION : 0.0f;
+    observation[2] = std::min(static_cast<float>(nearest) / view_width, 1.0f);
+    observation[3] = std::min(static_cast<float>(second) / view_width, 1.0f);
+}
+
+void dino::BatchSimulation::reset() {
+    for (int instance = 0; instance < m_config.instances; instance++) {
+        resetInstance_(instance);
+        observe_(instance);
+    }
+
+    std::fill(m_rewards.begin(), m_rewards.end(), 0.0f);
+    std::fill(m_dones.begin(), m_dones.end(), static_cast<uint8_t>(0));
+}
+
+void dino::BatchSimulation::step(const uint8_t* actions) {
+    m_actions = actions;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_generation++;
+        m_pending = static_cast<int>(m_workers.size());
+    }
+
+    m_startSignal.notify_all();
+    stepRange_(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneSignal.wait(lock, [this] () { return m_pending == 0; });
+}
+
+int dino::BatchSimulation::getInstanceCount() const {
+    return m_config.instances;
+}
+
+int dino::BatchSimulation::getThreadCount() const {
+    return static_cast<int>(m_rangeStart.size()) - 1;
+}
+
+const float* dino::BatchSimulation::getObservations() const {
+    return m_observations.data();
+}
+
+const float* dino::BatchSimulation::getRewards() const {
+    return m_rewards.data();
+}
+
+const uint8_t* dino::BatchSimulation::getDones() const {
+    return m_dones.data();
+}
+
+const dino::WorldState* dino::BatchSimulation::getState(int instance) const {
+    return &(m_states[instance]);
+}
+
+uint64_t dino::BatchSimulation::getTickCount() const {
+    return m_tickCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,350 @@
+/**
+ * batch_simulation.hpp - Headless simulation instances stepped in lockstep
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "world_simulation.hpp"
+
+/* Values in the observation of one instance, see BatchSimulation. */
+#define DINO_BATCH_OBSERVATION_SIZE 4
+
+/* Cache line size assumed when laying out the per instance arrays. */
+#define DINO_BATCH_CACHE_LINE 64
+
+namespace dino {
+
+/**
+ * @brief Settings of a batch of simulation instances.
+ */
+struct batch_config {
+    /**
+     * @brief Number of independent game instances.
+     */
+    int instances = 1;
+
+    /**
+     * @brief Threads stepping the instances, 0 uses every hardware thread.
+     *
+     * The calling thread is one of them.
+     */
+    int threads = 0;
+
+    /**
+     * @brief Ticks run per step with the same action held.
+     *
+     * Larger values spread the synchronisation of the threads
+     * over more ticks.
+     */
+    int frameSkip = 1;
+
+    /**
+     * @brief Ticks after which an episode is cut short, 0 for no limit.
+     */
+    int maxEpisodeTicks = 0;
+
+    /**
+     * @brief Seed of the whole batch, every episode of every instance gets its own layout from it.
+     */
+    uint64_t seed = 0;
+
+    /**
+     * @brief Reward for every tick survived.
+     */
+    float tickReward = 1.0f;
+
+    /**
+     * @brief Reward for the tick in which the player hits an obstacle.
+     */
+    float collisionReward = -100.0f;
+};
+
+typedef struct batch_config BatchConfig;
+
+/**
+ * @brief Allocates arrays that start on a cache line and fill their last one.
+ *
+ * No other allocation shares a cache line with the array, so a thread
+ * writing its own part of the array only contends with the threads
+ * writing the neighbouring parts.
+ */
+template <typename T>
+class CacheLineAllocator {
+
+public:
+    typedef T value_type;
+
+    CacheLineAllocator() = default;
+
+    template <typename U>
+    CacheLineAllocator(const CacheLineAllocator<U>&) noexcept {} // NOLINT(google-explicit-constructor)
+
+    T* allocate(std::size_t count) {
+        std::size_t bytes = (count * sizeof(T) + DINO_BATCH_CACHE_LINE - 1) / DINO_BATCH_CACHE_LINE * DINO_BATCH_CACHE_LINE;
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(DINO_BATCH_CACHE_LINE)));
+    }
+
+    void deallocate(T* pointer, std::size_t /* ignored */) noexcept {
+        ::operator delete(pointer, std::align_val_t(DINO_BATCH_CACHE_LINE));
+    }
+
+    template <typename U>
+    bool operator==(const CacheLineAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CacheLineAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+template <typename T>
+using CacheLineVector = std::vector<T, CacheLineAllocator<T>>;
+
+/**
+ * @brief Runs many headless games side by side for automated agents.
+ *
+ * Every instance is a WorldSimulation with its own WorldState, nothing
+ * is shared between instances and nothing is global, so any number of
+ * batches can live in one process. A step applies one action per
+ * instance and advances every instance in lockstep, the instances are
+ * split into contiguous ranges stepped by a pool of threads.
+ *
+ * The simulations and every per instance array are laid out
+ * contiguously from a cache line boundary, and every range starts at a
+ * multiple of getChunkSize(), so no two threads write the same line.
+ *
+ * Results are written to contiguous arrays indexed by instance, ready
+ * to be handed to an agent without copying:
+ *
+ * - Observations, DINO_BATCH_OBSERVATION_SIZE floats per instance:
+ *   height above the floor and progress of the jump, both 0 to 1, and
+ *   the distance to the next two obstacles ahead in view widths, 1 if
+ *   there is none.
+ * - Rewards, one float per instance, summed over the ticks of the step.
+ * - Done flags, set if the episode ended in the step.
+ *
+ * An instance whose episode ended is reset right away, its observation
+ * is the first one of the new episode.
+ */
+class BatchSimulation {
+
+private: /* ===-=== Private Members ===-=== */
+    WorldLayout m_layout;
+
+    BatchConfig m_config;
+
+    CacheLineVector<WorldState> m_states;
+
+    /**
+     * @brief The simulations side by side, constructed in place since they cannot be moved.
+     */
+    WorldSimulation* m_simulations = nullptr;
+
+    /**
+     * @brief Per instance, indexed like the states.
+     */
+    CacheLineVector<uint32_t> m_episodes;
+    CacheLineVector<uint32_t> m_episodeTicks;
+
+    CacheLineVector<float> m_observations;
+    CacheLineVector<float> m_rewards;
+    CacheLineVector<uint8_t> m_dones;
+
+    /**
+     * @brief Actions of the current step, read by every thread.
+     */
+    const uint8_t* m_actions = nullptr;
+
+    /**
+     * @brief First instance of every range, one range per thread plus the end.
+     */
+    std::vector<int> m_rangeStart;
+
+    std::vector<std::thread*> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_startSignal;
+    std::condition_variable m_doneSignal;
+
+    /**
+     * @brief Incremented for every step, workers run once per value.
+     */
+    uint64_t m_generation = 0;
+
+    /**
+     * @brief Workers that have not finished the current step.
+     */
+    int m_pending = 0;
+
+    bool m_isRunning = true;
+
+    std::atomic<uint64_t> m_tickCount {0};
+
+    /**
+     * @brief Returns the smallest number of elements that fill whole cache lines.
+     * @param size Size of an element in bytes.
+     * @return A power of two, so the largest of them is a multiple of all the others.
+     */
+    static constexpr std::size_t instancesPerLine_(std::size_t size) {
+        return DINO_BATCH_CACHE_LINE / std::gcd(size, static_cast<std::size_t>(DINO_BATCH_CACHE_LINE));
+    }
+
+    /**
+     * @brief Runs on a worker thread until the batch is destroyed.
+     * @param range Range of instances stepped by the worker.
+     */
+    void workLoop_(int);
+
+    /**
+     * @brief Steps a range of instances.
+     * @param range Range of instances.
+     */
+    void stepRange_(int);
+
+    /**
+     * @brief Starts the next episode of an instance.
+     * @param instance Index of the instance.
+     */
+    void resetInstance_(int);
+
+    /**
+     * @brief Writes the observation of an instance.
+     * @param instance Index of the instance.
+     */
+    void observe_(int);
+
+public: /* ===-=== Public Members ===-=== */
+    /**
+     * @brief Creates the instances and starts the threads.
+     * @param layout Sizes and positions shared by every instance.
+     * @param config Batch settings.
+     * @throw std::runtime_error Thrown if the settings are out of range.
+     */
+    BatchSimulation(const WorldLayout&, const BatchConfig&);
+
+    /**
+     * @brief Stops the threads and destroys the instances.
+     */
+    ~BatchSimulation();
+
+    BatchSimulation(const BatchSimulation&) = delete;
+
+    BatchSimulation& operator=(const BatchSimulation&) = delete;
+
+    /**
+     * @brief Starts a new episode in every instance.
+     *
+     * Episodes are counted on, so the layouts differ from the
+     * previous ones. Rewards and done flags are cleared.
+     */
+    void reset();
+
+    /**
+     * @brief Advances every instance by frameSkip ticks.
+     * @param actions One WorldSimulation::Input bit mask per instance.
+     *
+     * Returns once every instance has been stepped and the
+     * observation, reward and done arrays are up to date.
+     */
+    void step(const uint8_t*);
+
+    /**
+     * @brief Returns the number of instances.
+     * @return Instance count.
+     */
+    [[nodiscard]] int getInstanceCount() const;
+
+    /**
+     * @brief Returns the number of threads stepping the instances.
+     * @return Thread count, including the calling thread.
+     */
+    [[nodiscard]] int getThreadCount() const;
+
+    /**
+     * @brief Returns the granularity of the split across threads.
+     * @return Smallest number of instances that ends on a cache line in every per instance array.
+     *
+     * A batch runs on at most one thread per chunk.
+     */
+    static constexpr int getChunkSize() {
+        return static_cast<int>(std::max({
+            instancesPerLine_(sizeof(WorldState)),
+            instancesPerLine_(sizeof(WorldSimulation)),
+            instancesPerLine_(sizeof(uint32_t)),
+            instancesPerLine_(sizeof(float) * DINO_BATCH_OBSERVATION_SIZE),
+            instancesPerLine_(sizeof(float)),
+            instancesPerLine_(sizeof(uint8_t))
+        }));
+    }
+
+    /**
+     * @brief Returns the observations of every instance.
+     * @return DINO_BATCH_OBSERVATION_SIZE floats per instance.
+     */
+    [[nodiscard]] const float* getObservations() const;
+
+    /**
+     * @brief Returns the rewards of the last step.
+     * @return One float per instance.
+     */
+    [[nodiscard]] const float* getRewards() const;
+
+    /**
+     * @brief Returns the done flags of the last step.
+     * @return One flag per instance, 1 if its episode ended.
+     */
+    [[nodiscard]] const uint8_t* getDones() const;
+
+    /**
+     * @brief Returns the world state of an instance, for snapshots and inspection.
+     * @param instance Index of the instance.
+     * @return The state.
+     */
+    [[nodiscard]] const WorldState* getState(int) const;
+
+    /**
+     * @brief Returns the total number of ticks simulated by the batch.
+     * @return Tick count.
+     */
+    [[nodiscard]] uint64_t getTickCount() const;
+};
+
+} // namespace dino
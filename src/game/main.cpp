@@ -27,15 +27,37 @@
  * ========================================================================
  */
 
+#include <cstdlib>
+
 #include "platform/logger.hpp"
 #include "engine/except.hpp"
 #include "engine/engine_context.hpp"
+#include "engine/graphics_driver.hpp"
 #include "game/platformer.hpp"
 
 int main() {
+    /* Set DINO_BINARY_LOG to a path to log in binary, decode it with dino-logdecode. */
+    const char* binary_log = std::getenv("DINO_BINARY_LOG");
+
+    if (binary_log != nullptr && !dino::Logger::openBinaryLog(binary_log)) {
+        dino::Logger::warn("Unable to open binary log", binary_log);
+    }
+
     dino::EngineContext::initialise();
     dino::Logger::info("Starting Dino Platformer!");
 
+    /* Set DINO_DISPLAY to a display index to play on a display other than the primary. */
+    const char* display_index = std::getenv("DINO_DISPLAY");
+
+    if (display_index != nullptr) {
+        try {
+            dino::GraphicsDriver::selectDisplay(std::atoi(display_index));
+
+        } catch (dino::EngineError& error) {
+            dino::Logger::warn(error.what(), display_index);
+        }
+    }
+
     dino::Platformer* platformer;
 
     try {
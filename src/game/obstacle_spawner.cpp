@@ -0,0 +1,93 @@
+/**
+ * obstacle_spawner.cpp - Procedural obstacle layout generator
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include "obstacle_spawner.hpp"
+
+dino::ObstacleSpawner::ObstacleSpawner(const dino::SpawnRules& rules, dino::SpawnerState* state, unsigned int seed) :
+        m_rules(rules),
+        m_state(state) {
+
+    m_rules.maxGap = std::max(m_rules.minGap, m_rules.maxGap);
+    reset(seed);
+}
+
+void dino::ObstacleSpawner::reset(unsigned int seed) {
+    *m_state = dino::SpawnerState {};
+    m_state->randomState = seed;
+
+    generateChunk_();
+}
+
+int dino::ObstacleSpawner::nextGap_() {
+    m_state->randomState = m_state->randomState + 0x9E3779B97F4A7C15ULL;
+
+    uint64_t value = m_state->randomState;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    value = value ^ (value >> 31);
+
+    /* Scales the top 32 bits into the range without a division. */
+    auto range = static_cast<uint64_t>(m_rules.maxGap - m_rules.minGap) + 1;
+    return m_rules.minGap + static_cast<int>(((value >> 32) * range) >> 32);
+}
+
+void dino::ObstacleSpawner::generateChunk_() {
+    for (int count = 0; count < CHUNK_SIZE && m_state->queueSize < DINO_SPAWNER_QUEUE_CAPACITY; count++) {
+        m_state->horizon = m_state->horizon + nextGap_();
+
+        m_state->queue[(m_state->queueHead + m_state->queueSize) % DINO_SPAWNER_QUEUE_CAPACITY] = m_state->horizon;
+        m_state->queueSize++;
+    }
+}
+
+void dino::ObstacleSpawner::advance(int distance) {
+    m_state->distance = m_state->distance + distance;
+
+    if (m_state->horizon - m_state->distance < m_rules.lookahead) {
+        generateChunk_();
+    }
+}
+
+bool dino::ObstacleSpawner::poll(int& overshoot) {
+    if (m_state->queueSize == 0 || m_state->queue[m_state->queueHead] > m_state->distance) {
+        return false;
+    }
+
+    overshoot = static_cast<int>(m_state->distance - m_state->queue[m_state->queueHead]);
+
+    m_state->queueHead = (m_state->queueHead + 1) % DINO_SPAWNER_QUEUE_CAPACITY;
+    m_state->queueSize--;
+
+    return true;
+}
+
+const dino::SpawnRules* dino::ObstacleSpawner::getRules() const {
+    return &m_rules;
+}
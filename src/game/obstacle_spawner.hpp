@@ -0,0 +1,171 @@
+/**
+ * obstacle_spawner.hpp - Procedural obstacle layout generator
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Upcoming obstacle positions the spawner can hold. */
+#define DINO_SPAWNER_QUEUE_CAPACITY 32
+
+namespace dino {
+
+/**
+ * @brief Rules the obstacle layout must honour.
+ *
+ * All distances are measured in pixels of floor scrolled,
+ * never in frames or seconds.
+ */
+struct spawn_rules {
+    /**
+     * @brief Smallest gap between two obstacles.
+     *
+     * Must be at least the length of a full jump arc so that
+     * the player can land before the next obstacle arrives.
+     */
+    int minGap = 0;
+
+    /**
+     * @brief Largest gap between two obstacles.
+     */
+    int maxGap = 0;
+
+    /**
+     * @brief How far ahead of the camera the layout is generated.
+     */
+    int lookahead = 0;
+};
+
+typedef struct spawn_rules SpawnRules;
+
+/**
+ * @brief Everything the spawner changes, kept as plain data so it can be copied as bytes.
+ */
+struct spawner_state {
+    /**
+     * @brief State of the layout generator, SplitMix64.
+     */
+    uint64_t randomState = 0;
+
+    /**
+     * @brief Total floor distance scrolled since the last reset.
+     */
+    int64_t distance = 0;
+
+    /**
+     * @brief Floor distance up to which the layout is generated.
+     */
+    int64_t horizon = 0;
+
+    /**
+     * @brief Ring of upcoming obstacle positions in floor distance.
+     */
+    int64_t queue[DINO_SPAWNER_QUEUE_CAPACITY] = {};
+
+    int32_t queueHead = 0;
+    int32_t queueSize = 0;
+};
+
+typedef struct spawner_state SpawnerState;
+
+/**
+ * @brief Generates the obstacle layout ahead of the camera.
+ *
+ * Obstacle positions are generated in chunks and stored as absolute
+ * floor distances. The camera reports how far it has scrolled and the
+ * spawner hands out every obstacle whose position has been reached.
+ * Since the layout depends only on the scrolled distance, the obstacle
+ * density is the same at any frame rate.
+ *
+ * The spawner keeps no state of its own, it works on a SpawnerState
+ * owned by the caller. The generator is implemented here rather than
+ * taken from <random>, so a seed gives the same layout on every
+ * standard library.
+ */
+class ObstacleSpawner {
+
+private: /* ===-=== Private Members ===-=== */
+    static constexpr int CHUNK_SIZE = 8;
+
+    SpawnRules m_rules;
+
+    SpawnerState* m_state;
+
+    /**
+     * @brief Draws the gap to the next obstacle.
+     * @return Gap between minGap and maxGap.
+     */
+    int nextGap_();
+
+    /**
+     * @brief Appends a chunk of obstacle positions to the queue.
+     */
+    void generateChunk_();
+
+public: /* ===-=== Public Members ===-=== */
+    /**
+     * @brief Initialises the spawner and resets its state.
+     * @param rules Layout rules.
+     * @param state State to work on, must outlive the spawner.
+     * @param seed Seed for the layout generator.
+     */
+    ObstacleSpawner(const SpawnRules&, SpawnerState*, unsigned int);
+
+    /**
+     * @brief Discards the current layout and starts over.
+     * @param seed Seed for the layout generator.
+     */
+    void reset(unsigned int);
+
+    /**
+     * @brief Reports the distance the camera moved in this tick.
+     * @param distance Scrolled distance in pixels.
+     *
+     * A new chunk is generated only when the remaining layout
+     * falls below the lookahead distance, so the generation cost
+     * is spread over many ticks.
+     */
+    void advance(int);
+
+    /**
+     * @brief Pulls the next obstacle that is due.
+     * @param overshoot Receives how far the camera has already
+     *                  scrolled past the obstacle position.
+     * @return True if an obstacle is due, false otherwise.
+     */
+    bool poll(int&);
+
+    /**
+     * @brief Returns the layout rules.
+     * @return The layout rules.
+     */
+    [[nodiscard]] const SpawnRules* getRules() const;
+};
+
+} // namespace dino
@@ -27,181 +27,292 @@
  * ========================================================================
  */
 
-#include <cmath>
+#include <algorithm>
+#include <cstdlib>
 #include "platform/filesystem.hpp"
+#include "platform/memory_tracker.hpp"
+#include "platform/logger.hpp"
 #include "engine/except.hpp"
 #include "engine/graphics_driver.hpp"
 #include "engine/engine_context.hpp"
 #include "platformer.hpp"
 
-#if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
-#include "platform/logger.hpp"
-#endif
-
-dino::Platformer::Platformer() : m_lastObstacle(0) {
+dino::Platformer::Platformer() {
     if (!dino::EngineContext::isInitialised()) {
         throw std::runtime_error("Engine context is not initialised!");
     }
 
+    dino::MemoryScope memory_scope(dino::MemoryTracker::GAME);
+
     auto capabilities = dino::GraphicsDriver::getDisplayCaps();
 
-    m_window     = new dino::TargetWindow("Crazy Dino", capabilities->screenWidth, capabilities->screenHeight);
+    m_window     = new dino::TargetWindow("Crazy Dino", capabilities->screenWidth, capabilities->screenHeight, capabilities->displayIndex);
     m_renderer   = dino::EngineContext::createRenderer(m_window);
     m_audioMixer = dino::EngineContext::createMixer();
 
+    m_renderer->setLogicalSize(DINO_LOGICAL_WIDTH, DINO_LOGICAL_HEIGHT, dino::Renderer::SCALE_LINEAR);
+
+    /* Hold the refresh rate of the display, drawing up to its native resolution when there is time. */
+    dino::ResolutionRules resolution_rules {};
+    resolution_rules.budgetMs = 1000.0f / static_cast<float>(capabilities->refreshRate > 0 ? capabilities->refreshRate : DINO_DEFAULT_REFRESH_RATE);
+    resolution_rules.maxScale = std::clamp(static_cast<float>(capabilities->screenHeight) / DINO_LOGICAL_HEIGHT, 1.0f, DINO_MAX_RENDER_SCALE);
+
+    m_renderer->setDynamicResolution(&resolution_rules);
+
+    m_viewWidth  = m_renderer->getWidth();
+    m_viewHeight = m_renderer->getHeight();
+
     m_baseTiles  = new std::vector<dino::SpriteMaterial*>();
     m_worldScene = new std::vector<dino::SpriteMaterial*>();
-    m_obstacles  = new std::vector<dino::SpriteMaterial*>();
-    m_residual   = new std::queue<dino::SpriteMaterial*>();
+    m_world      = new dino::WorldState();
+    m_startState = new dino::WorldState();
 
-    m_dinoSprite = m_renderer->loadSprite(dino::Filesystem::resource("texture", "dino-sprite-map.png"));
+    m_frameArena = new dino::FrameArena(DINO_FRAME_ARENA_SIZE);
+    m_tweens     = new dino::TweenSystem();
 
-    m_audioMixer->loadLoopAudio(dino::Filesystem::resource("audio", "game-bgm-score.mp3"));
-    m_audioMixer->loadEffectAudio(0, dino::Filesystem::resource("audio", "cartoon-jump.wav"));
-}
+    m_spriteBatch = new dino::SpriteBatch(DINO_FRAME_SPRITES, m_frameArena->getResource());
 
-void dino::Platformer::createWorld() {
-    auto base_tile = m_renderer->loadSprite(dino::Filesystem::resource("texture", "base-tile-01.png"));
+    /* Files in the pack shadow the loose ones, which stay available for hot reload. */
+    m_filesystem = new dino::VirtualFilesystem();
+    m_filesystem->mountDirectory(dino::Filesystem::dirname());
+    m_filesystem->mountPack(dino::Filesystem::dirname() + DINO_ASSET_PACK);
 
-    int next_x = 0;
-    int next_y = m_window->height - base_tile->getHeight();
+    /* Set DINO_HOT_RELOAD to pick up changes to textures and audio while the game runs. */
+    if (std::getenv("DINO_HOT_RELOAD") != nullptr) {
+        m_assetReloader = new dino::AssetReloader();
+    }
 
-    base_tile->setAttachment(next_x, next_y);
+    m_dinoSprite = loadTexture("dino-sprite-map.png");
 
-    int sprite_count = m_window->width / base_tile->getWidth();
+    /* A BGM converted to a streamed WAVE file takes precedence over the original MP3. */
+    auto loop_audio = m_filesystem->intern("audio/game-bgm-score.wav");
+    loop_audio      = m_filesystem->exists(loop_audio) ? loop_audio : findAsset("audio/game-bgm-score.mp3");
+    auto jump_audio = findAsset("audio/cartoon-jump.wav");
+
+    auto loop_file = m_filesystem->getRealPath(loop_audio);
+    auto jump_file = m_filesystem->getRealPath(jump_audio);
+
+    /* The BGM is streamed, a loose one from disk and a packed one in place from the mapped pack. */
+    if (!loop_file.empty()) {
+        m_audioMixer->loadLoopAudio(loop_file);
+    } else {
+        m_audioMixer->loadLoopAudio(m_filesystem->read(loop_audio));
+    }
+
+    m_audioMixer->loadEffectAudio(DINO_EFFECT_JUMP, m_filesystem->read(jump_audio), 1, 2);
+
+    m_filesystem->release(loop_audio);
+    m_filesystem->release(jump_audio);
+
+    if (m_assetReloader != nullptr && !loop_file.empty()) {
+        m_assetReloader->watchMusic(m_audioMixer, loop_file);
+    }
+
+    if (m_assetReloader != nullptr && !jump_file.empty()) {
+        m_assetReloader->watchEffect(m_audioMixer, DINO_EFFECT_JUMP, jump_file);
+    }
+}
+
+void dino::Platformer::createWorld() {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::GAME);
+
+    auto base_tile   = loadTexture("base-tile-01.png");
+    auto world_scene = loadTexture("world-bg.png");
+    m_obstacleSprite = loadTexture("obstacle-type-01.png");
+
+    int floor_y = m_viewHeight - base_tile->getHeight();
+
+    dino::WorldLayout layout {};
+    layout.viewWidth      = m_viewWidth;
+    layout.tileWidth      = base_tile->getWidth();
+    layout.sceneWidth     = world_scene->getWidth();
+    layout.playerX        = 100;
+    layout.playerY        = floor_y - m_dinoSprite->getHeight();
+    layout.playerWidth    = DINO_SPRITE_CLIP_WIDTH;
+    layout.playerHeight   = m_dinoSprite->getHeight();
+    layout.obstacleY      = floor_y - m_obstacleSprite->getHeight();
+    layout.obstacleWidth  = m_obstacleSprite->getWidth();
+    layout.obstacleHeight = m_obstacleSprite->getHeight();
+
+    m_simulation = new dino::WorldSimulation(layout, m_world, dino::SystemClock::unixTimestamp());
+
+    /* Sprites keep their Y, the state holds everything that moves. */
+    base_tile->setAttachment(m_world->floorX[0], floor_y);
     m_baseTiles->push_back(base_tile);
 
-    while (sprite_count >= 0) {
+    for (int32_t index = 1; index < m_world->floorCount; index++) {
         auto next_tile = base_tile->clone();
-        next_x = next_x + next_tile->getWidth();
 
-        next_tile->setAttachment(next_x, next_y);
+        next_tile->setAttachment(m_world->floorX[index], floor_y);
         m_baseTiles->push_back(next_tile);
-
-        sprite_count--;
     }
 
-    auto world_scene =  m_renderer->loadSprite(dino::Filesystem::resource("texture", "world-bg.png"));
-
-    sprite_count = m_window->width / world_scene->getWidth();
-    next_x = 0;
-    next_y = m_window->height - base_tile->getHeight() - world_scene->getHeight();
+    int scene_y = floor_y - world_scene->getHeight();
 
-    world_scene->setAttachment(next_x, next_y);
+    world_scene->setAttachment(m_world->sceneX[0], scene_y);
     m_worldScene->push_back(world_scene);
 
-    while (sprite_count >= 0) {
+    for (int32_t index = 1; index < m_world->sceneCount; index++) {
         auto next_scene = world_scene->clone();
-        next_x = next_x + next_scene->getWidth();
 
-        next_scene->setAttachment(next_x, next_y);
+        next_scene->setAttachment(m_world->sceneX[index], scene_y);
         m_worldScene->push_back(next_scene);
+    }
+
+    m_dinoSprite->setAttachment(layout.playerX, layout.playerY, layout.playerWidth, layout.playerHeight);
+    m_dinoSprite->setScissor(0, 0, DINO_SPRITE_CLIP_WIDTH, m_dinoSprite->getHeight());
+
+    m_sceneCache = m_renderer->createTarget(m_viewWidth, m_viewHeight);
+
+    saveWorld(m_startState);
 
-        sprite_count--;
+    if (m_assetReloader != nullptr && !m_assetReloader->start()) {
+        dino::Logger::warn("Hot reload is not available on this platform.");
     }
+}
+
+dino::SpriteMaterial* dino::Platformer::loadTexture(const std::string& file) {
+    auto image_name = "texture/" + file;
+    auto raw_name   = image_name.substr(0, image_name.rfind('.')) + DINO_RAW_IMAGE_EXTENSION;
+
+    /* A raw image written by dino-pack is uploaded without decoding. */
+    auto path_id  = m_filesystem->intern(raw_name);
+    path_id       = m_filesystem->exists(path_id) ? path_id : findAsset(image_name);
+    auto material = m_renderer->loadSprite(m_filesystem->read(path_id));
 
-    auto obstacle = m_renderer->loadSprite(dino::Filesystem::resource("texture", "obstacle-type-01.png"));
-    obstacle->setAttachment(m_window->width, m_window->height - base_tile->getHeight() - obstacle->getHeight());
-    m_obstacles->push_back(obstacle);
+    /* The texture holds the pixels now. */
+    m_filesystem->release(path_id);
 
-    m_lastObstacle = dino::SystemClock::unixTimestamp();
+    auto image_file = m_filesystem->getRealPath(m_filesystem->intern(image_name));
 
-    for (int count = 0; count < 5; count++) {
-        m_obstacles->push_back(obstacle->clone());
+    if (m_assetReloader != nullptr && !image_file.empty()) {
+        m_assetReloader->watchTexture(material, image_file);
     }
 
-    m_dinoSprite->setAttachment(100,
-            m_window->height - base_tile->getHeight() - m_dinoSprite->getHeight(),
-            DINO_SPRITE_CLIP_WIDTH,
-            m_dinoSprite->getHeight());
+    return material;
+}
 
-    m_dinoSprite->setScissor(0, 0, DINO_SPRITE_CLIP_WIDTH, m_dinoSprite->getHeight());
+dino::PathId dino::Platformer::findAsset(const std::string& name) {
+    auto path_id = m_filesystem->intern(name);
 
-    m_animateThread = new std::thread(&dino::Platformer::animateSprite, this);
-    m_animateThread->detach();
+    if (!m_filesystem->exists(path_id)) {
+        throw std::runtime_error("Asset " + name + " is missing!");
+    }
+
+    return path_id;
 }
 
 void dino::Platformer::reloadWorld() {
-    int next_x = 0;
-    int next_y = m_window->height - m_baseTiles->at(0)->getHeight();
-
-    m_dinoSprite->setAttachment(100, next_y - m_dinoSprite->getHeight());
+    restoreWorld(*m_startState);
 
-    /* Re-position base tiles. */
-    for (auto sprite : *m_baseTiles){
-        sprite->setAttachment(next_x, next_y);
-        next_x = next_x + sprite->getWidth();
-    }
+    /* Every game gets a new obstacle layout. */
+    m_simulation->reseed(dino::SystemClock::unixTimestamp());
+}
 
-    /* Re-position obstacles. */
-    for (auto sprite : *m_obstacles){
-        sprite->setAttachment(m_window->width, sprite->getPositionY());
-    }
+void dino::Platformer::saveWorld(dino::WorldState* snapshot) const {
+    *snapshot = *m_world;
+}
 
-    while (!m_residual->empty()) {
-        m_residual->pop();
-    }
+void dino::Platformer::restoreWorld(const dino::WorldState& snapshot) {
+    *m_world = snapshot;
+    m_isSceneCached = false;
 }
 
 void dino::Platformer::run() {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::GAME);
     m_audioMixer->playLoopAudio();
 
-    while (m_isRunning) {
-        auto event = dino::EngineContext::pollEvent();
+    uint64_t last_counter = SDL_GetPerformanceCounter();
 
-        switch (event.kind) {
-            case dino::EngineContext::Event::PROCESS_QUIT:
-            case dino::EngineContext::Event::KEY_PRESS_Q:
-            case dino::EngineContext::Event::WINDOW_CLOSE:
-                m_isRunning = false;
-                break;
+    while (m_isRunning) {
+        uint64_t counter = SDL_GetPerformanceCounter();
+        auto delta_ms = static_cast<float>(1000.0 * static_cast<double>(counter - last_counter) / static_cast<double>(SDL_GetPerformanceFrequency()));
+        last_counter = counter;
 
-            case dino::EngineContext::Event::KEY_PRESS_R:
-                if (m_isGameOver) {
-                    this->m_renderer->blindScreen();
-                    this->reloadWorld();
-                    this->m_audioMixer->playLoopAudio();
+        m_frameArena->beginFrame();
+        dino::MemoryTracker::beginFrame();
+        m_frameCount++;
 
-                    m_isGameOver = false;
-                }
-                break;
+#if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
+        if (m_frameArena->getLastStats()->overflowAllocations > 0) {
+            DINO_LOG(dino::Logger::DEBUG, "Frame arena overflowed, {} heap allocations.", m_frameArena->getLastStats()->overflowAllocations);
+        }
 
-            case dino::EngineContext::Event::KEY_PRESS_UP:
-                if (!m_isGameOver && m_positionMutex.try_lock()) {
-                    delete m_positionThread;
+        if (m_frameCount % DINO_STATS_REPORT_INTERVAL == 0) {
+            auto mixer_stats = m_audioMixer->getStats();
 
-                    int pos_x = m_dinoSprite->getPositionX();
-                    int pos_y = m_window->height - m_baseTiles->at(0)->getHeight() - m_dinoSprite->getHeight();
+            DINO_LOG(dino::Logger::DEBUG, "Mixer callback took {} ms, peak {} ms, budget {} ms, stream underruns {}, dropped commands {}.",
+                    mixer_stats.lastCallbackMs, mixer_stats.peakCallbackMs, mixer_stats.bufferMs, mixer_stats.streamUnderruns,
+                    mixer_stats.droppedCommands);
 
-                    m_positionThread = new std::thread(&dino::Platformer::movePlayer, this, pos_x, pos_y);
-                    m_positionThread->detach();
+            if (dino::MemoryTracker::isEnabled()) {
+                dino::MemoryTracker::printReport();
+            }
+        }
+#endif
 
-                    m_audioMixer->playEffectAudio(0);
-                }
+        std::pmr::vector<dino::EngineContext::Event> events {m_frameArena->getResource()};
+        dino::EngineContext::pollEvents(&events);
 
-                break;
+        for (auto& event : events) {
+            handleEvent(event);
+        }
 
-            default:
-                break;
+        /* Between two frames nothing is drawing with the textures being replaced. */
+        if (m_assetReloader != nullptr) {
+            m_assetReloader->apply();
         }
 
-        m_renderer->clear();
+        stepWorld(delta_ms);
+        m_tweens->update(delta_ms);
 
-        if (!m_isGameOver) {
-            moveCamera();
-            placeObstacles();
-        }
+        m_renderer->begin();
+        updatePlayer();
+
+        m_spriteBatch->clear();
+        drawScene();
 
-        m_renderer->draw(m_worldScene);
-        m_renderer->draw(m_baseTiles);
-        m_renderer->draw(m_obstacles);
-        m_renderer->draw(m_dinoSprite);
+        m_spriteBatch->add(m_dinoSprite, DINO_LAYER_PLAYER);
+        m_renderer->draw(m_spriteBatch);
+        fadeScene();
 
         m_renderer->commit();
     }
 }
 
+void dino::Platformer::handleEvent(const dino::EngineContext::Event& event) {
+    switch (event.kind) {
+        case dino::EngineContext::Event::PROCESS_QUIT:
+        case dino::EngineContext::Event::KEY_PRESS_Q:
+        case dino::EngineContext::Event::WINDOW_CLOSE:
+            m_isRunning = false;
+            break;
+
+        case dino::EngineContext::Event::KEY_PRESS_R:
+            if (m_world->isGameOver != 0 && !m_isFading) {
+                startFade();
+            }
+            break;
+
+        case dino::EngineContext::Event::KEY_PRESS_UP:
+            m_pendingInput = m_pendingInput | dino::WorldSimulation::INPUT_JUMP;
+            break;
+
+        default:
+            break;
+    }
+}
+
 dino::Platformer::~Platformer() {
+    /* The mixer outlives the game, its BGM may still read the pack. */
+    m_audioMixer->unloadLoopAudio();
+
+    delete m_assetReloader;
+    delete m_filesystem;
+    delete m_simulation;
+    delete m_tweens;
+    delete m_spriteBatch;
+
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
     dino::Logger::debug("Cleaning up base tile sprites.");
 #endif
@@ -217,11 +328,10 @@ dino::Platformer::~Platformer() {
     }
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
-    dino::Logger::debug("Cleaning up obstacle sprites.");
+    dino::Logger::debug("Cleaning up obstacle sprite.");
 #endif
-    for (auto sprite : *m_obstacles) {
-        delete sprite;
-    }
+    delete m_obstacleSprite;
+    delete m_sceneCache;
 
 #if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
     dino::Logger::debug("Cleaning up player sprite.");
@@ -231,150 +341,120 @@ dino::Platformer::~Platformer() {
     SDL_DestroyWindow(m_window->window);
 
     m_baseTiles->clear();
-    m_obstacles->clear();
     m_worldScene->clear();
 
     delete m_window;
     delete m_baseTiles;
     delete m_worldScene;
-    delete m_obstacles;
+    delete m_world;
+    delete m_startState;
 
-    delete m_residual;
-    delete m_animateThread;
+    delete m_frameArena;
 }
 
-int dino::Platformer::moveCamera() {
-    for (auto sprite : *m_baseTiles) {
-        int pos_x = sprite->getPositionX();
-        int pos_y = sprite->getPositionY();
-
-        pos_x = pos_x - DINO_FLOOR_SCROLL_VELOCITY;
-
-        if (pos_x <= 0 - sprite->getWidth()) {
-            pos_x = static_cast<int>(m_baseTiles->size() - 1) * sprite->getWidth() - 15;
-        }
-
-        sprite->setAttachment(pos_x, pos_y);
-    }
-
-    for (auto sprite : *m_worldScene) {
-        int pos_x = sprite->getPositionX();
-        int pos_y = sprite->getPositionY();
-
-        pos_x = pos_x - DINO_WORLD_SCROLL_VELOCITY;
+void dino::Platformer::stepWorld(float delta_ms) {
+    m_tickBacklog = std::min(m_tickBacklog + delta_ms, dino::WorldSimulation::TICK_MS * DINO_MAX_TICKS_PER_FRAME);
 
-        if (pos_x <= 0 - sprite->getWidth()) {
-            pos_x = static_cast<int >(m_worldScene->size() - 1) * sprite->getWidth();
-        }
-
-        sprite->setAttachment(pos_x, pos_y);
-    }
-
-    int player_distance, player_elevation;
-
-    for (auto sprite : *m_obstacles) {
-        int pos_x = sprite->getPositionX();
-        int pos_y = sprite->getPositionY();
-
-        if (pos_x <= 0 - sprite->getWidth()) {
-            if (pos_x <= 0 - sprite->getWidth() - 30) {
-                continue;
-            }
+    while (m_tickBacklog >= dino::WorldSimulation::TICK_MS) {
+        m_tickBacklog = m_tickBacklog - dino::WorldSimulation::TICK_MS;
 
-            pos_x = 0 - sprite->getWidth() - 30;
+        uint8_t events = m_simulation->step(m_pendingInput);
+        m_pendingInput = dino::WorldSimulation::INPUT_NONE;
 
-            sprite->setAttachment(pos_x, pos_y);
-            m_residual->push(sprite);
-
-            continue;
-        } else {
-            pos_x = pos_x - DINO_FLOOR_SCROLL_VELOCITY;
+        if ((events & dino::WorldSimulation::EVENT_JUMP) != 0) {
+            m_audioMixer->playEffectAudio(DINO_EFFECT_JUMP);
         }
 
-        /* Collision detection. */
-        player_distance  = pos_x - m_dinoSprite->getPositionX();
-        player_elevation = m_dinoSprite->getPositionY() + (m_dinoSprite->getHeight() - 100);
-
-        if (player_distance > 0 && player_distance < DINO_SPRITE_CLIP_WIDTH && player_elevation > sprite->getPositionY()) {
-            m_isGameOver = true;
+        if ((events & dino::WorldSimulation::EVENT_COLLISION) != 0) {
             m_audioMixer->pauseLoopAudio();
         }
-
-        sprite->setAttachment(pos_x, pos_y);
     }
+}
+
+void dino::Platformer::updatePlayer() {
+    auto player = m_simulation->getPlayer();
 
-    return 0;
+    m_dinoSprite->setScissor(player->getClipX(), 0);
+    m_dinoSprite->setAttachment(m_dinoSprite->getPositionX(), m_simulation->getLayout()->playerY - player->getLiftY());
 }
 
-void dino::Platformer::movePlayer(int pos_x, int pos_y) {
-    if (m_isGameOver) {
-        m_positionMutex.unlock();
+void dino::Platformer::drawScene() {
+    if (m_world->isGameOver != 0 && m_isSceneCached) {
+        m_spriteBatch->add(m_sceneCache, DINO_LAYER_WORLD);
         return void();
     }
 
-    float radians = 0;
-
-#if defined (DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
-    while (radians <= M_PI) {
+    /* The background is the largest layer, it goes first when the frame is still too slow. */
+    if (m_world->isGameOver != 0 || !m_renderer->getResolution()->isReduced()) {
+        for (int32_t index = 0; index < m_world->sceneCount; index++) {
+            auto sprite = m_worldScene->at(index);
 
-#elif defined (DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1 
-    while (radians <= M_PIf) {
-#endif // DINO_OS_TYPE_WINDOWS or DINO_OS_TYPE_LINUX
+            sprite->setAttachment(m_world->sceneX[index], sprite->getPositionY());
+            m_spriteBatch->add(sprite, DINO_LAYER_WORLD);
+        }
+    }
 
-        int next_y = pos_y - static_cast<int>(450.0f * std::sin(radians));
-        m_dinoSprite->setAttachment(pos_x, next_y);
-        radians = radians + 0.01f;
+    for (int32_t index = 0; index < m_world->floorCount; index++) {
+        auto sprite = m_baseTiles->at(index);
 
-        SDL_Delay(2);
+        sprite->setAttachment(m_world->floorX[index], sprite->getPositionY());
+        m_spriteBatch->add(sprite, DINO_LAYER_FLOOR);
     }
 
-    m_positionMutex.unlock();
-    return void();
-}
-
-bool dino::Platformer::placeObstacles() {
+    /* Instances are copied, so one material serves every obstacle. */
+    m_world->obstacles.forEach([this] (dino::PoolHandle /* ignored */, dino::ObstacleEntity& obstacle) {
+        m_obstacleSprite->setAttachment(obstacle.posX, obstacle.posY);
+        m_spriteBatch->add(m_obstacleSprite, DINO_LAYER_OBSTACLE);
+    });
 
-    /* Attempt to place only if there is at least 2
-     * sprite materials in the residual queue. */
-    if (m_residual->size() <= 1) {
-        return false;
-    }
+    /* Freeze the scene without the player, which keeps animating over it. */
+    if (m_world->isGameOver != 0) {
+        m_renderer->setTarget(m_sceneCache);
+        m_renderer->clear();
+        m_renderer->draw(m_spriteBatch);
+        m_renderer->setTarget(nullptr);
 
-    /* There should be at least 2 seconds gap between placing obstacles. */
-    auto timestamp= dino::SystemClock::unixTimestamp();
+        m_spriteBatch->clear();
+        m_spriteBatch->add(m_sceneCache, DINO_LAYER_WORLD);
 
-    if (timestamp - m_lastObstacle < 1) {
-        return false;
+        m_isSceneCached = true;
     }
+}
 
-    /* Use random numbers to randomly place obstacles. */
-    unsigned int random_num = dino::SystemClock::randomInteger();
+void dino::Platformer::startFade() {
+    m_isFading = true;
 
-    if (random_num % 100 == 0) {
-        m_lastObstacle = timestamp;
+    dino::TweenSpec fade_out;
+    fade_out.target   = &m_fadeAlpha;
+    fade_out.from     = 0.0f;
+    fade_out.to       = 255.0f;
+    fade_out.duration = DINO_FADE_DURATION / 2.0f;
+    fade_out.easing   = dino::TweenSystem::EASE_IN_OUT_SINE;
 
-        auto obstacle = m_residual->front();
-        m_residual->pop();
+    /* Fully dark, restart behind the overlay and fade the new game in. */
+    fade_out.onComplete = [this] () {
+        reloadWorld();
+        m_audioMixer->playLoopAudio();
 
-        if (obstacle != nullptr) {
-            obstacle->setAttachment(m_window->width, obstacle->getPositionY());
-        }
-    }
+        dino::TweenSpec fade_in;
+        fade_in.target   = &m_fadeAlpha;
+        fade_in.from     = 255.0f;
+        fade_in.to       = 0.0f;
+        fade_in.duration = DINO_FADE_DURATION / 2.0f;
+        fade_in.easing   = dino::TweenSystem::EASE_IN_OUT_SINE;
 
-    return true;
-}
+        fade_in.onComplete = [this] () {
+            m_isFading = false;
+        };
 
-void dino::Platformer::animateSprite() {
-    while (this->m_isRunning) {
-        int clip_x = m_isGameOver ?
-                DINO_SPRITE_CLIP_WIDTH * 6 :
-                     m_dinoSprite->getScissorX() + DINO_SPRITE_CLIP_WIDTH;
+        m_tweens->start(std::move(fade_in));
+    };
 
-        clip_x = (!m_isGameOver && clip_x >= DINO_SPRITE_CLIP_WIDTH * 6) ? 0 : clip_x;
+    m_tweens->start(std::move(fade_out));
+}
 
-        m_dinoSprite->setScissor(clip_x, 0);
-        SDL_Delay(70);
+void dino::Platformer::fadeScene() {
+    if (m_isFading) {
+        m_renderer->drawOverlay(0x7D, 0x44, 0x44, static_cast<uint8_t>(std::clamp(m_fadeAlpha, 0.0f, 255.0f)));
     }
-
-    return void();
 }
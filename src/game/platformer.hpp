@@ -30,17 +30,55 @@
 #pragma once
 
 #include <vector>
-#include <queue>
-#include <thread>
-#include <mutex>
+#include <memory_resource>
 #include "platform/system_clock.hpp"
+#include "platform/virtual_filesystem.hpp"
 #include "engine/renderer.hpp"
+#include "engine/asset_reloader.hpp"
 #include "engine/audio_mixer.hpp"
+#include "engine/engine_context.hpp"
+#include "engine/frame_arena.hpp"
+#include "engine/tween_system.hpp"
+#include "world_simulation.hpp"
 
-#define DINO_FLOOR_SCROLL_VELOCITY 5
-#define DINO_WORLD_SCROLL_VELOCITY 1
 #define DINO_SPRITE_CLIP_WIDTH 262
 
+#define DINO_EFFECT_JUMP 0
+
+/* Asset pack next to the binary, served before the texture and audio directories. */
+#define DINO_ASSET_PACK "assets.pak"
+
+/* Sprite batch layers, back to front. */
+#define DINO_LAYER_WORLD 0
+#define DINO_LAYER_FLOOR 1
+#define DINO_LAYER_OBSTACLE 2
+#define DINO_LAYER_PLAYER 3
+
+/* Resolution the game is drawn at, the world background is authored for it. */
+#define DINO_LOGICAL_WIDTH 1920
+#define DINO_LOGICAL_HEIGHT 1080
+
+/* Frame time budget when the display does not report its refresh rate. */
+#define DINO_DEFAULT_REFRESH_RATE 60
+
+/* Largest render scale, 2 draws a 1080p logical frame at 4K. */
+#define DINO_MAX_RENDER_SCALE 2.0f
+
+/* Simulation ticks run at most per frame, a longer stall slows the game down instead. */
+#define DINO_MAX_TICKS_PER_FRAME 16
+
+/* Size of each frame arena buffer in bytes. */
+#define DINO_FRAME_ARENA_SIZE 65536
+
+/* Sprites the batch takes room for in the frame arena, it sizes itself after the busiest frame past that. */
+#define DINO_FRAME_SPRITES 64
+
+/* Length of the restart fade in milliseconds, the world is reloaded half way. */
+#define DINO_FADE_DURATION 600
+
+/* Frames between statistics reports in debug builds. */
+#define DINO_STATS_REPORT_INTERVAL 600
+
 namespace dino {
 
 /**
@@ -49,46 +87,111 @@ namespace dino {
 class Platformer {
 
 private:
-    std::mutex m_positionMutex {};
-    std::thread* m_positionThread = nullptr;
-    std::thread* m_animateThread  = nullptr;
-
     /**
      * @brief Determines if the main loop is still running.
+     *
+     * Like every other member, only touched by the main thread.
      */
     bool m_isRunning  = true;
 
     /**
-     * @brief Determines if the game is being played or not.
+     * @brief Determines if the restart fade is running.
      */
-    bool m_isGameOver = false;
+    bool m_isFading = false;
 
     /**
-     * @brief Holds the timestamp at which last obstacle was placed.
-     *
-     * This will be used to synchronise obstacle placement.
+     * @brief Tweened opacity of the restart fade overlay.
+     */
+    float m_fadeAlpha = 0.0f;
+
+    /**
+     * @brief Number of frames run since the main loop started.
      */
-    unsigned int m_lastObstacle;
+    unsigned long m_frameCount = 0;
 
     TargetWindow*   m_window;
+
+    /**
+     * @brief Logical size of the frame, every position is in these units.
+     */
+    int m_viewWidth;
+    int m_viewHeight;
+
     Renderer*       m_renderer;
     AudioMixer*     m_audioMixer;
 
+    /**
+     * @brief Scratch memory for data that lives for a single frame.
+     */
+    FrameArena* m_frameArena;
+
     SpriteMaterial* m_dinoSprite;
 
+    /**
+     * @brief Sprites of the frame, drawn together by layer.
+     */
+    SpriteBatch* m_spriteBatch;
+
+    /**
+     * @brief Advances every animation of the game once per frame.
+     */
+    TweenSystem* m_tweens;
+
+    /**
+     * @brief Serves textures and audio from the asset pack or the directories next to the binary.
+     */
+    VirtualFilesystem* m_filesystem;
+
+    /**
+     * @brief Swaps in assets changed on disk, nullptr unless DINO_HOT_RELOAD is set.
+     */
+    AssetReloader* m_assetReloader = nullptr;
+
+    /**
+     * @brief Game rules, run in fixed ticks on m_world.
+     */
+    WorldSimulation* m_simulation = nullptr;
+
+    /**
+     * @brief Frame time not yet simulated, in milliseconds.
+     */
+    float m_tickBacklog = 0.0f;
+
+    /**
+     * @brief Input bits collected from events, applied on the next tick.
+     */
+    uint8_t m_pendingInput = WorldSimulation::INPUT_NONE;
+
     std::vector<SpriteMaterial*>* m_baseTiles;
     std::vector<SpriteMaterial*>* m_worldScene;
-    std::vector<SpriteMaterial*>* m_obstacles;
 
     /**
-     * @brief Residual sprites.
+     * @brief Sprite drawn at the position of every obstacle.
+     */
+    SpriteMaterial* m_obstacleSprite = nullptr;
+
+    /**
+     * @brief Off-screen copy of the scene, drawn instead of every layer once the game is over.
+     */
+    SpriteMaterial* m_sceneCache = nullptr;
+
+    /**
+     * @brief Set once the scene of the current game over is in the cache.
+     */
+    bool m_isSceneCached = false;
+
+    /**
+     * @brief Simulation state of the game being played.
      *
-     * Holds the obstacle sprites that are currently not displayed
-     * on the screen. When an obstacle needs to be placed on the
-     * screen the sprite can be pulled from the residual queue instead
-     * of creating a new instance.
+     * The simulation works on it, so it stays at the same address
+     * and snapshots are copied into it.
      */
-    std::queue<SpriteMaterial*>* m_residual;
+    WorldState* m_world;
+
+    /**
+     * @brief Snapshot of the world taken once it was created, restored on restart.
+     */
+    WorldState* m_startState;
 
 public:
     /**
@@ -112,40 +215,80 @@ public:
     /**
      * @brief Resets the world scene back to initial state.
      *
-     * This method WILL NOT reload sprite materials. It simply
-     * re-positions them back to the initial state.
+     * This method WILL NOT reload sprite materials. It restores the
+     * snapshot taken by createWorld() and starts a new obstacle layout.
      */
     void reloadWorld();
 
     /**
-     * @brief Moves the camera on the horizontal X axis.
-     * @return Move status. 0 if camera moved, 1 otherwise.
+     * @brief Copies the simulation state.
+     * @param snapshot Receives the state.
+     */
+    void saveWorld(WorldState*) const;
+
+    /**
+     * @brief Replaces the simulation state with a snapshot.
+     * @param snapshot A state saved by saveWorld().
+     *
+     * Sprites follow the state on the next frame.
+     */
+    void restoreWorld(const WorldState&);
+
+    /**
+     * @brief Reacts to an event polled from the engine context.
+     * @param event The event.
+     */
+    void handleEvent(const EngineContext::Event&);
+
+    /**
+     * @brief Runs the simulation ticks due in this frame.
+     * @param delta_ms Time since the previous frame in milliseconds.
+     *
+     * The world moves in fixed ticks whatever the frame rate, events
+     * of the ticks are turned into sound here.
      */
-    int moveCamera();
+    void stepWorld(float);
 
     /**
-     * @brief Moves the player on the vertical Y axis.
-     * @param pos_x Initial player position on X axis.
-     * @param pos_y Initial player position on Y axis.
+     * @brief Loads a texture, preferring its raw image, and registers it for hot reload.
+     * @param file Image file name in the texture directory.
+     * @return The sprite material.
      */
-    void movePlayer(int, int);
+    SpriteMaterial* loadTexture(const std::string&);
 
     /**
-     * @brief Applies Run animation to the dino sprite.
+     * @brief Interns the name of an asset that must exist.
+     * @param name Asset name, e.g. audio/cartoon-jump.wav.
+     * @return The path id.
      */
-    void animateSprite();
+    PathId findAsset(const std::string&);
 
     /**
-     * @brief Randomly places the obstacles on the platform.
-     * @return True if obstacle placed, false otherwise.
+     * @brief Applies the current animation frame and jump height to the dino sprite.
+     */
+    void updatePlayer();
+
+    /**
+     * @brief Adds the world scene, the floor and the obstacles to the sprite batch.
      *
-     * This method attempts to place an object but without any
-     * guarantee that the obstacle is actually placed.
+     * While the game is over the scene does not move, so it is drawn
+     * into the scene cache once and the cache is added from then on.
+     */
+    void drawScene();
+
+    /**
+     * @brief Starts the restart fade.
      *
-     * The method will not place an obstacle if the previous obstacle
-     * was placed in less than 2 seconds ago.
+     * The fade darkens the frozen scene, restarts the game half way
+     * and then fades the new game in. Both halves are tweens, so the
+     * main loop keeps its normal schedule.
+     */
+    void startFade();
+
+    /**
+     * @brief Draws the restart fade overlay if the fade is running.
      */
-    bool placeObstacles();
+    void fadeScene();
 
     /**
      * @brief Runs the main loop.
@@ -0,0 +1,97 @@
+/**
+ * player_motion.cpp - Player animation and jump
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "player_motion.hpp"
+
+namespace {
+
+constexpr float PI = 3.14159265358979f;
+
+} // namespace
+
+dino::PlayerMotion::PlayerMotion(dino::MotionState* state, int clip_width) :
+        m_state(state),
+        m_clipWidth(clip_width) {
+
+    *m_state = dino::MotionState {};
+}
+
+void dino::PlayerMotion::update(float delta_ms) {
+    m_state->runMs = std::fmod(m_state->runMs + delta_ms, static_cast<float>(DINO_PLAYER_RUN_FRAMES * DINO_PLAYER_FRAME_DELAY));
+
+    if (m_state->isJumping == 0) {
+        return void();
+    }
+
+    m_state->jumpMs = m_state->jumpMs + delta_ms;
+
+    if (m_state->jumpMs >= DINO_PLAYER_JUMP_DURATION) {
+        m_state->jumpMs    = 0.0f;
+        m_state->isJumping = 0;
+    }
+}
+
+bool dino::PlayerMotion::jump() {
+    if (m_state->isStopped != 0 || m_state->isJumping != 0) {
+        return false;
+    }
+
+    m_state->jumpMs    = 0.0f;
+    m_state->isJumping = 1;
+
+    return true;
+}
+
+void dino::PlayerMotion::setStopped(bool is_stopped) {
+    m_state->isStopped = is_stopped ? 1 : 0;
+}
+
+bool dino::PlayerMotion::isJumping() const {
+    return m_state->isJumping != 0;
+}
+
+int dino::PlayerMotion::getClipX() const {
+    if (m_state->isStopped != 0) {
+        return m_clipWidth * DINO_PLAYER_RUN_FRAMES;
+    }
+
+    return std::min(static_cast<int>(m_state->runMs / DINO_PLAYER_FRAME_DELAY), DINO_PLAYER_RUN_FRAMES - 1) * m_clipWidth;
+}
+
+int dino::PlayerMotion::getLiftY() const {
+    if (m_state->isJumping == 0) {
+        return 0;
+    }
+
+    float progress = m_state->jumpMs / DINO_PLAYER_JUMP_DURATION;
+    return static_cast<int>(std::sin(PI * progress) * DINO_PLAYER_JUMP_HEIGHT);
+}
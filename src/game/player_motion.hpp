@@ -0,0 +1,136 @@
+/**
+ * player_motion.hpp - Player animation and jump
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Frames in the run animation of the sprite map. */
+#define DINO_PLAYER_RUN_FRAMES 6
+
+/* Time each animation frame is shown in milliseconds. */
+#define DINO_PLAYER_FRAME_DELAY 70
+
+/* Peak height of a jump in pixels. */
+#define DINO_PLAYER_JUMP_HEIGHT 450
+
+/* Time from take-off to landing in milliseconds. */
+#define DINO_PLAYER_JUMP_DURATION 660
+
+namespace dino {
+
+/**
+ * @brief Everything the player motion changes, kept as plain data so it can be copied as bytes.
+ */
+struct motion_state {
+    /**
+     * @brief Time into the run animation in milliseconds.
+     */
+    float runMs = 0.0f;
+
+    /**
+     * @brief Time since take-off in milliseconds.
+     */
+    float jumpMs = 0.0f;
+
+    uint8_t isJumping = 0;
+
+    /**
+     * @brief Holds the game over pose while set.
+     */
+    uint8_t isStopped = 0;
+};
+
+typedef struct motion_state MotionState;
+
+/**
+ * @brief Drives the player animation and jump.
+ *
+ * The run animation cycles through the frames of the sprite map and
+ * the jump follows a sine arc. Both are
+ * functions of the times held in a MotionState owned by the caller,
+ * so the motion can be saved and restored by copying the state.
+ */
+class PlayerMotion {
+
+private:
+    MotionState* m_state;
+
+    const int m_clipWidth;
+
+public:
+    /**
+     * @brief Starts the run animation.
+     * @param state State to work on, must outlive the instance.
+     * @param clip_width Width of one animation frame in the sprite map.
+     */
+    PlayerMotion(MotionState*, int);
+
+    PlayerMotion(const PlayerMotion&) = delete;
+
+    PlayerMotion& operator=(const PlayerMotion&) = delete;
+
+    /**
+     * @brief Advances the animation and the jump.
+     * @param delta_ms Time since the previous update in milliseconds.
+     */
+    void update(float);
+
+    /**
+     * @brief Starts a jump.
+     * @return True if started, false if the player is in the air or stopped.
+     */
+    bool jump();
+
+    /**
+     * @brief Switches between the run animation and the game over pose.
+     * @param is_stopped True to hold the game over pose.
+     */
+    void setStopped(bool);
+
+    /**
+     * @brief Checks if a jump is in progress.
+     * @return True while in the air.
+     */
+    [[nodiscard]] bool isJumping() const;
+
+    /**
+     * @brief Returns the scissor X offset of the current animation frame.
+     * @return Offset in pixels.
+     */
+    [[nodiscard]] int getClipX() const;
+
+    /**
+     * @brief Returns the height of the player above the floor.
+     * @return Height in pixels.
+     */
+    [[nodiscard]] int getLiftY() const;
+};
+
+} // namespace dino
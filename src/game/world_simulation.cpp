@@ -0,0 +1,199 @@
+/**
+ * world_simulation.cpp - Deterministic world simulation
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#include <stdexcept>
+
+#include "engine/geometry.hpp"
+#include "world_simulation.hpp"
+
+dino::WorldSimulation::WorldSimulation(const dino::WorldLayout& layout, dino::WorldState* state, unsigned int seed) :
+        m_layout(layout),
+        m_state(state),
+        m_spawner(spawnRules_(layout), &(state->spawner), seed),
+        m_playerMotion(&(state->player), layout.playerWidth) {
+
+    /* The floor and the background are one tile wider than the view, plus one scrolling in. */
+    if (layout.viewWidth / layout.tileWidth + 2 > DINO_WORLD_MAX_FLOOR_TILES ||
+            layout.viewWidth / layout.sceneWidth + 2 > DINO_WORLD_MAX_SCENES) {
+        throw std::runtime_error("World does not fit in the world state!");
+    }
+
+    reset(seed);
+}
+
+int32_t dino::WorldSimulation::jumpArcLength_() {
+    int32_t jump_ticks = 0;
+
+    /* Counted the way the player motion steps, it lands on the first tick past the duration. */
+    for (float jump_ms = 0.0f; jump_ms < DINO_PLAYER_JUMP_DURATION; jump_ms += TICK_MS) {
+        jump_ticks++;
+    }
+
+    return jump_ticks * DINO_FLOOR_SCROLL_VELOCITY;
+}
+
+dino::SpawnRules dino::WorldSimulation::spawnRules_(const dino::WorldLayout& layout) {
+    dino::SpawnRules spawn_rules {};
+    spawn_rules.minGap    = jumpArcLength_() + layout.obstacleWidth;
+    spawn_rules.maxGap    = spawn_rules.minGap * DINO_OBSTACLE_MAX_GAP_FACTOR;
+    spawn_rules.lookahead = layout.viewWidth * 2;
+
+    return spawn_rules;
+}
+
+void dino::WorldSimulation::reset(unsigned int seed) {
+    *m_state = dino::WorldState {};
+
+    m_state->floorCount = m_layout.viewWidth / m_layout.tileWidth + 2;
+    m_state->sceneCount = m_layout.viewWidth / m_layout.sceneWidth + 2;
+
+    for (int32_t index = 0; index < m_state->floorCount; index++) {
+        m_state->floorX[index] = index * m_layout.tileWidth;
+    }
+
+    for (int32_t index = 0; index < m_state->sceneCount; index++) {
+        m_state->sceneX[index] = index * m_layout.sceneWidth;
+    }
+
+    m_spawner.reset(seed);
+}
+
+void dino::WorldSimulation::reseed(unsigned int seed) {
+    m_spawner.reset(seed);
+}
+
+uint8_t dino::WorldSimulation::step(uint8_t input) {
+    uint8_t events = EVENT_NONE;
+
+    if ((input & INPUT_JUMP) != 0 && m_state->isGameOver == 0 && m_playerMotion.jump()) {
+        events = events | EVENT_JUMP;
+    }
+
+    m_playerMotion.update(TICK_MS);
+
+    if (m_state->isGameOver != 0) {
+        return events;
+    }
+
+    scrollScenery_();
+
+    if (moveObstacles_()) {
+        m_state->isGameOver = 1;
+        m_playerMotion.setStopped(true);
+
+        return events | EVENT_COLLISION;
+    }
+
+    m_spawner.advance(DINO_FLOOR_SCROLL_VELOCITY);
+    placeObstacles_();
+
+    return events;
+}
+
+int dino::WorldSimulation::resimulate(const dino::WorldState& snapshot, const uint8_t* inputs, int ticks) {
+    *m_state = snapshot;
+
+    for (int tick = 0; tick < ticks; tick++) {
+        if (m_state->isGameOver != 0) {
+            return tick;
+        }
+
+        step(inputs != nullptr ? inputs[tick] : static_cast<uint8_t>(INPUT_NONE));
+    }
+
+    return ticks;
+}
+
+void dino::WorldSimulation::scrollScenery_() {
+    constexpr dino::Vector2 floor_scroll {-DINO_FLOOR_SCROLL_VELOCITY, 0};
+    constexpr dino::Vector2 world_scroll {-DINO_WORLD_SCROLL_VELOCITY, 0};
+
+    int restart_x = (m_state->floorCount - 1) * m_layout.tileWidth - 15;
+
+    for (int32_t index = 0; index < m_state->floorCount; index++) {
+        dino::Rect2 bounds {m_state->floorX[index], 0, m_layout.tileWidth, 1};
+        m_state->floorX[index] = bounds.translate(floor_scroll).wrapLeft(0, restart_x).x;
+    }
+
+    restart_x = (m_state->sceneCount - 1) * m_layout.sceneWidth;
+
+    for (int32_t index = 0; index < m_state->sceneCount; index++) {
+        dino::Rect2 bounds {m_state->sceneX[index], 0, m_layout.sceneWidth, 1};
+        m_state->sceneX[index] = bounds.translate(world_scroll).wrapLeft(0, restart_x).x;
+    }
+}
+
+bool dino::WorldSimulation::moveObstacles_() {
+    dino::Rect2 hitbox {m_layout.playerX + 1,
+            m_layout.playerY - m_playerMotion.getLiftY(),
+            m_layout.playerWidth - 1,
+            m_layout.playerHeight - DINO_PLAYER_HITBOX_INSET};
+
+    bool is_hit = false;
+
+    m_state->obstacles.forEach([&] (dino::PoolHandle handle, dino::ObstacleEntity& obstacle) {
+        obstacle.posX = obstacle.posX - DINO_FLOOR_SCROLL_VELOCITY;
+
+        /* Return obstacles that left the view to the pool. */
+        if (obstacle.posX + m_layout.obstacleWidth <= 0) {
+            m_state->obstacles.release(handle);
+            return void();
+        }
+
+        if (hitbox.intersects(dino::Rect2 {obstacle.posX, obstacle.posY, 1, m_layout.obstacleHeight})) {
+            is_hit = true;
+        }
+    });
+
+    return is_hit;
+}
+
+void dino::WorldSimulation::placeObstacles_() {
+    int overshoot = 0;
+    dino::PoolHandle handle {};
+
+    while (m_spawner.poll(overshoot)) {
+        auto obstacle = m_state->obstacles.acquire(handle);
+
+        if (obstacle == nullptr) {
+            continue;
+        }
+
+        obstacle->posX = m_layout.viewWidth - overshoot;
+        obstacle->posY = m_layout.obstacleY;
+    }
+}
+
+const dino::PlayerMotion* dino::WorldSimulation::getPlayer() const {
+    return &m_playerMotion;
+}
+
+const dino::WorldLayout* dino::WorldSimulation::getLayout() const {
+    return &m_layout;
+}
@@ -0,0 +1,225 @@
+/**
+ * world_simulation.hpp - Deterministic world simulation
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "obstacle_spawner.hpp"
+#include "player_motion.hpp"
+#include "world_state.hpp"
+
+/* Simulation ticks per second, every tick advances the world by the same amount. */
+#define DINO_SIM_TICK_RATE 240
+
+/* Floor and background scroll per tick in pixels. */
+#define DINO_FLOOR_SCROLL_VELOCITY 5
+#define DINO_WORLD_SCROLL_VELOCITY 1
+
+/* Widest obstacle gap as a multiple of the narrowest. */
+#define DINO_OBSTACLE_MAX_GAP_FACTOR 3
+
+/* Part of the player sprite above the floor that does not collide. */
+#define DINO_PLAYER_HITBOX_INSET 100
+
+namespace dino {
+
+/**
+ * @brief Sizes and positions the simulation needs from the assets.
+ *
+ * Everything is in logical pixels. The layout does not change while
+ * the game runs, so it is not part of the world state.
+ */
+struct world_layout {
+    int32_t viewWidth = 0;
+
+    int32_t tileWidth  = 0;
+    int32_t sceneWidth = 0;
+
+    /**
+     * @brief Player bounds while standing on the floor.
+     */
+    int32_t playerX = 0;
+    int32_t playerY = 0;
+    int32_t playerWidth  = 0;
+    int32_t playerHeight = 0;
+
+    /**
+     * @brief Obstacle size and the Y at which every obstacle stands.
+     */
+    int32_t obstacleY = 0;
+    int32_t obstacleWidth  = 0;
+    int32_t obstacleHeight = 0;
+};
+
+typedef struct world_layout WorldLayout;
+
+/**
+ * @brief Runs the game rules on a WorldState in fixed ticks.
+ *
+ * The simulation has no dependency on SDL, the renderer or the clock.
+ * Every tick advances the world by the same amount of time and the
+ * only input is a bit mask per tick, so the same snapshot and the same
+ * inputs always produce the same states. That makes it possible to
+ * rewind to a snapshot and simulate ahead again, for rollback or to
+ * evaluate what an input would lead to.
+ *
+ * The state is owned by the caller. Restoring a snapshot is a copy
+ * into it, the simulation itself holds nothing that changes.
+ */
+class WorldSimulation {
+
+public: /* ===-=== Public Types ===-=== */
+    /**
+     * @brief Input bits of a tick.
+     */
+    enum Input : uint8_t {
+        INPUT_NONE = 0x00,
+        INPUT_JUMP = 0x01
+    };
+
+    /**
+     * @brief Event bits reported by a tick, for sound and other presentation.
+     */
+    enum Event : uint8_t {
+        EVENT_NONE      = 0x00,
+        EVENT_JUMP      = 0x01,
+        EVENT_COLLISION = 0x02
+    };
+
+    /**
+     * @brief Simulated time of one tick in milliseconds.
+     */
+    static constexpr float TICK_MS = 1000.0f / DINO_SIM_TICK_RATE;
+
+private: /* ===-=== Private Members ===-=== */
+    WorldLayout m_layout;
+
+    WorldState* m_state;
+
+    /**
+     * @brief Held by value, a batch steps many simulations laid out side by side.
+     */
+    ObstacleSpawner m_spawner;
+
+    PlayerMotion m_playerMotion;
+
+    /**
+     * @brief Returns the floor distance scrolled while the player is in the air.
+     * @return Ticks of a jump times the floor scroll per tick, in pixels.
+     */
+    static int32_t jumpArcLength_();
+
+    /**
+     * @brief Derives the obstacle spacing from the layout.
+     * @param layout Sizes and positions taken from the assets.
+     * @return The spawn rules.
+     */
+    static SpawnRules spawnRules_(const WorldLayout&);
+
+    /**
+     * @brief Scrolls the floor tiles and the background scenes.
+     */
+    void scrollScenery_();
+
+    /**
+     * @brief Scrolls the obstacles and releases the ones that left the view.
+     * @return True if an obstacle hit the player, false otherwise.
+     *
+     * Obstacles collide once their leading edge enters the player hitbox.
+     */
+    bool moveObstacles_();
+
+    /**
+     * @brief Places the obstacles that are due at the right edge of the view.
+     *
+     * An obstacle is skipped if the obstacle pool is exhausted.
+     */
+    void placeObstacles_();
+
+public: /* ===-=== Public Members ===-=== */
+    /**
+     * @brief Initialises the simulation and resets the state.
+     * @param layout Sizes and positions taken from the assets.
+     * @param state State to work on, must outlive the simulation.
+     * @param seed Seed for the obstacle layout.
+     * @throw std::runtime_error Thrown if the view is too wide for the state.
+     */
+    WorldSimulation(const WorldLayout&, WorldState*, unsigned int);
+
+    WorldSimulation(const WorldSimulation&) = delete;
+
+    WorldSimulation& operator=(const WorldSimulation&) = delete;
+
+    /**
+     * @brief Puts the state back to the start of a game.
+     * @param seed Seed for the obstacle layout.
+     */
+    void reset(unsigned int);
+
+    /**
+     * @brief Starts a new obstacle layout ahead of the camera.
+     * @param seed Seed for the obstacle layout.
+     *
+     * Obstacles already placed stay where they are.
+     */
+    void reseed(unsigned int);
+
+    /**
+     * @brief Advances the world by one tick.
+     * @param input Input bits of the tick.
+     * @return Event bits of the tick.
+     *
+     * Once the game is over only the player animation advances.
+     */
+    uint8_t step(uint8_t);
+
+    /**
+     * @brief Restores a snapshot and simulates ahead of it.
+     * @param snapshot The state to start from.
+     * @param inputs Input bits of every tick, nullptr for no input.
+     * @param ticks Maximum number of ticks to simulate.
+     * @return Number of ticks simulated, fewer than requested if the game ended.
+     */
+    int resimulate(const WorldState&, const uint8_t*, int);
+
+    /**
+     * @brief Returns the player motion, for the animation frame and jump height.
+     * @return The player motion.
+     */
+    [[nodiscard]] const PlayerMotion* getPlayer() const;
+
+    /**
+     * @brief Returns the layout the simulation was created with.
+     * @return The layout.
+     */
+    [[nodiscard]] const WorldLayout* getLayout() const;
+};
+
+} // namespace dino
@@ -0,0 +1,98 @@
+/**
+ * world_state.hpp - Snapshot of the game simulation
+ * ------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ========================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "engine/object_pool.hpp"
+#include "obstacle_spawner.hpp"
+#include "player_motion.hpp"
+
+/* Obstacles that can be on the platform at once. */
+#define DINO_OBSTACLE_POOL_SIZE 16
+
+/* Floor tiles and background scenes the world can hold. */
+#define DINO_WORLD_MAX_FLOOR_TILES 16
+#define DINO_WORLD_MAX_SCENES 4
+
+namespace dino {
+
+/**
+ * @brief An obstacle currently placed on the platform.
+ */
+struct obstacle_entity {
+    int posX = 0;
+    int posY = 0;
+};
+
+typedef struct obstacle_entity ObstacleEntity;
+
+/**
+ * @brief The whole simulation state of a game.
+ *
+ * Plain data without pointers, so a snapshot is a copy of the struct
+ * and restoring one is a copy back. Sprites, audio and the restart
+ * fade are presentation, they are derived from the state every frame
+ * and never stored in it.
+ */
+struct world_state {
+    /**
+     * @brief X position of every floor tile.
+     */
+    int32_t floorX[DINO_WORLD_MAX_FLOOR_TILES] = {};
+    int32_t floorCount = 0;
+
+    /**
+     * @brief X position of every background scene.
+     */
+    int32_t sceneX[DINO_WORLD_MAX_SCENES] = {};
+    int32_t sceneCount = 0;
+
+    /**
+     * @brief Obstacles currently placed on the platform.
+     *
+     * Obstacles are acquired from the pool when the spawner places
+     * them and released as soon as they leave the screen.
+     */
+    ObjectPool<ObstacleEntity, DINO_OBSTACLE_POOL_SIZE> obstacles;
+
+    SpawnerState spawner;
+
+    MotionState player;
+
+    uint8_t isGameOver = 0;
+};
+
+typedef struct world_state WorldState;
+
+static_assert(std::is_trivially_copyable<WorldState>::value, "World state must be restorable by copying bytes.");
+
+} // namespace dino
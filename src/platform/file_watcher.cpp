@@ -0,0 +1,196 @@
+/**
+ * file_watcher.cpp - Directory change notifications
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "standard.hpp"
+#include "file_watcher.hpp"
+
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+bool dino::FileWatcher::isSupported() {
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    return true;
+#else
+    return false;
+#endif
+}
+
+dino::FileWatcher::FileWatcher() {
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeFd   = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+dino::FileWatcher::~FileWatcher() {
+    stop();
+
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    if (m_notifyFd >= 0) {
+        close(m_notifyFd);
+    }
+
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+    }
+#endif
+}
+
+bool dino::FileWatcher::watch(const std::string& directory) {
+    if (m_isRunning.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    if (m_notifyFd < 0 || m_wakeFd < 0) {
+        return false;
+    }
+
+    /* Editors that save by renaming a temporary file show up as IN_MOVED_TO. */
+    int descriptor = inotify_add_watch(m_notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+
+    if (descriptor < 0) {
+        return false;
+    }
+
+    std::string prefix = directory;
+
+    if (prefix.empty() || prefix.back() != '/') {
+        prefix.push_back('/');
+    }
+
+    m_directories[descriptor] = prefix;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool dino::FileWatcher::start(dino::FileWatcher::ChangeHandler handler) {
+    if (m_directories.empty() || m_isRunning.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    m_handler = std::move(handler);
+    m_isRunning.store(true, std::memory_order_release);
+
+    m_watchThread = new std::thread(&dino::FileWatcher::watchLoop_, this);
+    return true;
+}
+
+void dino::FileWatcher::stop() {
+    if (m_watchThread == nullptr) {
+        return void();
+    }
+
+    m_isRunning.store(false, std::memory_order_release);
+
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    uint64_t wake = 1;
+    [[maybe_unused]] ssize_t written = write(m_wakeFd, &wake, sizeof(wake));
+#endif
+
+    m_watchThread->join();
+
+    delete m_watchThread;
+    m_watchThread = nullptr;
+}
+
+void dino::FileWatcher::watchLoop_() {
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+    using clock = std::chrono::steady_clock;
+
+    /* Changed files and the time of their last event. */
+    std::vector<std::pair<std::string, clock::time_point>> pending;
+
+    alignas(struct inotify_event) char buffer[4096];
+
+    pollfd handles[2] = {{m_notifyFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+
+    /* Clears the wake of an earlier stop(). */
+    uint64_t wake = 0;
+    [[maybe_unused]] ssize_t drained = read(m_wakeFd, &wake, sizeof(wake));
+
+    while (m_isRunning.load(std::memory_order_acquire)) {
+        int timeout = pending.empty() ? -1 : DINO_WATCH_SETTLE_MS;
+
+        if (poll(handles, 2, timeout) < 0) {
+            continue;
+        }
+
+        ssize_t length;
+
+        while ((length = read(m_notifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                auto event = reinterpret_cast<const struct inotify_event*>(cursor);
+                cursor = cursor + sizeof(struct inotify_event) + event->len;
+
+                auto directory = m_directories.find(event->wd);
+
+                if (event->len == 0 || (event->mask & IN_ISDIR) || directory == m_directories.end()) {
+                    continue;
+                }
+
+                std::string path = directory->second + event->name;
+                auto existing = pending.begin();
+
+                while (existing != pending.end() && existing->first != path) {
+                    existing++;
+                }
+
+                if (existing == pending.end()) {
+                    pending.emplace_back(path, clock::now());
+                } else {
+                    existing->second = clock::now();
+                }
+            }
+        }
+
+        auto settled_before = clock::now() - std::chrono::milliseconds(DINO_WATCH_SETTLE_MS);
+
+        for (auto entry = pending.begin(); entry != pending.end();) {
+            if (entry->second > settled_before) {
+                entry++;
+                continue;
+            }
+
+            m_handler(entry->first);
+            entry = pending.erase(entry);
+        }
+    }
+#endif
+}
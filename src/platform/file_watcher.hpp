@@ -0,0 +1,126 @@
+/**
+ * file_watcher.hpp - Directory change notifications
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/* Quiet time after the last write before a file is reported, editors often write in several steps. */
+#define DINO_WATCH_SETTLE_MS 100
+
+namespace dino {
+
+/**
+ * @brief Reports files written in a set of directories.
+ *
+ * A background thread waits on inotify and calls the handler with the
+ * path of every file that was written or moved into a watched directory.
+ * Bursts of events on one file are reported once, after the file has
+ * been quiet for DINO_WATCH_SETTLE_MS. Directories are not watched
+ * recursively.
+ *
+ * Only Linux is supported, elsewhere watch() always fails.
+ */
+class FileWatcher {
+
+public:
+    /**
+     * @brief Called on the watcher thread with the path of a changed file.
+     */
+    typedef std::function<void(const std::string&)> ChangeHandler;
+
+private:
+    int m_notifyFd = -1;
+
+    /**
+     * @brief Written by stop() to wake the watcher thread.
+     */
+    int m_wakeFd = -1;
+
+    /**
+     * @brief Watched directories by inotify watch descriptor.
+     */
+    std::unordered_map<int, std::string> m_directories;
+
+    ChangeHandler m_handler;
+
+    std::thread* m_watchThread = nullptr;
+
+    std::atomic<bool> m_isRunning {false};
+
+    /**
+     * @brief Runs on the watcher thread until stop() is called.
+     */
+    void watchLoop_();
+
+public:
+    /**
+     * @brief Checks if file watching is available on this platform.
+     * @return True on Linux.
+     */
+    static bool isSupported();
+
+    FileWatcher();
+
+    /**
+     * @brief Stops the watcher thread and closes the notification handles.
+     */
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Adds a directory to the watch list.
+     * @param directory Path to the directory.
+     * @return True if the directory is watched, false otherwise.
+     *
+     * Must be called before start().
+     */
+    bool watch(const std::string&);
+
+    /**
+     * @brief Starts the watcher thread.
+     * @param handler Called with the path of each changed file.
+     * @return True if started, false if nothing is watched or it is already running.
+     */
+    bool start(ChangeHandler);
+
+    /**
+     * @brief Stops the watcher thread, pending changes are dropped.
+     */
+    void stop();
+};
+
+} // namespace dino
@@ -31,6 +31,10 @@
 #include "standard.hpp"
 #include "filesystem.hpp"
 
+#if defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <windows.h>
+#endif
+
 std::string dino::Filesystem::s_dirname {};
 
 std::string dino::Filesystem::dirname() {
@@ -41,6 +45,14 @@ std::string dino::Filesystem::dirname() {
 #if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
     auto path = std::filesystem::canonical("/proc/self/exe");
     s_dirname = path.remove_filename().string();
+
+#elif defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+    char module_path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(nullptr, module_path, MAX_PATH);
+
+    if (length > 0 && length < MAX_PATH) {
+        s_dirname = std::filesystem::path(module_path, module_path + length).remove_filename().string();
+    }
 #endif
 
     return s_dirname;
@@ -0,0 +1,183 @@
+/**
+ * log_format.cpp - Binary log record format definition
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "log_format.hpp"
+
+namespace {
+
+const char* s_levelLabels[] = {
+    "[FATAL] ",
+    "[ERROR] ",
+    "[WARN ] ",
+    "[INFO ] ",
+    "[DEBUG] ",
+    "[TRACE] "
+};
+
+template<typename T>
+T readValue_(const uint8_t* payload) {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+
+    return value;
+}
+
+/**
+ * @brief Renders the argument at the cursor and advances past it.
+ * @return False if the payload is exhausted or malformed.
+ */
+bool renderArgument_(std::string& output, const uint8_t* payload, std::size_t size, std::size_t* cursor) {
+    if (*cursor >= size) {
+        return false;
+    }
+
+    auto type = payload[*cursor];
+    const uint8_t* value = payload + *cursor + 1;
+    std::size_t available = size - *cursor - 1;
+    std::size_t length;
+
+    char digits[32];
+    int written = 0;
+
+    switch (type) {
+        case dino::LogFormat::ARG_SIGNED:
+            length  = sizeof(int64_t);
+            written = available < length ? -1 : std::snprintf(digits, sizeof(digits), "%" PRId64, readValue_<int64_t>(value));
+            break;
+
+        case dino::LogFormat::ARG_UNSIGNED:
+            length  = sizeof(uint64_t);
+            written = available < length ? -1 : std::snprintf(digits, sizeof(digits), "%" PRIu64, readValue_<uint64_t>(value));
+            break;
+
+        case dino::LogFormat::ARG_FLOAT:
+            length  = sizeof(double);
+            written = available < length ? -1 : std::snprintf(digits, sizeof(digits), "%g", readValue_<double>(value));
+            break;
+
+        case dino::LogFormat::ARG_POINTER:
+            length  = sizeof(uint64_t);
+            written = available < length ? -1 : std::snprintf(digits, sizeof(digits), "0x%" PRIx64, readValue_<uint64_t>(value));
+            break;
+
+        case dino::LogFormat::ARG_BOOL:
+            length = 1;
+
+            if (available >= length) {
+                output.append(value[0] != 0 ? "true" : "false");
+            }
+            break;
+
+        case dino::LogFormat::ARG_CHAR:
+            length = 1;
+
+            if (available >= length) {
+                output.push_back(static_cast<char>(value[0]));
+            }
+            break;
+
+        case dino::LogFormat::ARG_STRING:
+            if (available < sizeof(uint16_t)) {
+                return false;
+            }
+
+            length = sizeof(uint16_t) + readValue_<uint16_t>(value);
+
+            if (available >= length) {
+                output.append(reinterpret_cast<const char*>(value + sizeof(uint16_t)), length - sizeof(uint16_t));
+            }
+            break;
+
+        case dino::LogFormat::ARG_TRUNCATED:
+            output.append("...");
+            *cursor = size;
+            return true;
+
+        default:
+            return false;
+    }
+
+    if (available < length || written < 0) {
+        return false;
+    }
+
+    if (written > 0) {
+        output.append(digits, static_cast<std::size_t>(written));
+    }
+
+    *cursor = *cursor + 1 + length;
+    return true;
+}
+
+} // namespace
+
+const char* dino::LogFormat::getLevelLabel(int level) {
+    if (level < 0 || level >= static_cast<int>(sizeof(s_levelLabels) / sizeof(s_levelLabels[0]))) {
+        return "[?????] ";
+    }
+
+    return s_levelLabels[level];
+}
+
+void dino::LogFormat::render(std::string& output, const char* format, const uint8_t* payload, std::size_t size) {
+    std::size_t cursor = 0;
+    std::size_t start  = output.size();
+
+    if (format != nullptr) {
+        const char* text = format;
+
+        while (*text != '\0') {
+            if (text[0] == '{' && text[1] == '}') {
+                if (!renderArgument_(output, payload, size, &cursor)) {
+                    output.append("{}");
+                }
+
+                text = text + 2;
+                continue;
+            }
+
+            output.push_back(*text);
+            text++;
+        }
+    }
+
+    while (cursor < size) {
+        if (output.size() > start) {
+            output.push_back(' ');
+        }
+
+        if (!renderArgument_(output, payload, size, &cursor)) {
+            break;
+        }
+    }
+}
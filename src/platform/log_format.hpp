@@ -0,0 +1,126 @@
+/**
+ * log_format.hpp - Binary log record format declaration
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/* Leading bytes of a binary log file. */
+#define DINO_LOG_FILE_MAGIC "DINOLOG1"
+
+/* Bytes of encoded arguments a record can hold. */
+#define DINO_LOG_PAYLOAD_SIZE 244
+
+namespace dino {
+
+/**
+ * @brief A log message on its way to the writer thread.
+ *
+ * The message is not formatted. It holds the identifier of the format
+ * string registered by the call site and the raw bytes of every
+ * argument, each preceded by a dino::LogFormat::ArgType tag.
+ */
+struct log_record {
+    /**
+     * @brief Registered format, 0 joins the arguments with spaces.
+     */
+    uint32_t formatId = 0;
+
+    uint8_t level = 0;
+
+    /**
+     * @brief Printed without the level label if not 0.
+     */
+    uint8_t isPlain = 0;
+
+    uint16_t size = 0;
+    uint8_t payload[DINO_LOG_PAYLOAD_SIZE];
+};
+
+typedef struct log_record LogRecord;
+
+/**
+ * @brief Encoding shared by the logger, its writer thread and the offline decoder.
+ *
+ * A binary log file starts with DINO_LOG_FILE_MAGIC followed by entries,
+ * each starting with an EntryKind byte. Format entries describe a call
+ * site and always precede the first message using them. Every value is
+ * stored in the byte order of the machine that wrote the log.
+ *
+ * Format entry: id (u32), level (u8), line (u32), file length (u16),
+ * file, format length (u16), format.
+ *
+ * Message entry: format id (u32), level (u8), plain flag (u8),
+ * payload size (u16), payload.
+ */
+class LogFormat {
+
+public:
+    enum EntryKind : uint8_t {
+        ENTRY_FORMAT = 1,
+        ENTRY_MESSAGE
+    };
+
+    enum ArgType : uint8_t {
+        ARG_SIGNED = 1,
+        ARG_UNSIGNED,
+        ARG_FLOAT,
+        ARG_BOOL,
+        ARG_CHAR,
+        ARG_POINTER,
+
+        /* Followed by a u16 length and the characters. */
+        ARG_STRING,
+
+        /* Arguments after this one did not fit in the record. */
+        ARG_TRUNCATED
+    };
+
+    /**
+     * @brief Returns the label printed in front of a level.
+     * @param level The level.
+     * @return The label.
+     */
+    static const char* getLevelLabel(int);
+
+    /**
+     * @brief Renders a record as text.
+     * @param output Receives the text, without a trailing newline.
+     * @param format Format string with {} placeholders, or nullptr.
+     * @param payload Encoded arguments.
+     * @param size Payload size in bytes.
+     *
+     * Without a format the arguments are joined with spaces. Arguments
+     * left over after the last placeholder are appended the same way.
+     */
+    static void render(std::string&, const char*, const uint8_t*, std::size_t);
+};
+
+} // namespace dino
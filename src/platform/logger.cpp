@@ -27,14 +27,438 @@
  * ===============================================================================
  */
 
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.hpp"
 #include "logger.hpp"
 
-bool dino::Logger::m_verbose = true;
+namespace {
+
+/* Pause of the writer thread when every ring is empty. */
+constexpr auto WRITER_IDLE_TIME = std::chrono::milliseconds(2);
+
+/**
+ * @brief Set once the backend is destroyed, later records are written directly.
+ */
+std::atomic<bool> s_isShutdown {false};
+
+/**
+ * @brief The ring of a single logging thread.
+ */
+struct log_channel {
+    dino::SpscRing<dino::LogRecord> ring {DINO_LOG_RING_SIZE};
+
+    /**
+     * @brief Set when the owning thread exits, the channel is reused once drained.
+     */
+    std::atomic<bool> isRetired {false};
+};
+
+/**
+ * @brief A call site registered with a format string.
+ */
+struct log_site {
+    int level;
+    int line;
+    const char* file;
+    const char* format;
+};
+
+template<typename T>
+void appendRaw_(std::string& batch, const T& value) {
+    batch.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendText_(std::string& batch, const char* text) {
+    auto length = static_cast<uint16_t>(std::min<std::size_t>(std::strlen(text), UINT16_MAX));
+
+    appendRaw_(batch, length);
+    batch.append(text, length);
+}
+
+/**
+ * @brief Owns the rings and the writer thread.
+ */
+class LogBackend {
+
+private:
+    /**
+     * @brief Guards the channel list and the consumer side of every ring.
+     */
+    std::mutex m_mutex;
+
+    std::vector<log_channel*> m_channels;
+    std::vector<log_channel*> m_freeChannels;
+
+    std::thread* m_writer = nullptr;
+    std::atomic<bool> m_isRunning {false};
+
+    std::string m_outBatch;
+    std::string m_errorBatch;
+    std::string m_binaryBatch;
+
+    /**
+     * @brief Registered call sites, indexed by format identifier minus one.
+     */
+    std::vector<log_site> m_sites;
+
+    /**
+     * @brief Binary log file, records go to the console if nullptr.
+     */
+    FILE* m_binaryFile = nullptr;
+
+    /**
+     * @brief Number of call sites already described in the binary log.
+     */
+    std::size_t m_writtenSites = 0;
+
+    std::atomic<uint64_t> m_dropped {0};
+    uint64_t m_reportedDrops = 0;
+
+    [[nodiscard]] const char* formatOf_(uint32_t format_id) const {
+        if (format_id == 0 || format_id > m_sites.size()) {
+            return nullptr;
+        }
+
+        return m_sites[format_id - 1].format;
+    }
+
+    void renderText_(const dino::LogRecord& record) {
+        auto& batch = record.level <= dino::Logger::WARN ? m_errorBatch : m_outBatch;
+
+        if (record.isPlain == 0) {
+            batch.append(dino::LogFormat::getLevelLabel(record.level));
+        }
+
+        dino::LogFormat::render(batch, formatOf_(record.formatId), record.payload, record.size);
+        batch.push_back('\n');
+    }
+
+    void format_(const dino::LogRecord& record) {
+        if (m_binaryFile == nullptr) {
+            renderText_(record);
+            return void();
+        }
+
+        m_binaryBatch.push_back(static_cast<char>(dino::LogFormat::ENTRY_MESSAGE));
+        appendRaw_(m_binaryBatch, record.formatId);
+        appendRaw_(m_binaryBatch, record.level);
+        appendRaw_(m_binaryBatch, record.isPlain);
+        appendRaw_(m_binaryBatch, record.size);
+        m_binaryBatch.append(reinterpret_cast<const char*>(record.payload), record.size);
+
+        if (record.level <= dino::Logger::WARN) {
+            renderText_(record);
+        }
+    }
+
+    /**
+     * @brief Describes new call sites in the binary log. Caller holds the mutex.
+     */
+    void describeSites_() {
+        for (; m_writtenSites < m_sites.size(); m_writtenSites++) {
+            auto& site = m_sites[m_writtenSites];
+
+            m_binaryBatch.push_back(static_cast<char>(dino::LogFormat::ENTRY_FORMAT));
+            appendRaw_(m_binaryBatch, static_cast<uint32_t>(m_writtenSites + 1));
+            appendRaw_(m_binaryBatch, static_cast<uint8_t>(site.level));
+            appendRaw_(m_binaryBatch, static_cast<uint32_t>(site.line));
+            appendText_(m_binaryBatch, site.file);
+            appendText_(m_binaryBatch, site.format);
+        }
+    }
+
+    /**
+     * @brief Moves every pending record into the batches. Caller holds the mutex.
+     * @return Number of records moved.
+     */
+    std::size_t drain_() {
+        std::size_t drained = 0;
+        dino::LogRecord record;
+
+        if (m_binaryFile != nullptr) {
+            describeSites_();
+        }
+
+        for (auto channel = m_channels.begin(); channel != m_channels.end();) {
+            bool is_retired = (*channel)->isRetired.load(std::memory_order_acquire);
+
+            while ((*channel)->ring.pop(record)) {
+                format_(record);
+                drained++;
+            }
+
+            if (is_retired) {
+                m_freeChannels.push_back(*channel);
+                channel = m_channels.erase(channel);
+            } else {
+                channel++;
+            }
+        }
+
+        uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+
+        if (dropped != m_reportedDrops) {
+            m_errorBatch.append(dino::LogFormat::getLevelLabel(dino::Logger::WARN));
+            m_errorBatch.append(std::to_string(dropped - m_reportedDrops));
+            m_errorBatch.append(" log records dropped\n");
+
+            m_reportedDrops = dropped;
+        }
+
+        return drained;
+    }
+
+    /**
+     * @brief Writes and clears the batches. Caller holds the mutex.
+     */
+    void write_() {
+        if (!m_binaryBatch.empty() && m_binaryFile != nullptr) {
+            std::fwrite(m_binaryBatch.data(), 1, m_binaryBatch.size(), m_binaryFile);
+            std::fflush(m_binaryFile);
+        }
+
+        m_binaryBatch.clear();
+
+        if (!m_outBatch.empty()) {
+            std::fwrite(m_outBatch.data(), 1, m_outBatch.size(), stdout);
+            std::fflush(stdout);
+            m_outBatch.clear();
+        }
+
+        if (!m_errorBatch.empty()) {
+            std::fwrite(m_errorBatch.data(), 1, m_errorBatch.size(), stderr);
+            std::fflush(stderr);
+            m_errorBatch.clear();
+        }
+    }
+
+    void writeLoop_() {
+        while (m_isRunning.load(std::memory_order_acquire)) {
+            std::size_t drained;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                drained = drain_();
+                write_();
+            }
+
+            if (drained == 0) {
+                std::this_thread::sleep_for(WRITER_IDLE_TIME);
+            }
+        }
+    }
+
+public:
+    ~LogBackend() {
+        s_isShutdown.store(true, std::memory_order_release);
+        m_isRunning.store(false, std::memory_order_release);
+
+        if (m_writer != nullptr && m_writer->joinable()) {
+            m_writer->join();
+        }
+
+        delete m_writer;
+        closeBinaryLog();
+
+        /* Channels of threads that are still alive are leaked on purpose. */
+        for (auto channel : m_freeChannels) {
+            delete channel;
+        }
+    }
+
+    /**
+     * @brief Hands out a channel for the calling thread and starts the writer.
+     * @return The channel.
+     */
+    log_channel* acquireChannel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        log_channel* channel;
+
+        if (m_freeChannels.empty()) {
+            channel = new log_channel();
+        } else {
+            channel = m_freeChannels.back();
+            channel->isRetired.store(false, std::memory_order_relaxed);
+            m_freeChannels.pop_back();
+        }
+
+        m_channels.push_back(channel);
+
+        if (m_writer == nullptr) {
+            m_outBatch.reserve(16384);
+            m_errorBatch.reserve(4096);
+
+            m_isRunning.store(true, std::memory_order_release);
+            m_writer = new std::thread(&LogBackend::writeLoop_, this);
+        }
+
+        return channel;
+    }
+
+    uint32_t registerSite(int level, const char* file, int line, const char* format) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_sites.push_back({level, line, file, format});
+        return static_cast<uint32_t>(m_sites.size());
+    }
+
+    bool openBinaryLog(const std::string& log_file) {
+        closeBinaryLog();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_binaryFile = std::fopen(log_file.c_str(), "wb");
+
+        if (m_binaryFile == nullptr) {
+            return false;
+        }
+
+        std::fwrite(DINO_LOG_FILE_MAGIC, 1, std::strlen(DINO_LOG_FILE_MAGIC), m_binaryFile);
+        m_writtenSites = 0;
+
+        return true;
+    }
+
+    void closeBinaryLog() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        drain_();
+        write_();
+
+        if (m_binaryFile != nullptr) {
+            std::fclose(m_binaryFile);
+            m_binaryFile = nullptr;
+        }
+    }
+
+    void countDrop() {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t getDropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        drain_();
+        write_();
+    }
+
+    /**
+     * @brief Writes a record right away, after everything pending.
+     * @param record The record.
+     */
+    void writeNow(const dino::LogRecord& record) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        drain_();
+        format_(record);
+        write_();
+    }
+};
+
+LogBackend& backend_() {
+    static LogBackend s_backend;
+    return s_backend;
+}
+
+/**
+ * @brief Retires the channel of a thread when the thread exits.
+ */
+struct channel_owner {
+    log_channel* channel = nullptr;
+
+    ~channel_owner() {
+        if (channel != nullptr) {
+            channel->isRetired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local channel_owner s_threadChannel;
+
+} // namespace
+
+std::atomic<int> dino::Logger::s_level {DINO_LOG_LEVEL};
+
+void dino::Logger::submit_(const dino::LogRecord& record) {
+    if (s_isShutdown.load(std::memory_order_acquire)) {
+        /* Call sites are gone with the backend, only the arguments are left. */
+        std::string text = record.isPlain != 0 ? "" : dino::LogFormat::getLevelLabel(record.level);
+
+        dino::LogFormat::render(text, nullptr, record.payload, record.size);
+        std::fprintf(stderr, "%s\n", text.c_str());
+
+        return void();
+    }
+
+    auto& backend = backend_();
+
+    if (record.level == FATAL) {
+        backend.writeNow(record);
+        return void();
+    }
+
+    if (s_threadChannel.channel == nullptr) {
+        s_threadChannel.channel = backend.acquireChannel();
+    }
+
+    if (!s_threadChannel.channel->ring.push(record)) {
+        backend.countDrop();
+    }
+}
 
 void dino::Logger::verboseOn() {
-    m_verbose = true;
+    setLevel(TRACE);
 }
 
 void dino::Logger::verboseOff() {
-    m_verbose = false;
+    setLevel(INFO);
+}
+
+void dino::Logger::setLevel(int level) {
+    s_level.store(std::clamp(level, static_cast<int>(FATAL), static_cast<int>(TRACE)), std::memory_order_relaxed);
+}
+
+int dino::Logger::getLevel() {
+    return s_level.load(std::memory_order_relaxed);
+}
+
+void dino::Logger::flush() {
+    if (!s_isShutdown.load(std::memory_order_acquire)) {
+        backend_().flush();
+    }
+}
+
+uint64_t dino::Logger::getDropped() {
+    if (s_isShutdown.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    return backend_().getDropped();
+}
+
+uint32_t dino::Logger::registerFormat(int level, const char* file, int line, const char* format) {
+    if (s_isShutdown.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    return backend_().registerSite(level, file, line, format);
+}
+
+bool dino::Logger::openBinaryLog(const std::string& log_file) {
+    return backend_().openBinaryLog(log_file);
+}
+
+void dino::Logger::closeBinaryLog() {
+    if (!s_isShutdown.load(std::memory_order_acquire)) {
+        backend_().closeBinaryLog();
+    }
 }
@@ -29,85 +29,277 @@
 
 #pragma once
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <initializer_list>
+#include <string_view>
+#include <type_traits>
+
+#include "log_format.hpp"
+
+/* Log levels, matching dino::Logger::LogLevel. */
+#define DINO_LOG_LEVEL_FATAL 0
+#define DINO_LOG_LEVEL_ERROR 1
+#define DINO_LOG_LEVEL_WARN  2
+#define DINO_LOG_LEVEL_INFO  3
+#define DINO_LOG_LEVEL_DEBUG 4
+#define DINO_LOG_LEVEL_TRACE 5
+
+/* Most verbose level compiled in, calls above it compile to nothing. */
+#ifndef DINO_LOG_LEVEL
+#if defined(DINO_MODE_DEBUG) && DINO_MODE_DEBUG == 1
+#define DINO_LOG_LEVEL DINO_LOG_LEVEL_TRACE
+#else
+#define DINO_LOG_LEVEL DINO_LOG_LEVEL_INFO
+#endif
+#endif // DINO_LOG_LEVEL
+
+/* Records buffered per logging thread. */
+#define DINO_LOG_RING_SIZE 256
+
+/**
+ * Logs a message with a format string, e.g.
+ * DINO_LOG(dino::Logger::DEBUG, "Callback took {} ms", elapsed).
+ *
+ * The format is registered once per call site, every call after that
+ * only copies the format identifier and the raw argument bytes.
+ */
+#define DINO_LOG(level, format, ...)                                                            \
+do {                                                                                            \
+    if constexpr ((level) <= DINO_LOG_LEVEL) {                                                  \
+        static const uint32_t dino_log_format_id =                                              \
+                dino::Logger::registerFormat((level), __FILE__, __LINE__, (format));            \
+        dino::Logger::log<(level)>(dino_log_format_id, ##__VA_ARGS__);                          \
+    }                                                                                           \
+} while (false)
 
 namespace dino {
 
+/**
+ * @brief Asynchronous binary logger.
+ *
+ * A call copies the raw bytes of its arguments into a fixed size record
+ * on the stack and pushes it into a lock-free ring owned by the calling
+ * thread. Nothing is formatted, allocated or locked on the way. A
+ * background thread drains the rings and either renders the records
+ * as text on stdout and stderr, or appends them to a binary log that
+ * tools/log_decode turns back into text.
+ *
+ * Levels above DINO_LOG_LEVEL are removed at compile time, levels above
+ * the runtime level are rejected before anything is encoded. Records
+ * are dropped and counted when a ring is full. Fatal messages flush every
+ * pending record and are written synchronously.
+ */
 class Logger {
 
 private:/* ===-=== Private Members ===-=== */
-    static bool m_verbose;
+    static std::atomic<int> s_level;
 
     template<typename T>
-    static void printUnpacked_(int level, T&& message) {
-        switch (level) {
-            case FATAL:
-            case ERROR:
-            case WARN:
-                std::cerr << message << " ";
-                break;
-
-            default:
-                std::cout << message << " ";
-                break;
+    static bool encodeRaw_(LogRecord& record, LogFormat::ArgType type, const T& value) {
+        if (record.size + 1 + sizeof(T) > DINO_LOG_PAYLOAD_SIZE) {
+            return false;
+        }
+
+        record.payload[record.size] = type;
+        std::memcpy(record.payload + record.size + 1, &value, sizeof(T));
+        record.size = static_cast<uint16_t>(record.size + 1 + sizeof(T));
+
+        return true;
+    }
+
+    static bool encodeString_(LogRecord& record, std::string_view text) {
+        std::size_t header = 1 + sizeof(uint16_t);
+
+        if (record.size + header > DINO_LOG_PAYLOAD_SIZE) {
+            return false;
         }
+
+        /* Long strings are cut to the space left. */
+        auto length = static_cast<uint16_t>(std::min<std::size_t>(text.size(), DINO_LOG_PAYLOAD_SIZE - record.size - header));
+
+        record.payload[record.size] = LogFormat::ARG_STRING;
+        std::memcpy(record.payload + record.size + 1, &length, sizeof(uint16_t));
+        std::memcpy(record.payload + record.size + header, text.data(), length);
+        record.size = static_cast<uint16_t>(record.size + header + length);
+
+        return true;
     }
 
+    template<typename T>
+    static bool encode_(LogRecord& record, const T& value) {
+        typedef std::decay_t<T> value_type;
+
+        if constexpr (std::is_same_v<value_type, bool>) {
+            return encodeRaw_(record, LogFormat::ARG_BOOL, static_cast<uint8_t>(value));
+
+        } else if constexpr (std::is_same_v<value_type, char>) {
+            return encodeRaw_(record, LogFormat::ARG_CHAR, value);
+
+        } else if constexpr (std::is_integral_v<value_type> && std::is_signed_v<value_type>) {
+            return encodeRaw_(record, LogFormat::ARG_SIGNED, static_cast<int64_t>(value));
+
+        } else if constexpr (std::is_integral_v<value_type>) {
+            return encodeRaw_(record, LogFormat::ARG_UNSIGNED, static_cast<uint64_t>(value));
+
+        } else if constexpr (std::is_enum_v<value_type>) {
+            return encode_(record, static_cast<std::underlying_type_t<value_type>>(value));
+
+        } else if constexpr (std::is_floating_point_v<value_type>) {
+            return encodeRaw_(record, LogFormat::ARG_FLOAT, static_cast<double>(value));
+
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            /* Only a real pointer can be null, arrays decay to one but never compare equal to nullptr. */
+            if constexpr (std::is_pointer_v<T>) {
+                return encodeString_(record, value == nullptr ? "(null)" : std::string_view(value));
+            } else {
+                return encodeString_(record, std::string_view(value));
+            }
+
+        } else if constexpr (std::is_pointer_v<value_type>) {
+            return encodeRaw_(record, LogFormat::ARG_POINTER, static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(value)));
+
+        } else {
+            static_assert(std::is_arithmetic_v<value_type>, "Type cannot be logged.");
+            return false;
+        }
+    }
+
+    template<int Level, typename... T>
+    static void write_(uint32_t format_id, bool is_plain, const T& ...messages) {
+        if constexpr (Level <= DINO_LOG_LEVEL) {
+            if (Level > s_level.load(std::memory_order_relaxed)) {
+                return void();
+            }
+
+            LogRecord record;
+            record.formatId = format_id;
+            record.level    = static_cast<uint8_t>(Level);
+            record.isPlain  = is_plain ? 1 : 0;
+
+            /* Stops at the first argument that does not fit. */
+            bool is_complete = (encode_(record, messages) && ...);
+
+            if (!is_complete && record.size < DINO_LOG_PAYLOAD_SIZE) {
+                record.payload[record.size] = LogFormat::ARG_TRUNCATED;
+                record.size++;
+            }
+
+            submit_(record);
+        }
+    }
+
+    /**
+     * @brief Hands a record to the writer thread.
+     * @param record The record.
+     */
+    static void submit_(const LogRecord&);
+
 public: /* ===-=== Public Members ===-=== */
     enum LogLevel : int {
-        FATAL = 0,
-        ERROR,
-        WARN,
-        INFO,
-        DEBUG,
-        TRACE
+        FATAL = DINO_LOG_LEVEL_FATAL,
+        ERROR = DINO_LOG_LEVEL_ERROR,
+        WARN  = DINO_LOG_LEVEL_WARN,
+        INFO  = DINO_LOG_LEVEL_INFO,
+        DEBUG = DINO_LOG_LEVEL_DEBUG,
+        TRACE = DINO_LOG_LEVEL_TRACE
     };
 
+    /**
+     * @brief Enables every compiled in level.
+     */
     static void verboseOn();
 
+    /**
+     * @brief Limits logging to info and more severe levels.
+     */
     static void verboseOff();
 
+    /**
+     * @brief Sets the most verbose level logged at runtime.
+     * @param level The level.
+     */
+    static void setLevel(int);
+
+    /**
+     * @brief Returns the most verbose level logged at runtime.
+     * @return The level.
+     */
+    static int getLevel();
+
+    /**
+     * @brief Writes every pending record before returning.
+     */
+    static void flush();
+
+    /**
+     * @brief Returns the number of records dropped because a ring was full.
+     * @return Dropped record count.
+     */
+    static uint64_t getDropped();
+
+    /**
+     * @brief Registers the format string of a call site, see DINO_LOG.
+     * @param level Level of the call site.
+     * @param file Source file of the call site.
+     * @param line Source line of the call site.
+     * @param format Format string with {} placeholders, must outlive the logger.
+     * @return Format identifier.
+     */
+    static uint32_t registerFormat(int, const char*, int, const char*);
+
+    /**
+     * @brief Sends records to a binary log file instead of the console.
+     * @param log_file Path to the binary log file, truncated if it exists.
+     * @return True if the file was opened, false otherwise.
+     *
+     * Warnings and more severe records are still printed to stderr.
+     */
+    static bool openBinaryLog(const std::string&);
+
+    /**
+     * @brief Flushes and closes the binary log, the console is used again.
+     */
+    static void closeBinaryLog();
+
+    /**
+     * @brief Logs a message with a registered format, see DINO_LOG.
+     * @tparam Level The level, calls above DINO_LOG_LEVEL compile to nothing.
+     * @param format_id Identifier returned by registerFormat.
+     * @param messages Values for the placeholders of the format.
+     */
+    template<int Level, typename... T> static void log(uint32_t format_id, const T& ...messages) {
+        write_<Level>(format_id, false, messages...);
+    }
+
     template<typename... T> static void fatal(T&& ...messages) {
-        std::cerr << "[FATAL] ";
-        (printUnpacked_(FATAL, messages), ...);
-        std::cerr << std::endl;
+        write_<FATAL>(0, false, messages...);
     }
 
     template<typename... T> static void error(T&& ...messages) {
-        std::cerr << "[ERROR] ";
-        (printUnpacked_(ERROR, messages), ...);
-        std::cerr << std::endl;
+        write_<ERROR>(0, false, messages...);
     }
 
     template<typename... T> static void warn(T&& ...messages) {
-        std::cerr << "[WARN ] ";
-        (printUnpacked_(WARN, messages), ...);
-        std::cerr << std::endl;
+        write_<WARN>(0, false, messages...);
     }
 
     template<typename... T> static void info(T&& ...messages) {
-        std::cout << "[INFO ] ";
-        (printUnpacked_(INFO, messages), ...);
-        std::cout << std::endl;
+        write_<INFO>(0, false, messages...);
     }
 
     template<typename... T> static void debug(T&& ...messages) {
-        std::cout << "[DEBUG] ";
-        (printUnpacked_(DEBUG, messages), ...);
-        std::cout << std::endl;
+        write_<DEBUG>(0, false, messages...);
     }
 
     template<typename... T> static void trace(T&& ...messages) {
-        std::cout << "[TRACE] ";
-        (printUnpacked_(TRACE, messages), ...);
-        std::cout << std::endl;
+        write_<TRACE>(0, false, messages...);
     }
 
     template<typename... T> static void print(T&& ...messages) {
-        (printUnpacked_(INFO, messages), ...);
-        std::cout << std::endl;
+        write_<INFO>(0, true, messages...);
     }
 };
 
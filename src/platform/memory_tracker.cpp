@@ -0,0 +1,325 @@
+/**
+ * memory_tracker.cpp - Heap allocation tracking definition
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "logger.hpp"
+#include "memory_tracker.hpp"
+
+namespace {
+
+/**
+ * @brief Live counters of a single subsystem.
+ */
+struct tag_counters {
+    std::atomic<uint64_t> liveBytes {0};
+    std::atomic<uint64_t> peakBytes {0};
+    std::atomic<uint64_t> liveAllocations {0};
+    std::atomic<uint64_t> totalAllocations {0};
+    std::atomic<uint64_t> frameAllocations {0};
+    std::atomic<uint64_t> frameBytes {0};
+    std::atomic<uint64_t> lastFrameAllocations {0};
+    std::atomic<uint64_t> lastFrameBytes {0};
+};
+
+tag_counters s_counters[dino::MemoryTracker::TAG_COUNT];
+
+/* Bytes live across every subsystem and their high-water mark. Summing the
+ * peaks of the tags would overstate it, they rarely peak at the same time. */
+std::atomic<uint64_t> s_liveBytes {0};
+std::atomic<uint64_t> s_peakBytes {0};
+
+thread_local int s_currentTag = dino::MemoryTracker::UNTAGGED;
+
+const char* s_tagNames[dino::MemoryTracker::TAG_COUNT] = {
+    "untagged",
+    "renderer",
+    "audio",
+    "game",
+    "assets"
+};
+
+} // namespace
+
+#if defined(DINO_MODE_TRACK_ALLOC) && DINO_MODE_TRACK_ALLOC == 1
+
+namespace {
+
+/**
+ * @brief Bookkeeping stored right in front of every tracked block.
+ */
+struct block_header {
+    void* base;
+    std::size_t size;
+    int tag;
+};
+
+constexpr std::size_t HEADER_SIZE = sizeof(block_header);
+
+void raisePeak_(std::atomic<uint64_t>& peak_bytes, uint64_t live) {
+    uint64_t peak = peak_bytes.load(std::memory_order_relaxed);
+
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void recordAllocation_(int tag, std::size_t size) {
+    auto& counters = s_counters[tag];
+
+    raisePeak_(counters.peakBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    raisePeak_(s_peakBytes, s_liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* trackedAllocate_(std::size_t size, std::size_t alignment) noexcept {
+    if (alignment < alignof(std::max_align_t)) {
+        alignment = alignof(std::max_align_t);
+    }
+
+    auto base = static_cast<char*>(std::malloc(size + alignment + HEADER_SIZE));
+
+    if (base == nullptr) {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<std::uintptr_t>(base) + HEADER_SIZE;
+    address = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+
+    auto header = reinterpret_cast<block_header*>(address - HEADER_SIZE);
+    header->base = base;
+    header->size = size;
+    header->tag  = s_currentTag;
+
+    recordAllocation_(header->tag, size);
+
+    return reinterpret_cast<void*>(address);
+}
+
+void trackedFree_(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return void();
+    }
+
+    auto header = reinterpret_cast<block_header*>(static_cast<char*>(pointer) - HEADER_SIZE);
+    auto& counters = s_counters[header->tag];
+
+    counters.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    s_liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+    std::free(header->base);
+}
+
+void* throwingAllocate_(std::size_t size, std::size_t alignment) {
+    void* pointer = trackedAllocate_(size, alignment);
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return throwingAllocate_(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size) {
+    return throwingAllocate_(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return throwingAllocate_(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return throwingAllocate_(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate_(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate_(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate_(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate_(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree_(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree_(pointer);
+}
+
+#endif // DINO_MODE_TRACK_ALLOC
+
+bool dino::MemoryTracker::isEnabled() {
+#if defined(DINO_MODE_TRACK_ALLOC) && DINO_MODE_TRACK_ALLOC == 1
+    return true;
+#else
+    return false;
+#endif
+}
+
+void dino::MemoryTracker::beginFrame() {
+    for (auto& counters : s_counters) {
+        counters.lastFrameAllocations.store(counters.frameAllocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        counters.lastFrameBytes.store(counters.frameBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+dino::MemoryStats dino::MemoryTracker::getStats(int tag) {
+    dino::MemoryStats stats {};
+
+    if (tag < 0 || tag >= TAG_COUNT) {
+        return stats;
+    }
+
+    auto& counters = s_counters[tag];
+
+    stats.liveBytes        = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes        = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.liveAllocations  = counters.liveAllocations.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    stats.frameAllocations = counters.lastFrameAllocations.load(std::memory_order_relaxed);
+    stats.frameBytes       = counters.lastFrameBytes.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+dino::MemoryStats dino::MemoryTracker::getTotalStats() {
+    dino::MemoryStats total {};
+
+    for (int tag = 0; tag < TAG_COUNT; tag++) {
+        auto stats = getStats(tag);
+
+        total.liveBytes        += stats.liveBytes;
+        total.liveAllocations  += stats.liveAllocations;
+        total.totalAllocations += stats.totalAllocations;
+        total.frameAllocations += stats.frameAllocations;
+        total.frameBytes       += stats.frameBytes;
+    }
+
+    total.peakBytes = s_peakBytes.load(std::memory_order_relaxed);
+
+    return total;
+}
+
+int dino::MemoryTracker::getCurrentTag() {
+    return s_currentTag;
+}
+
+int dino::MemoryTracker::setCurrentTag(int tag) {
+    int previous = s_currentTag;
+
+    if (tag >= 0 && tag < TAG_COUNT) {
+        s_currentTag = tag;
+    }
+
+    return previous;
+}
+
+const char* dino::MemoryTracker::getTagName(int tag) {
+    if (tag < 0 || tag >= TAG_COUNT) {
+        return "unknown";
+    }
+
+    return s_tagNames[tag];
+}
+
+void dino::MemoryTracker::printReport() {
+    dino::Logger::print("Heap Statistics");
+    dino::Logger::print("***************");
+
+    for (int tag = 0; tag < TAG_COUNT; tag++) {
+        auto stats = getStats(tag);
+
+        dino::Logger::print(getTagName(tag), "live:", stats.liveBytes, "bytes in", stats.liveAllocations,
+                "blocks, peak:", stats.peakBytes, "bytes, last frame:", stats.frameAllocations, "allocations");
+    }
+
+    dino::Logger::print("total peak:", getTotalStats().peakBytes, "bytes");
+}
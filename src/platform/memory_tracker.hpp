@@ -0,0 +1,163 @@
+/**
+ * memory_tracker.hpp - Heap allocation tracking declaration
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dino {
+
+/**
+ * @brief Heap statistics of a single subsystem.
+ */
+struct memory_stats {
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;
+    uint64_t liveAllocations = 0;
+    uint64_t totalAllocations = 0;
+
+    /**
+     * @brief Allocations made during the last completed frame.
+     */
+    uint64_t frameAllocations = 0;
+
+    /**
+     * @brief Bytes allocated during the last completed frame.
+     */
+    uint64_t frameBytes = 0;
+};
+
+typedef struct memory_stats MemoryStats;
+
+/**
+ * @brief Tracks heap allocations made through global new and delete.
+ *
+ * Tracking is opt-in. The global allocation functions are replaced only
+ * when the platform library is compiled with DINO_MODE_TRACK_ALLOC=1,
+ * otherwise every statistic reads as zero.
+ *
+ * Allocations are attributed to the subsystem tag that is active on the
+ * allocating thread, see dino::MemoryScope.
+ */
+class MemoryTracker {
+
+public:
+    enum MemoryTag : int {
+        UNTAGGED = 0,
+        RENDERER,
+        AUDIO,
+        GAME,
+        ASSETS,
+        TAG_COUNT
+    };
+
+    /**
+     * @brief Checks if allocation tracking is compiled in.
+     * @return True if enabled, false otherwise.
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Closes the current frame.
+     *
+     * The per-frame counters of every tag are latched and restarted.
+     */
+    static void beginFrame();
+
+    /**
+     * @brief Returns the statistics of a subsystem.
+     * @param tag The subsystem tag.
+     * @return The statistics.
+     */
+    static MemoryStats getStats(int);
+
+    /**
+     * @brief Returns the statistics summed over all subsystems.
+     *
+     * The peak is the highest number of bytes live at once across all
+     * subsystems, not the sum of their individual peaks.
+     *
+     * @return The statistics.
+     */
+    static MemoryStats getTotalStats();
+
+    /**
+     * @brief Returns the subsystem tag active on the calling thread.
+     * @return The subsystem tag.
+     */
+    static int getCurrentTag();
+
+    /**
+     * @brief Sets the subsystem tag on the calling thread.
+     * @param tag The subsystem tag.
+     * @return The previously active tag.
+     */
+    static int setCurrentTag(int);
+
+    /**
+     * @brief Returns a printable name for a subsystem tag.
+     * @param tag The subsystem tag.
+     * @return The tag name.
+     */
+    static const char* getTagName(int);
+
+    /**
+     * @brief Prints the statistics of every subsystem.
+     */
+    static void printReport();
+};
+
+/**
+ * @brief Attributes allocations to a subsystem for the lifetime of the scope.
+ */
+class MemoryScope {
+
+private:
+    int m_previousTag;
+
+public:
+    /**
+     * @brief Activates a subsystem tag on the calling thread.
+     * @param tag The subsystem tag.
+     */
+    explicit MemoryScope(int tag) : m_previousTag(MemoryTracker::setCurrentTag(tag)) {}
+
+    /**
+     * @brief Restores the previously active tag.
+     */
+    ~MemoryScope() {
+        MemoryTracker::setCurrentTag(m_previousTag);
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+
+    MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+} // namespace dino
@@ -0,0 +1,191 @@
+/**
+ * spsc_ring.hpp - Lock-free single producer single consumer ring buffer
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace dino {
+
+/**
+ * @brief Fixed capacity ring buffer for exactly one producer and one consumer.
+ *
+ * The producer and the consumer may run on different threads without
+ * any locking. The storage is allocated once by the constructor.
+ *
+ * @tparam T Element type, must be copy assignable.
+ */
+template<typename T>
+class SpscRing {
+
+private:
+    std::vector<T> m_buffer;
+    std::size_t m_mask;
+
+    /**
+     * @brief Total number of elements read, owned by the consumer.
+     */
+    alignas(64) std::atomic<std::size_t> m_readIndex {0};
+
+    /**
+     * @brief Total number of elements written, owned by the producer.
+     */
+    alignas(64) std::atomic<std::size_t> m_writeIndex {0};
+
+    static std::size_t roundCapacity_(std::size_t capacity) {
+        std::size_t rounded = 1;
+
+        while (rounded < capacity) {
+            rounded = rounded << 1;
+        }
+
+        return rounded;
+    }
+
+public:
+    /**
+     * @brief Allocates the ring storage.
+     * @param capacity Minimum capacity, rounded up to a power of two.
+     */
+    explicit SpscRing(std::size_t capacity) :
+            m_buffer(roundCapacity_(capacity)),
+            m_mask(roundCapacity_(capacity) - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Appends an element. Producer only.
+     * @param value The element.
+     * @return True if appended, false if the ring is full.
+     */
+    bool push(const T& value) {
+        std::size_t write_index = m_writeIndex.load(std::memory_order_relaxed);
+
+        if (write_index - m_readIndex.load(std::memory_order_acquire) > m_mask) {
+            return false;
+        }
+
+        m_buffer[write_index & m_mask] = value;
+        m_writeIndex.store(write_index + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element. Consumer only.
+     * @param value Receives the element.
+     * @return True if an element was removed, false if the ring is empty.
+     */
+    bool pop(T& value) {
+        std::size_t read_index = m_readIndex.load(std::memory_order_relaxed);
+
+        if (read_index == m_writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = m_buffer[read_index & m_mask];
+        m_readIndex.store(read_index + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Appends as many elements as fit. Producer only.
+     * @param values The elements.
+     * @param count Number of elements.
+     * @return Number of elements appended.
+     */
+    std::size_t write(const T* values, std::size_t count) {
+        std::size_t write_index = m_writeIndex.load(std::memory_order_relaxed);
+        std::size_t space = m_buffer.size() - (write_index - m_readIndex.load(std::memory_order_acquire));
+
+        count = std::min(count, space);
+
+        std::size_t offset = write_index & m_mask;
+        std::size_t first  = std::min(count, m_buffer.size() - offset);
+
+        std::copy(values, values + first, m_buffer.begin() + offset);
+        std::copy(values + first, values + count, m_buffer.begin());
+
+        m_writeIndex.store(write_index + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Removes as many elements as available. Consumer only.
+     * @param values Receives the elements.
+     * @param count Maximum number of elements.
+     * @return Number of elements removed.
+     */
+    std::size_t read(T* values, std::size_t count) {
+        std::size_t read_index = m_readIndex.load(std::memory_order_relaxed);
+        std::size_t available  = m_writeIndex.load(std::memory_order_acquire) - read_index;
+
+        count = std::min(count, available);
+
+        std::size_t offset = read_index & m_mask;
+        std::size_t first  = std::min(count, m_buffer.size() - offset);
+
+        std::copy(m_buffer.begin() + offset, m_buffer.begin() + offset + first, values);
+        std::copy(m_buffer.begin(), m_buffer.begin() + (count - first), values + first);
+
+        m_readIndex.store(read_index + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Discards every element. Consumer only.
+     */
+    void drain() {
+        m_readIndex.store(m_writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns the number of elements in the ring.
+     * @return Number of elements, exact only when called by either side.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the capacity of the ring.
+     * @return Number of elements the ring can hold.
+     */
+    [[nodiscard]] std::size_t capacity() const {
+        return m_buffer.size();
+    }
+};
+
+} // namespace dino
@@ -0,0 +1,456 @@
+/**
+ * virtual_filesystem.cpp - Mountable asset filesystem
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "standard.hpp"
+#include "virtual_filesystem.hpp"
+
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+#include <windows.h>
+#endif
+
+/* Magic, version, entry count and index size. */
+#define DINO_PACK_HEADER_SIZE 16
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class dino::VirtualFilesystem::MappedFile {
+
+private:
+    const uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+
+#if defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+        int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat status {};
+
+        if (descriptor < 0) {
+            return;
+        }
+
+        if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            void* address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+            if (address != MAP_FAILED) {
+                m_data = static_cast<const uint8_t*>(address);
+                m_size = status.st_size;
+            }
+        }
+
+        /* The mapping keeps the file referenced. */
+        close(descriptor);
+
+#elif defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+        LARGE_INTEGER size;
+
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+            return;
+        }
+
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (m_mapping != nullptr) {
+            m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            m_size = m_data != nullptr ? static_cast<std::size_t>(size.QuadPart) : 0;
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(DINO_OS_TYPE_LINUX) && DINO_OS_TYPE_LINUX == 1
+        if (m_data != nullptr) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+
+#elif defined(DINO_OS_TYPE_WINDOWS) && DINO_OS_TYPE_WINDOWS == 1
+        if (m_data != nullptr) {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const uint8_t* data() const {
+        return m_data;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_size;
+    }
+};
+
+namespace {
+
+template<typename T>
+bool readValue_(const uint8_t* data, std::size_t size, std::size_t* offset, T* value) {
+    if (size - *offset < sizeof(T)) {
+        return false;
+    }
+
+    std::memcpy(value, data + *offset, sizeof(T));
+    *offset = *offset + sizeof(T);
+
+    return true;
+}
+
+template<typename T>
+bool writeValue_(FILE* file, T value) {
+    return std::fwrite(&value, sizeof(T), 1, file) == 1;
+}
+
+bool readFile_(const std::string& path, std::vector<uint8_t>* buffer) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool is_read = std::fseek(file, 0, SEEK_END) == 0;
+    long size = is_read ? std::ftell(file) : -1;
+
+    is_read = size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+
+    if (is_read) {
+        buffer->resize(size);
+        is_read = size == 0 || std::fread(buffer->data(), 1, size, file) == static_cast<std::size_t>(size);
+    }
+
+    std::fclose(file);
+    return is_read;
+}
+
+bool hasPrefix_(std::string_view name, const std::string& prefix) {
+    return name.size() >= prefix.size() && name.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+uint64_t dino::VirtualFilesystem::hash_(std::string_view name) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (char character : name) {
+        hash = (hash ^ static_cast<uint8_t>(character)) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+void dino::VirtualFilesystem::resolve_(path_entry& entry) const {
+    std::string_view name(entry.name);
+    FileView packed_view {};
+    int found_mount = -1;
+
+    /* Latest mount first, a pack wins over any directory. */
+    for (int index = static_cast<int>(m_mounts.size()) - 1; index >= 0; index--) {
+        const mount_point& mount = *(m_mounts[index]);
+
+        if (!hasPrefix_(name, mount.prefix)) {
+            continue;
+        }
+
+        std::string relative(name.substr(mount.prefix.size()));
+
+        if (mount.pack != nullptr) {
+            auto packed = mount.entries.find(relative);
+
+            if (packed != mount.entries.end()) {
+                packed_view = FileView {mount.pack->data() + packed->second.offset, static_cast<std::size_t>(packed->second.size)};
+                found_mount = index;
+                break;
+            }
+
+        } else if (found_mount < 0 && std::filesystem::is_regular_file(mount.directory + relative)) {
+            found_mount = index;
+        }
+    }
+
+    if (found_mount == entry.mount) {
+        return;
+    }
+
+    /* Bytes read from the previous mount are stale, packed bytes need no read. */
+    std::vector<uint8_t>().swap(entry.buffer);
+
+    entry.mount = found_mount;
+    entry.view  = packed_view;
+}
+
+void dino::VirtualFilesystem::resolveAll_() {
+    for (auto& entry : m_paths) {
+        resolve_(entry);
+    }
+}
+
+dino::VirtualFilesystem::VirtualFilesystem() = default;
+
+dino::VirtualFilesystem::~VirtualFilesystem() = default;
+
+bool dino::VirtualFilesystem::mountDirectory(const std::string& directory, const std::string& prefix) {
+    if (!std::filesystem::is_directory(directory)) {
+        return false;
+    }
+
+    auto mount = std::make_unique<mount_point>();
+    mount->prefix    = prefix;
+    mount->directory = std::filesystem::absolute(directory).lexically_normal().string();
+
+    if (mount->directory.back() != '/' && mount->directory.back() != '\\') {
+        mount->directory.push_back('/');
+    }
+
+    m_mounts.push_back(std::move(mount));
+    resolveAll_();
+
+    return true;
+}
+
+bool dino::VirtualFilesystem::mountPack(const std::string& pack_file, const std::string& prefix) {
+    auto mount = std::make_unique<mount_point>();
+    mount->prefix = prefix;
+    mount->pack   = std::make_unique<MappedFile>(pack_file);
+
+    const uint8_t* data = mount->pack->data();
+    std::size_t size = mount->pack->size();
+    std::size_t offset = 0;
+
+    char magic[sizeof(DINO_PACK_MAGIC) - 1];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    uint32_t index_size = 0;
+
+    if (data == nullptr || size < DINO_PACK_HEADER_SIZE) {
+        return false;
+    }
+
+    std::memcpy(magic, data, sizeof(magic));
+    offset = sizeof(magic);
+
+    if (std::memcmp(magic, DINO_PACK_MAGIC, sizeof(magic)) != 0 || !readValue_(data, size, &offset, &version) ||
+            !readValue_(data, size, &offset, &count) || !readValue_(data, size, &offset, &index_size) ||
+            version != DINO_PACK_VERSION || index_size > size - offset) {
+        return false;
+    }
+
+    /* Index entries are bounded by the index, file data by the pack. */
+    std::size_t index_end = offset + index_size;
+
+    for (uint32_t index = 0; index < count; index++) {
+        pack_entry entry {};
+        uint16_t name_length = 0;
+
+        if (!readValue_(data, index_end, &offset, &(entry.offset)) || !readValue_(data, index_end, &offset, &(entry.size)) ||
+                !readValue_(data, index_end, &offset, &name_length) || index_end - offset < name_length ||
+                entry.offset > size || entry.size > size - entry.offset) {
+            return false;
+        }
+
+        mount->entries.emplace(std::string(reinterpret_cast<const char*>(data + offset), name_length), entry);
+        offset = offset + name_length;
+    }
+
+    m_mounts.push_back(std::move(mount));
+    resolveAll_();
+
+    return true;
+}
+
+dino::PathId dino::VirtualFilesystem::intern(std::string_view name) {
+    uint64_t hash = hash_(name);
+
+    for (auto found = m_pathIds.find(hash); found != m_pathIds.end(); found = m_pathIds.find(++hash)) {
+        if (m_paths[found->second].name == name) {
+            return found->second;
+        }
+    }
+
+    auto path_id = static_cast<PathId>(m_paths.size());
+
+    m_paths.emplace_back();
+    m_paths.back().name = std::string(name);
+    resolve_(m_paths.back());
+
+    m_pathIds.emplace(hash, path_id);
+    return path_id;
+}
+
+dino::PathId dino::VirtualFilesystem::find(std::string_view name) const {
+    uint64_t hash = hash_(name);
+
+    for (auto found = m_pathIds.find(hash); found != m_pathIds.end(); found = m_pathIds.find(++hash)) {
+        if (m_paths[found->second].name == name) {
+            return found->second;
+        }
+    }
+
+    return INVALID_PATH;
+}
+
+bool dino::VirtualFilesystem::exists(PathId path_id) const {
+    return path_id < m_paths.size() && m_paths[path_id].mount >= 0;
+}
+
+dino::FileView dino::VirtualFilesystem::read(PathId path_id) {
+    if (!exists(path_id)) {
+        return FileView {};
+    }
+
+    path_entry& entry = m_paths[path_id];
+
+    if (entry.view.empty() && readFile_(getRealPath(path_id), &(entry.buffer))) {
+        /* An empty file still gets a valid pointer. */
+        entry.buffer.reserve(1);
+        entry.view = FileView {entry.buffer.data(), entry.buffer.size()};
+    }
+
+    return entry.view;
+}
+
+void dino::VirtualFilesystem::release(PathId path_id) {
+    if (path_id >= m_paths.size() || m_paths[path_id].buffer.capacity() == 0) {
+        return;
+    }
+
+    m_paths[path_id].view = FileView {};
+    std::vector<uint8_t>().swap(m_paths[path_id].buffer);
+}
+
+const std::string& dino::VirtualFilesystem::getName(PathId path_id) const {
+    return m_paths.at(path_id).name;
+}
+
+std::string dino::VirtualFilesystem::getRealPath(PathId path_id) const {
+    if (!exists(path_id)) {
+        return std::string();
+    }
+
+    const path_entry& entry = m_paths[path_id];
+    const mount_point& mount = *(m_mounts[entry.mount]);
+
+    if (mount.pack != nullptr) {
+        return std::string();
+    }
+
+    return mount.directory + entry.name.substr(mount.prefix.size());
+}
+
+bool dino::VirtualFilesystem::writePack(const std::string& pack_file, const std::string& directory, const std::vector<std::string>& names) {
+    std::vector<std::vector<uint8_t>> contents(names.size());
+
+    for (std::size_t index = 0; index < names.size(); index++) {
+        if (!readFile_((std::filesystem::path(directory) / names[index]).string(), &contents[index])) {
+            return false;
+        }
+    }
+
+    return writePack(pack_file, names, contents);
+}
+
+bool dino::VirtualFilesystem::writePack(const std::string& pack_file, const std::vector<std::string>& names, const std::vector<std::vector<uint8_t>>& contents) {
+    std::vector<uint64_t> offsets(names.size());
+    uint32_t index_size = 0;
+
+    if (contents.size() != names.size()) {
+        return false;
+    }
+
+    for (auto& name : names) {
+        if (name.size() > UINT16_MAX) {
+            return false;
+        }
+
+        index_size = index_size + sizeof(uint64_t) * 2 + sizeof(uint16_t) + name.size();
+    }
+
+    uint64_t offset = DINO_PACK_HEADER_SIZE + index_size;
+
+    for (std::size_t index = 0; index < names.size(); index++) {
+        offset = (offset + DINO_PACK_ALIGNMENT - 1) & ~static_cast<uint64_t>(DINO_PACK_ALIGNMENT - 1);
+        offsets[index] = offset;
+        offset = offset + contents[index].size();
+    }
+
+    FILE* file = std::fopen(pack_file.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool is_written = std::fwrite(DINO_PACK_MAGIC, 1, sizeof(DINO_PACK_MAGIC) - 1, file) == sizeof(DINO_PACK_MAGIC) - 1 &&
+            writeValue_<uint32_t>(file, DINO_PACK_VERSION) && writeValue_<uint32_t>(file, names.size()) &&
+            writeValue_<uint32_t>(file, index_size);
+
+    for (std::size_t index = 0; is_written && index < names.size(); index++) {
+        is_written = writeValue_<uint64_t>(file, offsets[index]) && writeValue_<uint64_t>(file, contents[index].size()) &&
+                writeValue_<uint16_t>(file, names[index].size()) &&
+                std::fwrite(names[index].data(), 1, names[index].size(), file) == names[index].size();
+    }
+
+    for (std::size_t index = 0; is_written && index < names.size(); index++) {
+        long padding = static_cast<long>(offsets[index]) - std::ftell(file);
+        static const uint8_t zeros[DINO_PACK_ALIGNMENT] = {};
+
+        is_written = padding >= 0 && std::fwrite(zeros, 1, padding, file) == static_cast<std::size_t>(padding) &&
+                (contents[index].empty() || std::fwrite(contents[index].data(), 1, contents[index].size(), file) == contents[index].size());
+    }
+
+    is_written = std::fclose(file) == 0 && is_written;
+    return is_written;
+}
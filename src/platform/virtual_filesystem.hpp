@@ -0,0 +1,262 @@
+/**
+ * virtual_filesystem.hpp - Mountable asset filesystem
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/* First bytes of an asset pack. */
+#define DINO_PACK_MAGIC "DPAK"
+#define DINO_PACK_VERSION 1
+
+/* Alignment of every file in an asset pack. */
+#define DINO_PACK_ALIGNMENT 16
+
+namespace dino {
+
+/**
+ * @brief Interned asset path, valid for the lifetime of the filesystem that issued it.
+ */
+typedef uint32_t PathId;
+
+/**
+ * @brief Read-only bytes of a file.
+ *
+ * The view does not own the bytes, they stay valid until the file is
+ * released or the filesystem is destroyed.
+ */
+struct file_view {
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    [[nodiscard]] bool empty() const {
+        return data == nullptr;
+    }
+};
+
+typedef struct file_view FileView;
+
+/**
+ * @brief Serves asset files from mounted directories and asset packs.
+ *
+ * Asset names are relative paths with forward slashes, e.g.
+ * texture/world-bg.png. A name is interned once into a PathId, which
+ * also resolves the mount serving it, so reading by id needs no string
+ * handling and no allocation beyond the file itself.
+ *
+ * Asset packs are memory mapped when mounted and read without copying,
+ * so they are searched before directories. Among mounts of the same
+ * kind the latest one wins. Files from directories are read into memory
+ * on the first read and kept until released.
+ *
+ * An instance is not thread safe, use it from the thread that loads assets.
+ */
+class VirtualFilesystem {
+
+public:
+    static constexpr PathId INVALID_PATH = UINT32_MAX;
+
+private:
+    class MappedFile;
+
+    struct pack_entry {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct mount_point {
+        /**
+         * @brief Names under this prefix are served by the mount, empty serves every name.
+         */
+        std::string prefix;
+
+        /**
+         * @brief Root directory with a trailing separator, empty for packs.
+         */
+        std::string directory;
+
+        std::unique_ptr<MappedFile> pack;
+
+        /**
+         * @brief Pack entries by name relative to the prefix.
+         */
+        std::unordered_map<std::string, pack_entry> entries;
+    };
+
+    struct path_entry {
+        std::string name;
+
+        /**
+         * @brief Index of the serving mount, -1 if no mount has the file.
+         */
+        int mount = -1;
+
+        /**
+         * @brief Bytes of the file, set when resolved to a pack or on the first read.
+         */
+        FileView view {};
+
+        /**
+         * @brief Holds the bytes of a file read from a directory.
+         */
+        std::vector<uint8_t> buffer;
+    };
+
+    std::vector<std::unique_ptr<mount_point>> m_mounts;
+
+    std::vector<path_entry> m_paths;
+
+    /**
+     * @brief Path ids by hash of their name, collisions move to the next hash.
+     */
+    std::unordered_map<uint64_t, PathId> m_pathIds;
+
+    /**
+     * @brief Hashes a name, FNV-1a.
+     * @param name The name.
+     * @return 64 bit hash.
+     */
+    static uint64_t hash_(std::string_view);
+
+    /**
+     * @brief Picks the mount serving a path.
+     * @param entry The path entry.
+     */
+    void resolve_(path_entry&) const;
+
+    /**
+     * @brief Resolves every interned path again after a mount.
+     */
+    void resolveAll_();
+
+public:
+    VirtualFilesystem();
+
+    /**
+     * @brief Unmaps the packs and frees the files read.
+     */
+    ~VirtualFilesystem();
+
+    VirtualFilesystem(const VirtualFilesystem&) = delete;
+
+    VirtualFilesystem& operator=(const VirtualFilesystem&) = delete;
+
+    /**
+     * @brief Serves files from a directory.
+     * @param directory Path to the directory.
+     * @param prefix Names the mount serves, e.g. texture/, empty for every name.
+     * @return True if mounted, false if the directory does not exist.
+     */
+    bool mountDirectory(const std::string&, const std::string& prefix = "");
+
+    /**
+     * @brief Serves files from an asset pack.
+     * @param pack_file Path to the pack written by writePack().
+     * @param prefix Names the mount serves, empty for every name.
+     * @return True if mounted, false if the pack is missing or damaged.
+     */
+    bool mountPack(const std::string&, const std::string& prefix = "");
+
+    /**
+     * @brief Interns an asset name.
+     * @param name Relative path with forward slashes.
+     * @return The path id, the same for every call with the same name.
+     */
+    PathId intern(std::string_view);
+
+    /**
+     * @brief Looks up an interned name without allocating.
+     * @param name Relative path with forward slashes.
+     * @return The path id, INVALID_PATH if the name was never interned.
+     */
+    [[nodiscard]] PathId find(std::string_view) const;
+
+    /**
+     * @brief Checks if a mount has the file.
+     * @param path_id The path id.
+     * @return True if the file can be read.
+     */
+    [[nodiscard]] bool exists(PathId) const;
+
+    /**
+     * @brief Returns the bytes of a file.
+     * @param path_id The path id.
+     * @return The bytes, an empty view if the file cannot be read.
+     *
+     * Packed files are returned in place. Other files are read on the
+     * first call and returned from memory afterwards.
+     */
+    FileView read(PathId);
+
+    /**
+     * @brief Frees the memory held for a file read from a directory.
+     * @param path_id The path id, views of it become invalid.
+     */
+    void release(PathId);
+
+    /**
+     * @brief Returns the name of an interned path.
+     * @param path_id The path id.
+     * @return The name.
+     */
+    [[nodiscard]] const std::string& getName(PathId) const;
+
+    /**
+     * @brief Returns the file on disk serving a path.
+     * @param path_id The path id.
+     * @return Absolute path, empty if the file is packed or missing.
+     */
+    [[nodiscard]] std::string getRealPath(PathId) const;
+
+    /**
+     * @brief Writes an asset pack.
+     * @param pack_file Path of the pack to write.
+     * @param directory Root the names are relative to.
+     * @param names Files to pack, relative paths with forward slashes.
+     * @return True on success, false if a file cannot be read or the pack cannot be written.
+     */
+    static bool writePack(const std::string&, const std::string&, const std::vector<std::string>&);
+
+    /**
+     * @brief Writes an asset pack from files in memory.
+     * @param pack_file Path of the pack to write.
+     * @param names Names of the files, relative paths with forward slashes.
+     * @param contents Bytes of each file.
+     * @return True on success, false if the pack cannot be written.
+     */
+    static bool writePack(const std::string&, const std::vector<std::string>&, const std::vector<std::vector<uint8_t>>&);
+};
+
+} // namespace dino
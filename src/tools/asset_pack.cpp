@@ -0,0 +1,171 @@
+/**
+ * asset_pack.cpp - Asset pack writer
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "platform/virtual_filesystem.hpp"
+#include "engine/sprite_material.hpp"
+
+namespace {
+
+/**
+ * @brief Texture formats raw images can be stored in.
+ */
+struct texture_format {
+    const char* name;
+    uint32_t pixelFormat;
+};
+
+const texture_format s_textureFormats[] = {
+        {"ARGB8888", SDL_PIXELFORMAT_ARGB8888},
+        {"ABGR8888", SDL_PIXELFORMAT_ABGR8888},
+        {"RGBA8888", SDL_PIXELFORMAT_RGBA8888},
+        {"BGRA8888", SDL_PIXELFORMAT_BGRA8888}
+};
+
+bool findTextureFormat_(const char* name, uint32_t* pixel_format) {
+    for (auto& format : s_textureFormats) {
+        if (std::strcmp(format.name, name) == 0) {
+            *pixel_format = format.pixelFormat;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool isImage_(const std::string& name) {
+    auto extension = std::filesystem::path(name).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [] (unsigned char character) {
+        return std::tolower(character);
+    });
+
+    return extension == ".png" || extension == ".jpg" || extension == ".bmp";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t pixel_format = SDL_PIXELFORMAT_UNKNOWN;
+    int first = 1;
+
+    if (argc > 2 && std::strcmp(argv[1], "--texture-format") == 0) {
+        if (!findTextureFormat_(argv[2], &pixel_format)) {
+            std::fprintf(stderr, "Unknown texture format %s, use ARGB8888, ABGR8888, RGBA8888 or BGRA8888.\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+
+        first = 3;
+    }
+
+    if (argc - first < 2) {
+        std::fprintf(stderr, "Usage: %s [--texture-format <format>] <pack file> <root directory> [directory...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char* pack_file = argv[first];
+    std::filesystem::path root(argv[first + 1]);
+    std::vector<std::string> names;
+    std::error_code error;
+
+    /* Every file under the root unless directories below it are given. */
+    std::vector<std::filesystem::path> directories;
+
+    for (int index = first + 2; index < argc; index++) {
+        directories.push_back(root / argv[index]);
+    }
+
+    if (directories.empty()) {
+        directories.push_back(root);
+    }
+
+    for (auto& directory : directories) {
+        for (auto iterator = std::filesystem::recursive_directory_iterator(directory, error);
+                !error && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(error)) {
+
+            if (iterator->is_regular_file()) {
+                names.push_back(iterator->path().lexically_relative(root).generic_string());
+            }
+        }
+
+        if (error) {
+            std::fprintf(stderr, "Unable to read %s: %s\n", directory.string().c_str(), error.message().c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Sorted names keep the pack identical across runs. */
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    dino::VirtualFilesystem filesystem;
+    filesystem.mountDirectory(root.string());
+
+    std::vector<std::vector<uint8_t>> contents(names.size());
+
+    for (std::size_t index = 0; index < names.size(); index++) {
+        auto path_id = filesystem.intern(names[index]);
+        auto view = filesystem.read(path_id);
+
+        if (view.empty()) {
+            std::fprintf(stderr, "Unable to read %s\n", names[index].c_str());
+            return EXIT_FAILURE;
+        }
+
+        /* Images become raw images the game uploads without decoding. */
+        if (pixel_format != SDL_PIXELFORMAT_UNKNOWN && isImage_(names[index])) {
+            if (!dino::SpriteMaterial::encodeRaw(view, pixel_format, &contents[index])) {
+                std::fprintf(stderr, "Unable to convert %s: %s\n", names[index].c_str(), SDL_GetError());
+                return EXIT_FAILURE;
+            }
+
+            names[index] = std::filesystem::path(names[index]).replace_extension(DINO_RAW_IMAGE_EXTENSION).generic_string();
+
+        } else {
+            contents[index].assign(view.data, view.data + view.size);
+        }
+
+        filesystem.release(path_id);
+    }
+
+    if (!dino::VirtualFilesystem::writePack(pack_file, names, contents)) {
+        std::fprintf(stderr, "Unable to write %s\n", pack_file);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Packed %zu files into %s\n", names.size(), pack_file);
+    return EXIT_SUCCESS;
+}
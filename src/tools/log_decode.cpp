@@ -0,0 +1,173 @@
+/**
+ * log_decode.cpp - Offline decoder for binary logs
+ * -------------------------------------------------------------------------------
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022-present Ajay Sreedhar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "platform/log_format.hpp"
+
+namespace {
+
+/**
+ * @brief A call site described by a format entry.
+ */
+struct decoded_site {
+    int level = 0;
+    uint32_t line = 0;
+    std::string file;
+    std::string format;
+};
+
+template<typename T>
+bool readValue_(FILE* file, T* value) {
+    return std::fread(value, sizeof(T), 1, file) == 1;
+}
+
+bool readText_(FILE* file, std::string* text) {
+    uint16_t length = 0;
+
+    if (!readValue_(file, &length)) {
+        return false;
+    }
+
+    text->resize(length);
+    return length == 0 || std::fread(text->data(), 1, length, file) == length;
+}
+
+bool readSite_(FILE* file, std::vector<decoded_site>* sites) {
+    uint32_t format_id = 0;
+    uint8_t level = 0;
+    decoded_site site;
+
+    if (!readValue_(file, &format_id) || !readValue_(file, &level) || !readValue_(file, &(site.line)) ||
+            !readText_(file, &(site.file)) || !readText_(file, &(site.format)) || format_id == 0) {
+        return false;
+    }
+
+    site.level = level;
+
+    if (format_id > sites->size()) {
+        sites->resize(format_id);
+    }
+
+    (*sites)[format_id - 1] = site;
+    return true;
+}
+
+bool readMessage_(FILE* file, const std::vector<decoded_site>& sites, bool with_location, std::string* line) {
+    uint32_t format_id = 0;
+    uint8_t level = 0;
+    uint8_t is_plain = 0;
+    uint16_t size = 0;
+    uint8_t payload[DINO_LOG_PAYLOAD_SIZE];
+
+    if (!readValue_(file, &format_id) || !readValue_(file, &level) || !readValue_(file, &is_plain) ||
+            !readValue_(file, &size) || size > DINO_LOG_PAYLOAD_SIZE || std::fread(payload, 1, size, file) != size) {
+        return false;
+    }
+
+    const decoded_site* site = format_id > 0 && format_id <= sites.size() ? &sites[format_id - 1] : nullptr;
+    line->clear();
+
+    if (is_plain == 0) {
+        line->append(dino::LogFormat::getLevelLabel(level));
+    }
+
+    if (with_location && site != nullptr) {
+        line->append(site->file).append(":").append(std::to_string(site->line)).append(" ");
+    }
+
+    dino::LogFormat::render(*line, site != nullptr ? site->format.c_str() : nullptr, payload, size);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool with_location = argc > 2 && std::strcmp(argv[1], "--location") == 0;
+    const char* path = argc > 1 ? argv[argc - 1] : nullptr;
+
+    if (path == nullptr || (argc > 2 && !with_location)) {
+        std::fprintf(stderr, "Usage: %s [--location] <binary log>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* file = std::fopen(path, "rb");
+
+    if (file == nullptr) {
+        std::fprintf(stderr, "Unable to open %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    char magic[sizeof(DINO_LOG_FILE_MAGIC) - 1];
+
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, DINO_LOG_FILE_MAGIC, sizeof(magic)) != 0) {
+        std::fprintf(stderr, "%s is not a binary log.\n", path);
+        std::fclose(file);
+
+        return EXIT_FAILURE;
+    }
+
+    std::vector<decoded_site> sites;
+    std::string line;
+    bool is_valid = true;
+    int kind;
+
+    while (is_valid && (kind = std::fgetc(file)) != EOF) {
+        switch (kind) {
+            case dino::LogFormat::ENTRY_FORMAT:
+                is_valid = readSite_(file, &sites);
+                break;
+
+            case dino::LogFormat::ENTRY_MESSAGE:
+                is_valid = readMessage_(file, sites, with_location, &line);
+
+                if (is_valid) {
+                    std::printf("%s\n", line.c_str());
+                }
+                break;
+
+            default:
+                is_valid = false;
+                break;
+        }
+    }
+
+    std::fclose(file);
+
+    if (!is_valid) {
+        std::fprintf(stderr, "%s is truncated or corrupt.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
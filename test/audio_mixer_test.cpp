@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "engine/except.hpp"
+#include "engine/audio_stream.hpp"
+#include "engine/audio_mixer.hpp"
+#include "engine/sample_kernels.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_FREQUENCY 44100
+
+/* Frames in a 256 byte mono IMA ADPCM block. */
+#define DINO_TEST_ADPCM_BLOCK_FRAMES 505
+
+/* A 440 Hz tone, the source of the encoded test files. */
+static int16_t toneSample(uint32_t frame) {
+    return static_cast<int16_t>(12000.0 * std::sin(2.0 * M_PI * 440.0 * frame / DINO_TEST_FREQUENCY));
+}
+
+/* Writes the tone as a mono IMA ADPCM wave file, with the reference encoder of the format. */
+static bool writeAdpcmWave(const std::string& file_path, uint32_t blocks) {
+    static const int step_table[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+        253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+        1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+        12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    static const int index_table[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+    std::vector<uint8_t> bytes;
+
+    auto put_u16 = [&bytes] (uint32_t value) {
+        bytes.push_back(static_cast<uint8_t>(value));
+        bytes.push_back(static_cast<uint8_t>(value >> 8));
+    };
+
+    auto put_u32 = [&put_u16] (uint32_t value) {
+        put_u16(value & 0xFFFF);
+        put_u16(value >> 16);
+    };
+
+    auto put_tag = [&bytes] (const char* tag) {
+        bytes.insert(bytes.end(), tag, tag + 4);
+    };
+
+    put_tag("RIFF");
+    put_u32(40 + blocks * 256);
+    put_tag("WAVE");
+    put_tag("fmt ");
+    put_u32(20);
+    put_u16(0x11);
+    put_u16(1);
+    put_u32(DINO_TEST_FREQUENCY);
+    put_u32(DINO_TEST_FREQUENCY * 256 / DINO_TEST_ADPCM_BLOCK_FRAMES);
+    put_u16(256);
+    put_u16(4);
+    put_u16(2);
+    put_u16(DINO_TEST_ADPCM_BLOCK_FRAMES);
+    put_tag("data");
+    put_u32(blocks * 256);
+
+    int index = 0;
+    uint32_t frame = 0;
+
+    for (uint32_t block = 0; block < blocks; block++) {
+        int predictor = toneSample(frame++);
+
+        put_u16(static_cast<uint16_t>(predictor));
+        bytes.push_back(static_cast<uint8_t>(index));
+        bytes.push_back(0);
+
+        for (int pair = 0; pair < (DINO_TEST_ADPCM_BLOCK_FRAMES - 1) / 2; pair++) {
+            uint8_t packed = 0;
+
+            for (int half = 0; half < 2; half++) {
+                int step = step_table[index];
+                int diff = toneSample(frame++) - predictor;
+                int nibble = diff < 0 ? 8 : 0;
+
+                diff = std::abs(diff);
+                nibble = diff >= step ? nibble | 4 : nibble;
+                diff   = (nibble & 4) != 0 ? diff - step : diff;
+                nibble = diff >= (step >> 1) ? nibble | 2 : nibble;
+                diff   = (nibble & 2) != 0 ? diff - (step >> 1) : diff;
+                nibble = diff >= (step >> 2) ? nibble | 1 : nibble;
+
+                /* Track the decoder, so the error does not accumulate. */
+                int delta = (step >> 3) + ((nibble & 1) != 0 ? step >> 2 : 0) + ((nibble & 2) != 0 ? step >> 1 : 0) + ((nibble & 4) != 0 ? step : 0);
+
+                predictor = std::clamp((nibble & 8) != 0 ? predictor - delta : predictor + delta, -32768, 32767);
+                index     = std::clamp(index + index_table[nibble], 0, 88);
+
+                packed = static_cast<uint8_t>(packed | (nibble << (half * 4)));
+            }
+
+            bytes.push_back(packed);
+        }
+    }
+
+    std::FILE* file = std::fopen(file_path.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    return std::fclose(file) == 0;
+}
+
+/* The test thread plays the mixer, reading and seeking while the decoder thread fills the ring. */
+static void testStream(const std::string& file_path) {
+    std::vector<float> buffer(1024 * 2);
+
+    std::ifstream file(file_path, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    dino::FileView view {bytes.data(), bytes.size()};
+
+    for (int round = 0; round < 20; round++) {
+        bool is_looping = round % 2 == 0;
+
+        /* Every other pair of rounds streams the file from memory, as from an asset pack. */
+        auto stream_ptr = round % 4 < 2
+                ? std::make_unique<dino::AudioStream>(file_path, 48000, is_looping)
+                : std::make_unique<dino::AudioStream>(view, 48000, is_looping);
+
+        dino::AudioStream& stream = *stream_ptr;
+        stream.setPlaying(true);
+
+        for (int pass = 0; pass < 200; pass++) {
+            int frames = stream.read(buffer.data(), 256 + (pass % 4) * 256);
+            DINO_EXPECT(frames >= 0 && frames <= 1024);
+
+            if (pass % 37 == 0) {
+                stream.seek(0.1 * (pass % 5));
+            }
+
+            if (pass % 10 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        if (round == 19) {
+            /* Closed streams never read the file again and still serve what was decoded. */
+            stream.close();
+            std::fill(bytes.begin(), bytes.end(), 0);
+
+            DINO_EXPECT(stream.read(buffer.data(), 1024) >= 0);
+            stream.seek(0.0);
+            DINO_EXPECT(stream.read(buffer.data(), 1024) == 0);
+        }
+
+        /* Destroyed while the decoder thread is running. */
+    }
+}
+
+/* Writes the tone as a mono AIFF file, a format only SDL_mixer decodes. */
+static bool writeAiff(const std::string& file_path, uint32_t frames) {
+    std::vector<uint8_t> bytes;
+
+    auto put_u16 = [&bytes] (uint32_t value) {
+        bytes.push_back(static_cast<uint8_t>(value >> 8));
+        bytes.push_back(static_cast<uint8_t>(value));
+    };
+
+    auto put_u32 = [&put_u16] (uint32_t value) {
+        put_u16(value >> 16);
+        put_u16(value & 0xFFFF);
+    };
+
+    auto put_tag = [&bytes] (const char* tag) {
+        bytes.insert(bytes.end(), tag, tag + 4);
+    };
+
+    put_tag("FORM");
+    put_u32(46 + frames * 2);
+    put_tag("AIFF");
+    put_tag("COMM");
+    put_u32(18);
+    put_u16(1);
+    put_u32(frames);
+    put_u16(16);
+
+    /* The sample rate is an 80 bit float, normalised so the top bit of the mantissa is set. */
+    int exponent = 0;
+
+    while ((DINO_TEST_FREQUENCY >> (exponent + 1)) != 0) {
+        exponent++;
+    }
+
+    put_u16(16383 + exponent);
+    put_u32(static_cast<uint32_t>(DINO_TEST_FREQUENCY) << (31 - exponent));
+    put_u32(0);
+
+    put_tag("SSND");
+    put_u32(8 + frames * 2);
+    put_u32(0);
+    put_u32(0);
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        put_u16(static_cast<uint16_t>(toneSample(frame)));
+    }
+
+    std::FILE* file = std::fopen(file_path.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    return std::fclose(file) == 0;
+}
+
+/* A compressed wave file is streamed block by block and decodes close to its source. */
+static void testAdpcmStream(const std::string& file_path) {
+    dino::AudioStream stream(file_path, DINO_TEST_FREQUENCY, false);
+    stream.setPlaying(true);
+
+    std::vector<float> buffer(4 * DINO_TEST_ADPCM_BLOCK_FRAMES * 2);
+    int frames = 0;
+
+    for (int attempt = 0; attempt < 1000 && frames < 4 * DINO_TEST_ADPCM_BLOCK_FRAMES; attempt++) {
+        frames = frames + stream.read(buffer.data() + frames * 2, 4 * DINO_TEST_ADPCM_BLOCK_FRAMES - frames);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    DINO_EXPECT(frames == 4 * DINO_TEST_ADPCM_BLOCK_FRAMES);
+
+    float peak_error = 0.0f;
+
+    /* The encoder needs a few samples to pick up the step size. */
+    for (int frame = 16; frame < frames; frame++) {
+        float expected = static_cast<float>(toneSample(static_cast<uint32_t>(frame))) / 32768.0f;
+
+        peak_error = std::max(peak_error, std::abs(buffer[frame * 2] - expected));
+        peak_error = std::max(peak_error, std::abs(buffer[frame * 2 + 1] - expected));
+    }
+
+    DINO_EXPECT(peak_error < 0.02f);
+
+    /* Seeks land in the middle of a block. */
+    stream.seek(1000.0 / DINO_TEST_FREQUENCY);
+    frames = 0;
+
+    for (int attempt = 0; attempt < 1000 && frames == 0; attempt++) {
+        frames = stream.read(buffer.data(), 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    DINO_EXPECT(frames == 1 && std::abs(buffer[0] - static_cast<float>(toneSample(1000)) / 32768.0f) < 0.02f);
+}
+
+/* Formats without a streaming decoder are decoded by SDL_mixer and still play as the BGM. */
+static void testSdlMixerStream(const std::string& file_path) {
+    auto mixer = new dino::AudioMixer(8);
+
+    mixer->loadLoopAudio(file_path);
+    mixer->playLoopAudio();
+    DINO_EXPECT(mixer->isLoopPlaying());
+
+    SDL_Delay(50);
+
+    mixer->setLoopGain(0.5f);
+    mixer->seekLoopAudio(0.1);
+
+    delete mixer;
+}
+
+/* Commands, asset reloads and stream swaps race the audio callback. */
+static void testMixer(const std::string& file_path) {
+    auto effect_file = dino::test::asset("audio", "cartoon-jump.wav");
+    auto mixer = new dino::AudioMixer(8);
+
+    mixer->loadEffectAudio(0, effect_file, 1, 2);
+    mixer->loadEffectAudio(1, file_path, 0, 4);
+    mixer->loadLoopAudio(file_path);
+    mixer->playLoopAudio();
+
+    int rejected = 0;
+
+    for (int step = 0; step < 3000; step++) {
+        auto effect_id = static_cast<unsigned int>(step % 2);
+
+        switch (step % 6) {
+            case 0:
+                mixer->playEffectAudio(effect_id, 0.8f, (step % 3) * 0.5f - 0.5f, 0.75f + (step % 4) * 0.25f);
+                break;
+
+            case 1:
+                mixer->setEffectGain(effect_id, (step % 5) * 0.25f);
+                break;
+
+            case 2:
+                mixer->seekLoopAudio((step % 3) * 0.25);
+                break;
+
+            case 3:
+                mixer->setLoopGain((step % 4) * 0.3f);
+                break;
+
+            case 4:
+                mixer->stopEffectAudio(effect_id);
+                break;
+
+            default:
+                mixer->playEffectAudio(effect_id);
+                break;
+        }
+
+        try {
+            if (step % 50 == 0) {
+                mixer->loadEffectAudio(effect_id, effect_id == 0 ? effect_file : file_path, 1, 2);
+            }
+
+            if (step % 400 == 0) {
+                mixer->loadLoopAudio(file_path);
+                mixer->playLoopAudio();
+            }
+
+        } catch (dino::EngineError&) {
+            rejected = rejected + 1;
+        }
+
+        if (step % 97 == 0) {
+            mixer->pauseLoopAudio();
+            mixer->playLoopAudio();
+        }
+
+        DINO_EXPECT(mixer->getActiveVoices() >= 0 && mixer->getActiveVoices() <= 8);
+
+        if (step % 3 == 0) {
+            SDL_Delay(1);
+        }
+    }
+
+    auto stats = mixer->getStats();
+    std::printf("Mixer: %lu dropped commands, %lu stream underruns, %d rejected loads.\n",
+            stats.droppedCommands, stats.streamUnderruns, rejected);
+
+    /* Destroyed while playing. */
+    delete mixer;
+}
+
+/* Streams replaced before the audio thread ever saw them are freed exactly once. */
+static void testUnappliedStreams(const std::string& file_path) {
+    auto mixer = new dino::AudioMixer(8);
+
+    /* Without the callback no command is applied. */
+    Mix_SetPostMix(nullptr, nullptr);
+
+    mixer->loadLoopAudio(file_path);
+    mixer->loadLoopAudio(file_path);
+    mixer->playLoopAudio();
+
+    delete mixer;
+}
+
+/* A pause dropped by a full queue leaves the BGM reported as playing. */
+static void testFullQueuePause(const std::string& file_path) {
+    auto mixer = new dino::AudioMixer(8);
+
+    /* Without the callback the queue is never emptied. */
+    Mix_SetPostMix(nullptr, nullptr);
+
+    mixer->loadLoopAudio(file_path);
+    mixer->playLoopAudio();
+
+    for (int command = 0; command < DINO_AUDIO_COMMAND_QUEUE_SIZE; command++) {
+        mixer->setLoopGain(0.5f);
+    }
+
+    mixer->pauseLoopAudio();
+
+    DINO_EXPECT(mixer->getStats().droppedCommands > 0);
+    DINO_EXPECT(mixer->isLoopPlaying());
+
+    delete mixer;
+}
+
+int main() {
+    auto file_path = (std::filesystem::temp_directory_path() / "dino-mixer-test.wav").string();
+
+    if (!dino::test::writeWave(file_path, 22050, 22050)) {
+        std::fprintf(stderr, "Unable to write %s\n", file_path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    testStream(file_path);
+
+    auto adpcm_path = (std::filesystem::temp_directory_path() / "dino-mixer-test-adpcm.wav").string();
+    auto aiff_path  = (std::filesystem::temp_directory_path() / "dino-mixer-test.aiff").string();
+
+    if (!writeAdpcmWave(adpcm_path, 8) || !writeAiff(aiff_path, DINO_TEST_FREQUENCY)) {
+        std::fprintf(stderr, "Unable to write the encoded test files.\n");
+        return EXIT_FAILURE;
+    }
+
+    testAdpcmStream(adpcm_path);
+
+    /* Runs without an audio device unless SDL_AUDIODRIVER says otherwise. */
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+    if (SDL_Init(SDL_INIT_AUDIO) != 0 || Mix_OpenAudio(DINO_TEST_FREQUENCY, AUDIO_S16SYS, 2, 512) != 0) {
+        std::fprintf(stderr, "Unable to open the audio device: %s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    dino::SampleKernels::initialise();
+    testMixer(file_path);
+    testUnappliedStreams(file_path);
+    testFullQueuePause(file_path);
+    testSdlMixerStream(aiff_path);
+
+    Mix_CloseAudio();
+    SDL_Quit();
+
+    std::filesystem::remove(file_path);
+    std::filesystem::remove(adpcm_path);
+    std::filesystem::remove(aiff_path);
+    return dino::test::result();
+}
@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "game/batch_simulation.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_INSTANCES 300
+#define DINO_TEST_STEPS 2000
+
+namespace {
+
+/* Sizes of the game assets at 1920x1080. */
+dino::WorldLayout createLayout() {
+    dino::WorldLayout layout {};
+    layout.viewWidth      = 1920;
+    layout.tileWidth      = 210;
+    layout.sceneWidth     = 1920;
+    layout.playerX        = 100;
+    layout.playerY        = 720;
+    layout.playerWidth    = 262;
+    layout.playerHeight   = 160;
+    layout.obstacleY      = 680;
+    layout.obstacleWidth  = 90;
+    layout.obstacleHeight = 200;
+
+    return layout;
+}
+
+/* Jumps once the next obstacle is closer than a threshold that differs per instance. */
+void chooseActions(const dino::BatchSimulation& batch, std::vector<uint8_t>* actions) {
+    const float* observations = batch.getObservations();
+
+    for (int instance = 0; instance < batch.getInstanceCount(); instance++) {
+        float distance  = observations[instance * DINO_BATCH_OBSERVATION_SIZE + 2];
+        float threshold = 0.02f * static_cast<float>(instance % 8);
+
+        (*actions)[instance] = distance < threshold ? dino::WorldSimulation::INPUT_JUMP : dino::WorldSimulation::INPUT_NONE;
+    }
+}
+
+} // namespace
+
+/* The split across threads does not change any result. */
+static void testThreadIndependence() {
+    dino::BatchConfig config {};
+    config.instances = DINO_TEST_INSTANCES;
+    config.frameSkip = 2;
+    config.seed      = 5;
+
+    config.threads = 1;
+    dino::BatchSimulation serial(createLayout(), config);
+
+    config.threads = 4;
+    dino::BatchSimulation parallel(createLayout(), config);
+
+    DINO_EXPECT(serial.getThreadCount() == 1);
+    DINO_EXPECT(parallel.getThreadCount() == 4);
+
+    std::vector<uint8_t> actions(DINO_TEST_INSTANCES);
+    bool is_same = true;
+    int done_count = 0;
+
+    for (int step = 0; step < DINO_TEST_STEPS; step++) {
+        chooseActions(serial, &actions);
+
+        serial.step(actions.data());
+        parallel.step(actions.data());
+
+        is_same = is_same && std::memcmp(serial.getObservations(), parallel.getObservations(), sizeof(float) * DINO_TEST_INSTANCES * DINO_BATCH_OBSERVATION_SIZE) == 0;
+        is_same = is_same && std::memcmp(serial.getRewards(), parallel.getRewards(), sizeof(float) * DINO_TEST_INSTANCES) == 0;
+        is_same = is_same && std::memcmp(serial.getDones(), parallel.getDones(), DINO_TEST_INSTANCES) == 0;
+
+        for (int instance = 0; instance < DINO_TEST_INSTANCES; instance++) {
+            done_count = done_count + serial.getDones()[instance];
+        }
+    }
+
+    DINO_EXPECT(is_same);
+    DINO_EXPECT(done_count > 0);
+    DINO_EXPECT(serial.getTickCount() == parallel.getTickCount());
+}
+
+/* Episodes are cut at the tick limit, in the middle of a step. */
+static void testEpisodeLimit() {
+    dino::BatchConfig config {};
+    config.instances       = 3;
+    config.threads         = 2;
+    config.frameSkip       = 4;
+    config.maxEpisodeTicks = 10;
+
+    dino::BatchSimulation batch(createLayout(), config);
+    std::vector<uint8_t> actions(3, dino::WorldSimulation::INPUT_NONE);
+
+    batch.step(actions.data());
+    batch.step(actions.data());
+    DINO_EXPECT(batch.getDones()[0] == 0);
+    DINO_EXPECT(batch.getRewards()[0] == 4.0f);
+
+    batch.step(actions.data());
+    DINO_EXPECT(batch.getDones()[2] == 1);
+    DINO_EXPECT(batch.getRewards()[2] == 2.0f);
+    DINO_EXPECT(batch.getTickCount() == 30);
+}
+
+/* A collision ends the episode and the instance starts over with an empty view. */
+static void testCollision() {
+    dino::BatchConfig config {};
+    config.instances = 1;
+    config.threads   = 1;
+    config.frameSkip = 8;
+
+    dino::BatchSimulation batch(createLayout(), config);
+    std::vector<uint8_t> actions(1, dino::WorldSimulation::INPUT_NONE);
+
+    int steps = 0;
+
+    while (batch.getDones()[0] == 0 && steps < DINO_TEST_STEPS) {
+        batch.step(actions.data());
+        steps++;
+    }
+
+    DINO_EXPECT(batch.getDones()[0] == 1);
+    DINO_EXPECT(batch.getRewards()[0] < 0.0f);
+    DINO_EXPECT(batch.getState(0)->isGameOver == 0);
+    DINO_EXPECT(batch.getObservations()[2] == 1.0f);
+}
+
+/* Ranges of different threads never share a cache line of the result arrays. */
+static void testCacheLineLayout() {
+    dino::BatchConfig config {};
+    config.instances = DINO_TEST_INSTANCES;
+    config.threads   = 4;
+
+    dino::BatchSimulation batch(createLayout(), config);
+    int chunk_size = dino::BatchSimulation::getChunkSize();
+
+    auto is_aligned = [] (const void* array) {
+        return reinterpret_cast<std::uintptr_t>(array) % DINO_BATCH_CACHE_LINE == 0;
+    };
+
+    DINO_EXPECT(is_aligned(batch.getObservations()));
+    DINO_EXPECT(is_aligned(batch.getRewards()));
+    DINO_EXPECT(is_aligned(batch.getDones()));
+    DINO_EXPECT(is_aligned(batch.getState(0)));
+
+    DINO_EXPECT(is_aligned(batch.getObservations() + chunk_size * DINO_BATCH_OBSERVATION_SIZE));
+    DINO_EXPECT(is_aligned(batch.getRewards() + chunk_size));
+    DINO_EXPECT(is_aligned(batch.getDones() + chunk_size));
+    DINO_EXPECT(is_aligned(batch.getState(chunk_size)));
+}
+
+/* Settings out of range are refused. */
+static void testInvalidConfig() {
+    dino::BatchConfig config {};
+    config.instances = 0;
+
+    bool is_thrown = false;
+
+    try {
+        dino::BatchSimulation batch(createLayout(), config);
+    } catch (const std::runtime_error&) {
+        is_thrown = true;
+    }
+
+    DINO_EXPECT(is_thrown);
+}
+
+int main() {
+    testThreadIndependence();
+    testEpisodeLimit();
+    testCollision();
+    testCacheLineLayout();
+    testInvalidConfig();
+
+    return dino::test::result();
+}
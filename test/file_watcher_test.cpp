@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "platform/file_watcher.hpp"
+#include "test_common.hpp"
+
+namespace {
+
+/**
+ * @brief Paths reported by the watcher thread.
+ */
+struct change_log {
+    std::mutex mutex;
+    std::vector<std::string> paths;
+
+    void add(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        paths.push_back(path);
+    }
+
+    std::vector<std::string> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::move(paths);
+    }
+
+    /* Waits until the given number of paths were reported or two seconds passed. */
+    bool waitFor(std::size_t count) {
+        for (int attempt = 0; attempt < 200; attempt++) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (paths.size() >= count) {
+                    return true;
+                }
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return false;
+    }
+};
+
+void writeFile(const std::string& path, const char* content) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+
+    if (file != nullptr) {
+        std::fputs(content, file);
+        std::fclose(file);
+    }
+}
+
+} // namespace
+
+/* A burst of writes is reported once, a file renamed into place is reported too. */
+static void testChanges(const std::string& directory) {
+    dino::FileWatcher watcher;
+    change_log changes;
+
+    DINO_EXPECT(watcher.watch(directory));
+    DINO_EXPECT(watcher.start([&changes] (const std::string& path) {
+        changes.add(path);
+    }));
+
+    for (int index = 0; index < 5; index++) {
+        writeFile(directory + "/sprite.png", "frame");
+    }
+
+    writeFile(directory + "/effect.tmp", "sound");
+    std::filesystem::rename(directory + "/effect.tmp", directory + "/effect.wav");
+
+    DINO_EXPECT(changes.waitFor(3));
+
+    /* Anything past the settle time would be a duplicate. */
+    std::this_thread::sleep_for(std::chrono::milliseconds(DINO_WATCH_SETTLE_MS * 3));
+    auto paths = changes.take();
+    std::sort(paths.begin(), paths.end());
+
+    DINO_EXPECT((paths == std::vector<std::string> {directory + "/effect.tmp", directory + "/effect.wav", directory + "/sprite.png"}));
+
+    watcher.stop();
+    writeFile(directory + "/sprite.png", "stopped");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(DINO_WATCH_SETTLE_MS * 2));
+    DINO_EXPECT(changes.take().empty());
+}
+
+/* Watching fails for a missing directory and starting fails without a directory. */
+static void testErrors(const std::string& directory) {
+    dino::FileWatcher watcher;
+
+    DINO_EXPECT(!watcher.watch(directory + "/missing"));
+    DINO_EXPECT(!watcher.start([] (const std::string&) {}));
+}
+
+int main() {
+    if (!dino::FileWatcher::isSupported()) {
+        return dino::test::result();
+    }
+
+    auto directory = (std::filesystem::temp_directory_path() / "dino-file-watcher-test").string();
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    testChanges(directory);
+    testErrors(directory);
+
+    std::filesystem::remove_all(directory);
+    return dino::test::result();
+}
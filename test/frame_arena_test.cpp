@@ -0,0 +1,41 @@
+#include <cstdint>
+
+#include "engine/frame_arena.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_ARENA_SIZE 4096
+
+static bool isAligned(const void* pointer, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+/* Alignments above that of the buffer hold after odd sized allocations. */
+static void testAlignment() {
+    dino::FrameArena arena(DINO_TEST_ARENA_SIZE);
+
+    for (std::size_t alignment : {16, 32, 64, 128}) {
+        arena.allocate(3, 1);
+
+        DINO_EXPECT(isAligned(arena.allocate(24, alignment), alignment));
+        DINO_EXPECT(isAligned(arena.allocate(1, alignment), alignment));
+    }
+
+    DINO_EXPECT(arena.getStats()->overflowAllocations == 0);
+}
+
+/* Overflow allocations keep their alignment as well. */
+static void testOverflowAlignment() {
+    dino::FrameArena arena(DINO_TEST_ARENA_SIZE);
+
+    arena.allocate(DINO_TEST_ARENA_SIZE - 8, 1);
+
+    DINO_EXPECT(isAligned(arena.allocate(64, 64), 64));
+    DINO_EXPECT(arena.getStats()->overflowAllocations == 1);
+}
+
+int main() {
+    testAlignment();
+    testOverflowAlignment();
+
+    return dino::test::result();
+}
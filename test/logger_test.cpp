@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "platform/logger.hpp"
+#include "platform/log_format.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_LOG_THREADS 8
+#define DINO_TEST_LOG_ROUNDS  4
+#define DINO_TEST_LOG_RECORDS 5000
+
+/**
+ * @brief Counts the info messages of a binary log.
+ * @return Number of messages, -1 if the file is corrupt.
+ */
+static long countMessages(const std::string& file_path) {
+    std::FILE* file = std::fopen(file_path.c_str(), "rb");
+
+    if (file == nullptr) {
+        return -1;
+    }
+
+    char magic[sizeof(DINO_LOG_FILE_MAGIC) - 1];
+    long count = 0;
+    int kind;
+
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, DINO_LOG_FILE_MAGIC, sizeof(magic)) != 0) {
+        count = -1;
+    }
+
+    while (count >= 0 && (kind = std::fgetc(file)) != EOF) {
+        uint32_t format_id = 0, line = 0;
+        uint16_t length = 0;
+        uint8_t level = 0, is_plain = 0;
+        uint8_t payload[DINO_LOG_PAYLOAD_SIZE];
+
+        if (kind == dino::LogFormat::ENTRY_FORMAT) {
+            bool is_valid = std::fread(&format_id, 4, 1, file) == 1 && std::fread(&level, 1, 1, file) == 1 && std::fread(&line, 4, 1, file) == 1;
+
+            for (int text = 0; is_valid && text < 2; text++) {
+                is_valid = std::fread(&length, 2, 1, file) == 1 && std::fseek(file, length, SEEK_CUR) == 0;
+            }
+
+            count = is_valid ? count : -1;
+
+        } else if (kind == dino::LogFormat::ENTRY_MESSAGE) {
+            bool is_valid = std::fread(&format_id, 4, 1, file) == 1 && std::fread(&level, 1, 1, file) == 1 &&
+                    std::fread(&is_plain, 1, 1, file) == 1 && std::fread(&length, 2, 1, file) == 1 &&
+                    length <= DINO_LOG_PAYLOAD_SIZE && std::fread(payload, 1, length, file) == length;
+
+            count = !is_valid ? -1 : count + (level == dino::Logger::INFO ? 1 : 0);
+
+        } else {
+            count = -1;
+        }
+    }
+
+    std::fclose(file);
+    return count;
+}
+
+/* Short lived threads log concurrently, every record is written or counted as dropped. */
+static void testThroughput(const std::string& file_path) {
+    DINO_EXPECT(dino::Logger::openBinaryLog(file_path));
+
+    uint64_t dropped = dino::Logger::getDropped();
+
+    for (int round = 0; round < DINO_TEST_LOG_ROUNDS; round++) {
+        std::vector<std::thread> threads;
+
+        for (int index = 0; index < DINO_TEST_LOG_THREADS; index++) {
+            threads.emplace_back([index] () {
+                for (int record = 0; record < DINO_TEST_LOG_RECORDS; record++) {
+                    if (record % 2 == 0) {
+                        DINO_LOG(dino::Logger::INFO, "Thread {} record {} of {}.", index, record, "stress");
+                    } else {
+                        dino::Logger::info("Thread", index, "record", record, 0.5);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    dino::Logger::flush();
+    dropped = dino::Logger::getDropped() - dropped;
+    dino::Logger::closeBinaryLog();
+
+    long written = countMessages(file_path);
+    long expected = static_cast<long>(DINO_TEST_LOG_ROUNDS) * DINO_TEST_LOG_THREADS * DINO_TEST_LOG_RECORDS;
+
+    DINO_EXPECT(written >= 0);
+    DINO_EXPECT(written + static_cast<long>(dropped) == expected);
+}
+
+/* Level changes, flushes and log reopening race the logging threads. */
+static void testControl(const std::string& file_path) {
+    DINO_EXPECT(dino::Logger::openBinaryLog(file_path));
+
+    std::atomic<bool> is_running {true};
+    std::vector<std::thread> threads;
+
+    for (int index = 0; index < DINO_TEST_LOG_THREADS; index++) {
+        threads.emplace_back([index, &is_running] () {
+            int record = 0;
+
+            while (is_running.load(std::memory_order_acquire)) {
+                DINO_LOG(dino::Logger::DEBUG, "Thread {} record {}.", index, record);
+                DINO_LOG(dino::Logger::INFO, "Thread {} record {}.", index, record);
+                record = record + 1;
+            }
+        });
+    }
+
+    for (int step = 0; step < 200; step++) {
+        dino::Logger::setLevel(step % 2 == 0 ? dino::Logger::WARN : dino::Logger::INFO);
+        dino::Logger::flush();
+
+        if (step % 25 == 0) {
+            DINO_EXPECT(dino::Logger::openBinaryLog(file_path));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    is_running.store(false, std::memory_order_release);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    dino::Logger::closeBinaryLog();
+    dino::Logger::setLevel(dino::Logger::INFO);
+}
+
+int main() {
+    auto file_path = (std::filesystem::temp_directory_path() / "dino-logger-test.log").string();
+
+    testThroughput(file_path);
+    testControl(file_path);
+
+    std::filesystem::remove(file_path);
+    return dino::test::result();
+}
@@ -0,0 +1,135 @@
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "platform/memory_tracker.hpp"
+#include "engine/frame_arena.hpp"
+#include "game/batch_simulation.hpp"
+#include "test_common.hpp"
+
+/* Heap allocations a frame of the simulation and the frame arena may make once warmed up. */
+#define DINO_TEST_FRAME_ALLOCATION_BUDGET 0
+
+#define DINO_TEST_FRAMES 200
+
+/* Two chunks of the batch, so both threads get a range. */
+#define DINO_TEST_INSTANCES 128
+
+namespace {
+
+/* Sizes of the game assets at 1920x1080. */
+dino::WorldLayout createLayout() {
+    dino::WorldLayout layout {};
+    layout.viewWidth      = 1920;
+    layout.tileWidth      = 210;
+    layout.sceneWidth     = 1920;
+    layout.playerX        = 100;
+    layout.playerY        = 720;
+    layout.playerWidth    = 262;
+    layout.playerHeight   = 160;
+    layout.obstacleY      = 680;
+    layout.obstacleWidth  = 90;
+    layout.obstacleHeight = 200;
+
+    return layout;
+}
+
+} // namespace
+
+/* Allocations are counted against the tag active on the thread and latched per frame. */
+static void testTagging() {
+    dino::MemoryTracker::beginFrame();
+
+    auto before = dino::MemoryTracker::getStats(dino::MemoryTracker::AUDIO);
+
+    {
+        dino::MemoryScope memory_scope(dino::MemoryTracker::AUDIO);
+
+        void* block = ::operator new(48);
+        ::operator delete(block);
+
+        block = ::operator new(16, std::align_val_t(64));
+        ::operator delete(block, std::align_val_t(64));
+    }
+
+    dino::MemoryTracker::beginFrame();
+    auto after = dino::MemoryTracker::getStats(dino::MemoryTracker::AUDIO);
+
+    DINO_EXPECT(after.frameAllocations == 2);
+    DINO_EXPECT(after.frameBytes == 64);
+    DINO_EXPECT(after.totalAllocations == before.totalAllocations + 2);
+    DINO_EXPECT(after.liveAllocations == before.liveAllocations);
+
+    dino::MemoryTracker::beginFrame();
+    DINO_EXPECT(dino::MemoryTracker::getStats(dino::MemoryTracker::AUDIO).frameAllocations == 0);
+}
+
+/* The total peak is reached once, even when every subsystem peaks in turn. */
+static void testTotalPeak() {
+    auto before = dino::MemoryTracker::getTotalStats();
+
+    for (int tag : {dino::MemoryTracker::RENDERER, dino::MemoryTracker::AUDIO, dino::MemoryTracker::ASSETS}) {
+        dino::MemoryScope memory_scope(tag);
+
+        void* block = ::operator new(1 << 24);
+        ::operator delete(block);
+    }
+
+    auto after = dino::MemoryTracker::getTotalStats();
+
+    DINO_EXPECT(after.peakBytes >= before.liveBytes + (1 << 24));
+    DINO_EXPECT(after.peakBytes < before.peakBytes + 2 * (1 << 24));
+    DINO_EXPECT(dino::MemoryTracker::getStats(dino::MemoryTracker::ASSETS).peakBytes >= (1 << 24));
+}
+
+/* Once warmed up, stepping the games and filling per-frame containers stays within the budget. */
+static void testSteadyStateBudget() {
+    dino::MemoryScope memory_scope(dino::MemoryTracker::GAME);
+
+    dino::FrameArena arena(65536);
+
+    dino::BatchConfig config {};
+    config.instances = DINO_TEST_INSTANCES;
+    config.threads   = 2;
+    config.frameSkip = 4;
+
+    dino::BatchSimulation batch(createLayout(), config);
+    std::vector<uint8_t> actions(DINO_TEST_INSTANCES, dino::WorldSimulation::INPUT_NONE);
+
+    uint64_t over_budget = 0;
+
+    for (int frame = 0; frame < DINO_TEST_FRAMES; frame++) {
+        arena.beginFrame();
+
+        std::pmr::vector<int> events {arena.getResource()};
+
+        for (int index = 0; index < DINO_TEST_INSTANCES; index++) {
+            events.push_back(index);
+            actions[index] = batch.getObservations()[index * DINO_BATCH_OBSERVATION_SIZE + 2] < 0.05f ? 1 : 0;
+        }
+
+        batch.step(actions.data());
+        dino::MemoryTracker::beginFrame();
+
+        /* The first frame is the warm up. */
+        if (frame > 0 && dino::MemoryTracker::getTotalStats().frameAllocations > DINO_TEST_FRAME_ALLOCATION_BUDGET) {
+            over_budget++;
+        }
+    }
+
+    DINO_EXPECT(over_budget == 0);
+    /* Both threads stepped, an episode ending mid-step skips the rest of its ticks. */
+    DINO_EXPECT(batch.getThreadCount() == 2);
+    DINO_EXPECT(batch.getTickCount() >= DINO_TEST_FRAMES * DINO_TEST_INSTANCES);
+    DINO_EXPECT(batch.getTickCount() <= DINO_TEST_FRAMES * DINO_TEST_INSTANCES * 4);
+}
+
+int main() {
+    DINO_EXPECT(dino::MemoryTracker::isEnabled());
+
+    testTagging();
+    testTotalPeak();
+    testSteadyStateBudget();
+
+    return dino::test::result();
+}
@@ -0,0 +1,86 @@
+#include "game/player_motion.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_CLIP_WIDTH 262
+
+/* Frames advance on the animation schedule and wrap around. */
+static void testRunAnimation() {
+    dino::MotionState state;
+    dino::PlayerMotion motion(&state, DINO_TEST_CLIP_WIDTH);
+
+    DINO_EXPECT(motion.getClipX() == 0);
+
+    for (int frame = 1; frame < DINO_PLAYER_RUN_FRAMES * 3; frame++) {
+        motion.update(DINO_PLAYER_FRAME_DELAY);
+        DINO_EXPECT(motion.getClipX() == (frame % DINO_PLAYER_RUN_FRAMES) * DINO_TEST_CLIP_WIDTH);
+    }
+}
+
+/* The game over pose holds and blocks jumps. */
+static void testStopped() {
+    dino::MotionState state;
+    dino::PlayerMotion motion(&state, DINO_TEST_CLIP_WIDTH);
+
+    motion.setStopped(true);
+    motion.update(DINO_PLAYER_FRAME_DELAY * 3);
+
+    DINO_EXPECT(motion.getClipX() == DINO_TEST_CLIP_WIDTH * DINO_PLAYER_RUN_FRAMES);
+    DINO_EXPECT(!motion.jump());
+
+    motion.setStopped(false);
+    DINO_EXPECT(motion.jump());
+}
+
+/* A jump peaks half way and lands back on the floor. */
+static void testJump() {
+    dino::MotionState state;
+    dino::PlayerMotion motion(&state, DINO_TEST_CLIP_WIDTH);
+
+    DINO_EXPECT(motion.jump());
+    DINO_EXPECT(!motion.jump());
+
+    motion.update(DINO_PLAYER_JUMP_DURATION / 2.0f);
+    DINO_EXPECT(motion.getLiftY() >= DINO_PLAYER_JUMP_HEIGHT - 1);
+
+    motion.update(DINO_PLAYER_JUMP_DURATION / 2.0f);
+    DINO_EXPECT(!motion.isJumping());
+    DINO_EXPECT(motion.getLiftY() == 0);
+    DINO_EXPECT(motion.jump());
+}
+
+/* Restoring a copy of the state replays the same trajectory. */
+static void testRestore() {
+    dino::MotionState state;
+    dino::PlayerMotion motion(&state, DINO_TEST_CLIP_WIDTH);
+
+    motion.jump();
+    motion.update(DINO_PLAYER_JUMP_DURATION / 4.0f);
+
+    dino::MotionState snapshot = state;
+    int lift_y[8];
+
+    for (int index = 0; index < 8; index++) {
+        motion.update(17.0f);
+        lift_y[index] = motion.getLiftY();
+    }
+
+    state = snapshot;
+
+    for (int index = 0; index < 8; index++) {
+        motion.update(17.0f);
+        DINO_EXPECT(motion.getLiftY() == lift_y[index]);
+    }
+
+    state = snapshot;
+    DINO_EXPECT(motion.isJumping());
+    DINO_EXPECT(!motion.jump());
+}
+
+int main() {
+    testRunAnimation();
+    testStopped();
+    testJump();
+    testRestore();
+
+    return dino::test::result();
+}
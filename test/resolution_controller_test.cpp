@@ -0,0 +1,121 @@
+#include <cmath>
+
+#include "engine/except.hpp"
+#include "engine/resolution_controller.hpp"
+#include "test_common.hpp"
+
+static bool isStep(float scale, float step) {
+    float steps = scale / step;
+    return std::fabs(steps - std::round(steps)) < 0.01f;
+}
+
+/* A frame that costs its area in time, 20 ms at scale 1. */
+static float areaCost(float scale) {
+    return 20.0f * scale * scale;
+}
+
+/* An overloaded frame drops to the minimum scale, then sheds quality, then recovers once the load goes. */
+static void testBounds() {
+    dino::ResolutionRules rules;
+    rules.minScale = 0.5f;
+    rules.maxScale = 1.5f;
+
+    dino::ResolutionController controller(rules);
+    DINO_EXPECT(controller.getScale() == 1.5f);
+
+    for (int frame = 0; frame < 2000; frame++) {
+        float scale = controller.update(100.0f);
+
+        DINO_EXPECT(scale >= rules.minScale && scale <= rules.maxScale);
+        DINO_EXPECT(isStep(scale, rules.step));
+    }
+
+    DINO_EXPECT(controller.getScale() == rules.minScale);
+    DINO_EXPECT(controller.isReduced());
+
+    for (int frame = 0; frame < 20000; frame++) {
+        controller.update(1.0f);
+    }
+
+    DINO_EXPECT(controller.getScale() == rules.maxScale);
+    DINO_EXPECT(!controller.isReduced());
+}
+
+/* With cost following area the scale settles where the frame fits and stays there. */
+static void testSettles() {
+    dino::ResolutionRules rules;
+    dino::ResolutionController controller(rules);
+
+    for (int frame = 0; frame < 3000; frame++) {
+        controller.update(areaCost(controller.getScale()));
+    }
+
+    float settled = controller.getScale();
+    unsigned long changes = controller.getChanges();
+
+    DINO_EXPECT(areaCost(settled) <= rules.budgetMs);
+    DINO_EXPECT(areaCost(settled) >= rules.budgetMs * rules.upscaleRatio);
+
+    for (int frame = 0; frame < 3000; frame++) {
+        controller.update(areaCost(controller.getScale()));
+    }
+
+    DINO_EXPECT(controller.getScale() == settled);
+    DINO_EXPECT(controller.getChanges() == changes);
+}
+
+/* A cost that jumps across the whole band between two neighbouring scales backs off instead of flipping. */
+static void testOscillation() {
+    dino::ResolutionRules rules;
+    dino::ResolutionController controller(rules);
+
+    auto step_cost = [] (float scale) {
+        return scale < 0.925f ? 10.0f : 18.0f;
+    };
+
+    for (int frame = 0; frame < 20000; frame++) {
+        controller.update(step_cost(controller.getScale()));
+    }
+
+    /* Flipping every cooldown would be over 600 changes. */
+    DINO_EXPECT(controller.getChanges() < 60);
+    DINO_EXPECT(controller.getScale() >= 0.9f - 0.01f && controller.getScale() <= 0.95f + 0.01f);
+}
+
+static void testRules() {
+    dino::ResolutionRules rules;
+    rules.minScale = 1.2f;
+
+    bool is_thrown = false;
+
+    try {
+        dino::ResolutionController controller(rules);
+
+    } catch (dino::EngineError&) {
+        is_thrown = true;
+    }
+
+    DINO_EXPECT(is_thrown);
+
+    rules = dino::ResolutionRules();
+    dino::ResolutionController controller(rules);
+
+    for (int frame = 0; frame < 500; frame++) {
+        controller.update(100.0f);
+    }
+
+    controller.reset();
+
+    DINO_EXPECT(controller.getScale() == rules.maxScale);
+    DINO_EXPECT(controller.getChanges() == 0);
+    DINO_EXPECT(!controller.isReduced());
+}
+
+int main() {
+    testBounds();
+    testSettles();
+    testOscillation();
+    testRules();
+
+    return dino::test::result();
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "engine/frame_arena.hpp"
+#include "engine/renderer.hpp"
+#include "engine/sprite_batch.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_SURFACE_SIZE 16
+
+namespace {
+
+/**
+ * @brief A software renderer drawing into a small surface, with solid white textures.
+ */
+struct batch_fixture {
+    SDL_Surface* surface;
+    dino::Renderer* renderer;
+    std::vector<dino::SpriteMaterial*> textures;
+
+    explicit batch_fixture(int texture_count) {
+        surface  = SDL_CreateRGBSurfaceWithFormat(0, DINO_TEST_SURFACE_SIZE, DINO_TEST_SURFACE_SIZE, 32, SDL_PIXELFORMAT_RGBA8888);
+        renderer = new dino::Renderer(surface);
+
+        for (int index = 0; index < texture_count; index++) {
+            auto texture = renderer->createTarget(4, 4);
+
+            renderer->setTarget(texture);
+            renderer->drawOverlay(0xff, 0xff, 0xff, 0xff);
+
+            textures.push_back(texture);
+        }
+
+        renderer->setTarget(nullptr);
+    }
+
+    ~batch_fixture() {
+        for (auto texture : textures) {
+            delete texture;
+        }
+
+        delete renderer;
+        SDL_FreeSurface(surface);
+    }
+
+    [[nodiscard]] SDL_Color pixel(int pos_x, int pos_y) const {
+        auto row = static_cast<const uint8_t*>(surface->pixels) + pos_y * surface->pitch;
+        uint32_t value = reinterpret_cast<const uint32_t*>(row)[pos_x];
+
+        SDL_Color color;
+        SDL_GetRGBA(value, surface->format, &color.r, &color.g, &color.b, &color.a);
+
+        return color;
+    }
+};
+
+dino::SpriteInstance createInstance(dino::SpriteMaterial* texture, uint16_t layer, float pos_x) {
+    dino::SpriteInstance instance;
+    instance.texture = texture->getTexture();
+    instance.layer   = layer;
+    instance.target  = SDL_FRect {pos_x, 0.0f, 4.0f, 4.0f};
+
+    return instance;
+}
+
+bool isNear(float value, float expected) {
+    return std::fabs(value - expected) < 0.001f;
+}
+
+} // namespace
+
+/* Instances come out ordered by layer, then by texture, and runs of a texture share a draw. */
+static void testOrder() {
+    batch_fixture fixture(2);
+    dino::SpriteBatch batch;
+
+    auto texture_a = fixture.textures[0];
+    auto texture_b = fixture.textures[1];
+
+    batch.add(createInstance(texture_a, 2, 0.0f));
+    batch.add(createInstance(texture_b, 1, 1.0f));
+    batch.add(createInstance(texture_a, 1, 2.0f));
+    batch.add(createInstance(texture_b, 2, 3.0f));
+    batch.add(createInstance(texture_a, 2, 4.0f));
+    batch.add(createInstance(texture_a, 0, 5.0f));
+
+    batch.prepare();
+
+    std::vector<float> order;
+
+    for (std::size_t vertex = 0; vertex < batch.getVertices()->size(); vertex += 4) {
+        order.push_back(batch.getVertices()->at(vertex).position.x);
+    }
+
+    DINO_EXPECT((order == std::vector<float> {5.0f, 2.0f, 1.0f, 0.0f, 4.0f, 3.0f}));
+
+    /* Layer 0 and layer 1 both start with texture A, so they merge into one run. */
+    DINO_EXPECT(batch.getDraws()->size() == 4);
+    DINO_EXPECT(batch.getDraws()->at(0).instances == 2);
+    DINO_EXPECT(batch.getDraws()->at(0).texture == texture_a->getTexture());
+    DINO_EXPECT(batch.getDraws()->at(2).instances == 2);
+    DINO_EXPECT(batch.getDraws()->at(2).firstVertex == 12);
+}
+
+/* Layers and textures past one byte of the key sort like std::stable_sort. */
+static void testRadix() {
+    batch_fixture fixture(300);
+    dino::SpriteBatch batch(16);
+    std::mt19937 random(7);
+
+    std::vector<uint32_t> keys;
+
+    for (int index = 0; index < 2000; index++) {
+        auto texture = static_cast<int>(random() % 300);
+        auto layer   = static_cast<uint16_t>(random() % 700);
+
+        batch.add(createInstance(fixture.textures[texture], layer, static_cast<float>(index)));
+        keys.push_back(static_cast<uint32_t>(layer) << 16 | static_cast<uint32_t>(texture));
+    }
+
+    batch.prepare();
+
+    std::vector<int> positions;
+
+    for (std::size_t vertex = 0; vertex < batch.getVertices()->size(); vertex += 4) {
+        positions.push_back(static_cast<int>(batch.getVertices()->at(vertex).position.x));
+    }
+
+    /* Texture ids follow first use, map them back to the fixture order before comparing. */
+    std::vector<int> first_use(300, -1);
+    int next_id = 0;
+
+    for (auto& key : keys) {
+        int texture = static_cast<int>(key & 0xffff);
+
+        if (first_use[texture] < 0) {
+            first_use[texture] = next_id++;
+        }
+
+        key = (key & 0xffff0000) | static_cast<uint32_t>(first_use[texture]);
+    }
+
+    std::vector<int> expected(keys.size());
+
+    for (std::size_t index = 0; index < expected.size(); index++) {
+        expected[index] = static_cast<int>(index);
+    }
+
+    std::stable_sort(expected.begin(), expected.end(), [&keys] (int left, int right) {
+        return keys[left] < keys[right];
+    });
+
+    DINO_EXPECT(positions == expected);
+
+    batch.clear();
+    batch.prepare();
+
+    DINO_EXPECT(batch.getVertices()->empty());
+    DINO_EXPECT(batch.getDraws()->empty());
+}
+
+/* Flips swap texture coordinates, rotation turns the corners clockwise about the centre. */
+static void testTransform() {
+    batch_fixture fixture(1);
+    dino::SpriteBatch batch;
+
+    auto instance = createInstance(fixture.textures[0], 0, 0.0f);
+    instance.source = SDL_Rect {0, 0, 2, 4};
+    instance.flip   = SDL_FLIP_HORIZONTAL;
+
+    batch.add(instance);
+
+    instance.flip   = SDL_FLIP_NONE;
+    instance.target = SDL_FRect {0.0f, 0.0f, 2.0f, 4.0f};
+    instance.angle  = 90.0f;
+    instance.layer  = 1;
+
+    batch.add(instance);
+    batch.prepare();
+
+    auto vertices = batch.getVertices();
+
+    DINO_EXPECT(isNear(vertices->at(0).tex_coord.x, 0.5f));
+    DINO_EXPECT(isNear(vertices->at(1).tex_coord.x, 0.0f));
+    DINO_EXPECT(isNear(vertices->at(2).tex_coord.y, 1.0f));
+
+    /* The top left corner of a 2x4 quad turned a quarter about (1, 2). */
+    DINO_EXPECT(isNear(vertices->at(4).position.x, 3.0f));
+    DINO_EXPECT(isNear(vertices->at(4).position.y, 1.0f));
+}
+
+/* Backed by a frame arena, every frame is built from arena memory without falling back to the heap. */
+static void testFrameArena() {
+    batch_fixture fixture(2);
+    dino::FrameArena arena(16384);
+    dino::SpriteBatch batch(4, arena.getResource());
+
+    for (int frame = 0; frame < 4; frame++) {
+        arena.beginFrame();
+        batch.clear();
+
+        /* The second frame outgrows the first, the ones after start at its size. */
+        int instances = frame == 0 ? 4 : 32;
+
+        for (int index = 0; index < instances; index++) {
+            batch.add(createInstance(fixture.textures[index % 2], static_cast<uint16_t>(index % 3), static_cast<float>(index)));
+        }
+
+        batch.prepare();
+
+        DINO_EXPECT(batch.getVertices()->size() == static_cast<std::size_t>(instances) * 4);
+        DINO_EXPECT(batch.getDraws()->size() == 6 || instances < 6);
+        DINO_EXPECT(arena.getStats()->allocations > 0);
+        DINO_EXPECT(arena.getStats()->overflowAllocations == 0);
+
+        if (frame > 1) {
+            DINO_EXPECT(arena.getStats()->allocations == 8);
+        }
+    }
+}
+
+/* Drawn through the renderer, the higher layer covers the lower one and tints apply. */
+static void testDraw() {
+    batch_fixture fixture(2);
+    dino::SpriteBatch batch;
+
+    auto top = createInstance(fixture.textures[0], 1, 0.0f);
+    top.tint = SDL_Color {0x00, 0xff, 0x00, 0xff};
+
+    auto bottom = createInstance(fixture.textures[1], 0, 2.0f);
+    bottom.tint = SDL_Color {0xff, 0x00, 0x00, 0xff};
+
+    batch.add(top);
+    batch.add(bottom);
+
+    fixture.renderer->begin();
+    fixture.renderer->draw(&batch);
+
+    SDL_Color covered = fixture.pixel(2, 1);
+    SDL_Color exposed = fixture.pixel(5, 1);
+    SDL_Color outside = fixture.pixel(10, 10);
+
+    DINO_EXPECT(covered.g == 0xff && covered.r == 0x00);
+    DINO_EXPECT(exposed.r == 0xff && exposed.g == 0x00);
+    DINO_EXPECT(outside.r == 0x5e && outside.g == 0x82 && outside.b == 0xac);
+}
+
+int main() {
+    testOrder();
+    testRadix();
+    testTransform();
+    testFrameArena();
+    testDraw();
+
+    return dino::test::result();
+}
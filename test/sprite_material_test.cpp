@@ -0,0 +1,156 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "engine/except.hpp"
+#include "engine/renderer.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_SURFACE_SIZE 8
+#define DINO_TEST_IMAGE_SIZE 4
+
+namespace {
+
+/**
+ * @brief A software renderer drawing into a small surface.
+ */
+struct material_fixture {
+    SDL_Surface* surface;
+    dino::Renderer* renderer;
+
+    material_fixture() {
+        surface  = SDL_CreateRGBSurfaceWithFormat(0, DINO_TEST_SURFACE_SIZE, DINO_TEST_SURFACE_SIZE, 32, SDL_PIXELFORMAT_RGBA8888);
+        renderer = new dino::Renderer(surface);
+    }
+
+    ~material_fixture() {
+        delete renderer;
+        SDL_FreeSurface(surface);
+    }
+
+    [[nodiscard]] SDL_Color pixel(int pos_x, int pos_y) const {
+        auto row = static_cast<const uint8_t*>(surface->pixels) + pos_y * surface->pitch;
+        uint32_t value = reinterpret_cast<const uint32_t*>(row)[pos_x];
+
+        SDL_Color color;
+        SDL_GetRGBA(value, surface->format, &color.r, &color.g, &color.b, &color.a);
+
+        return color;
+    }
+};
+
+/* The colour of a test image pixel, distinct per pixel and channel. */
+SDL_Color imageColor(int pos_x, int pos_y) {
+    auto index = static_cast<uint8_t>(pos_y * DINO_TEST_IMAGE_SIZE + pos_x);
+    return SDL_Color {static_cast<uint8_t>(index * 16), static_cast<uint8_t>(255 - index * 8), static_cast<uint8_t>(index * 3), 0xff};
+}
+
+/* Writes a raw image with rows padded by two bytes. */
+std::vector<uint8_t> createRaw(uint32_t pixel_format) {
+    int pixel_size = pixel_format == SDL_PIXELFORMAT_RGB24 ? 3 : 4;
+    int pitch = DINO_TEST_IMAGE_SIZE * pixel_size + 2;
+
+    std::vector<uint8_t> raw_image(sizeof(dino::RawImageHeader) + pitch * DINO_TEST_IMAGE_SIZE);
+
+    dino::RawImageHeader header {};
+    std::memcpy(header.magic, DINO_RAW_IMAGE_MAGIC, sizeof(header.magic));
+
+    header.pixelFormat = pixel_format;
+    header.width  = DINO_TEST_IMAGE_SIZE;
+    header.height = DINO_TEST_IMAGE_SIZE;
+    header.pitch  = pitch;
+
+    std::memcpy(raw_image.data(), &header, sizeof(header));
+
+    for (int pos_y = 0; pos_y < DINO_TEST_IMAGE_SIZE; pos_y++) {
+        for (int pos_x = 0; pos_x < DINO_TEST_IMAGE_SIZE; pos_x++) {
+            SDL_Color color = imageColor(pos_x, pos_y);
+            uint8_t* target = raw_image.data() + sizeof(header) + pos_y * pitch + pos_x * pixel_size;
+
+            if (pixel_format == SDL_PIXELFORMAT_RGB24) {
+                target[0] = color.r;
+                target[1] = color.g;
+                target[2] = color.b;
+
+            } else {
+                uint32_t value = static_cast<uint32_t>(color.a) << 24 | static_cast<uint32_t>(color.r) << 16 |
+                        static_cast<uint32_t>(color.g) << 8 | color.b;
+
+                std::memcpy(target, &value, sizeof(value));
+            }
+        }
+    }
+
+    return raw_image;
+}
+
+/* Draws a material at the origin and checks every pixel of it. */
+bool drawsImage(material_fixture& fixture, dino::SpriteMaterial* material) {
+    fixture.renderer->begin();
+    fixture.renderer->draw(material);
+
+    for (int pos_y = 0; pos_y < DINO_TEST_IMAGE_SIZE; pos_y++) {
+        for (int pos_x = 0; pos_x < DINO_TEST_IMAGE_SIZE; pos_x++) {
+            SDL_Color drawn = fixture.pixel(pos_x, pos_y);
+            SDL_Color expected = imageColor(pos_x, pos_y);
+
+            if (drawn.r != expected.r || drawn.g != expected.g || drawn.b != expected.b) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+/* A raw image in a texture format of the renderer is uploaded as it is. */
+static void testNativeRaw() {
+    material_fixture fixture;
+    auto raw_image = createRaw(SDL_PIXELFORMAT_ARGB8888);
+
+    auto material = fixture.renderer->loadSprite(dino::FileView {raw_image.data(), raw_image.size()});
+
+    DINO_EXPECT(material->getWidth() == DINO_TEST_IMAGE_SIZE && material->getHeight() == DINO_TEST_IMAGE_SIZE);
+    DINO_EXPECT(material->getPixelFormat() == SDL_PIXELFORMAT_ARGB8888);
+    DINO_EXPECT(drawsImage(fixture, material));
+
+    delete material;
+}
+
+/* Other formats are converted into a texture of the renderer's format. */
+static void testConvertedRaw() {
+    material_fixture fixture;
+    auto raw_image = createRaw(SDL_PIXELFORMAT_RGB24);
+
+    auto material = fixture.renderer->loadSprite(dino::FileView {raw_image.data(), raw_image.size()});
+
+    DINO_EXPECT(material->getPixelFormat() != SDL_PIXELFORMAT_RGB24);
+    DINO_EXPECT(drawsImage(fixture, material));
+
+    delete material;
+}
+
+/* Truncated raw images are refused before reaching the renderer. */
+static void testTruncatedRaw() {
+    material_fixture fixture;
+    auto raw_image = createRaw(SDL_PIXELFORMAT_ARGB8888);
+    bool is_thrown = false;
+
+    try {
+        delete fixture.renderer->loadSprite(dino::FileView {raw_image.data(), raw_image.size() - 1});
+    } catch (dino::EngineError&) {
+        is_thrown = true;
+    }
+
+    DINO_EXPECT(is_thrown);
+}
+
+int main() {
+    testNativeRaw();
+    testConvertedRaw();
+    testTruncatedRaw();
+
+    return dino::test::result();
+}
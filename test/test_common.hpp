@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* Records a failure and carries on, checked by the main thread only. */
+#define DINO_EXPECT(condition) dino::test::expect((condition), #condition, __FILE__, __LINE__)
+
+namespace dino::test {
+
+inline int& failures() {
+    static int s_failures = 0;
+    return s_failures;
+}
+
+inline void expect(bool is_passed, const char* expression, const char* file, int line) {
+    if (!is_passed) {
+        std::fprintf(stderr, "%s:%d: expected %s\n", file, line, expression);
+        failures() = failures() + 1;
+    }
+}
+
+/**
+ * @brief Returns the exit code of a test executable.
+ * @return EXIT_SUCCESS if every expectation held.
+ */
+inline int result() {
+    return failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Returns the path of an asset shipped in the source tree.
+ */
+inline std::string asset(const std::string& directory, const std::string& file) {
+    return std::string(DINO_TEST_ASSET_DIR).append("/").append(directory).append("/").append(file);
+}
+
+/**
+ * @brief Writes a 16 bit stereo PCM wave file holding a square wave.
+ * @param file_path Path of the file.
+ * @param frequency Sample rate in Hz.
+ * @param frames Number of frames.
+ * @return True on success.
+ */
+inline bool writeWave(const std::string& file_path, uint32_t frequency, uint32_t frames) {
+    std::FILE* file = std::fopen(file_path.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    auto write_u32 = [file] (uint32_t value) {
+        uint8_t bytes[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+        std::fwrite(bytes, 1, 4, file);
+    };
+
+    auto write_u16 = [file] (uint16_t value) {
+        uint8_t bytes[2] = {uint8_t(value), uint8_t(value >> 8)};
+        std::fwrite(bytes, 1, 2, file);
+    };
+
+    uint32_t data_size = frames * 4;
+
+    std::fwrite("RIFF", 1, 4, file);
+    write_u32(36 + data_size);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    write_u32(16);
+    write_u16(1);
+    write_u16(2);
+    write_u32(frequency);
+    write_u32(frequency * 4);
+    write_u16(4);
+    write_u16(16);
+    std::fwrite("data", 1, 4, file);
+    write_u32(data_size);
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        auto sample = static_cast<uint16_t>((frame / 50) % 2 == 0 ? 8000 : -8000);
+        write_u16(sample);
+        write_u16(sample);
+    }
+
+    return std::fclose(file) == 0;
+}
+
+} // namespace dino::test
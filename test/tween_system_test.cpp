@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "engine/tween_system.hpp"
+#include "test_common.hpp"
+
+static bool isNear(float value, float expected) {
+    return std::fabs(value - expected) < 0.01f;
+}
+
+/* Every easing starts at 0 and ends at 1, except the arc which returns to 0. */
+static void testEasing() {
+    for (int easing = dino::TweenSystem::LINEAR; easing < dino::TweenSystem::SINE_ARC; easing++) {
+        DINO_EXPECT(isNear(dino::TweenSystem::ease(easing, 0.0f), 0.0f));
+        DINO_EXPECT(isNear(dino::TweenSystem::ease(easing, 1.0f), 1.0f));
+    }
+
+    DINO_EXPECT(isNear(dino::TweenSystem::ease(dino::TweenSystem::SINE_ARC, 0.5f), 1.0f));
+    DINO_EXPECT(isNear(dino::TweenSystem::ease(dino::TweenSystem::SINE_ARC, 1.0f), 0.0f));
+}
+
+/* Many tweens advance together, each completes exactly once. */
+static void testConcurrent() {
+    dino::TweenSystem tweens;
+    std::vector<float> values(100, -1.0f);
+    std::vector<int> completed;
+
+    for (int index = 0; index < 100; index++) {
+        dino::TweenSpec spec;
+        spec.target   = &values[index];
+        spec.from     = 0.0f;
+        spec.to       = 100.0f;
+        spec.duration = 10.0f * static_cast<float>(index + 1);
+        spec.onComplete = [index, &completed] () {
+            completed.push_back(index);
+        };
+
+        tweens.start(spec);
+    }
+
+    DINO_EXPECT(tweens.size() == 100);
+    DINO_EXPECT(isNear(values[0], 0.0f));
+
+    tweens.update(500.0f);
+
+    DINO_EXPECT(isNear(values[49], 100.0f));
+    DINO_EXPECT(isNear(values[99], 50.0f));
+    DINO_EXPECT(completed.size() == 50);
+    DINO_EXPECT(*std::max_element(completed.begin(), completed.end()) == 49);
+
+    tweens.update(500.0f);
+
+    DINO_EXPECT(tweens.size() == 0);
+    DINO_EXPECT(completed.size() == 100);
+
+    std::sort(completed.begin(), completed.end());
+
+    for (std::size_t index = 0; index < completed.size(); index++) {
+        DINO_EXPECT(completed[index] == static_cast<int>(index));
+    }
+}
+
+/* Repeats, cancellation and tweens started from a callback. */
+static void testControl() {
+    dino::TweenSystem tweens;
+    float value = 0.0f;
+    int runs = 0;
+
+    dino::TweenSpec spec;
+    spec.target   = &value;
+    spec.duration = 100.0f;
+    spec.repeat   = 2;
+    spec.onComplete = [&runs] () {
+        runs = runs + 1;
+    };
+
+    uint32_t tween_id = tweens.start(spec);
+
+    for (int step = 0; step < 10; step++) {
+        tweens.update(25.0f);
+    }
+
+    DINO_EXPECT(tweens.isActive(tween_id));
+    tweens.update(75.0f);
+    DINO_EXPECT(!tweens.isActive(tween_id));
+    DINO_EXPECT(runs == 1);
+
+    spec.repeat = -1;
+    tween_id = tweens.start(spec);
+    tweens.update(10000.0f);
+
+    DINO_EXPECT(tweens.isActive(tween_id));
+    DINO_EXPECT(tweens.cancel(tween_id));
+    DINO_EXPECT(!tweens.cancel(tween_id));
+    DINO_EXPECT(runs == 1);
+
+    spec.repeat = 0;
+    spec.onComplete = [&tweens, &value, &runs] () {
+        dino::TweenSpec chained;
+        chained.target   = &value;
+        chained.from     = 1.0f;
+        chained.to       = 0.0f;
+        chained.duration = 50.0f;
+        chained.onComplete = [&runs] () {
+            runs = runs + 10;
+        };
+
+        tweens.start(chained);
+    };
+
+    tweens.start(spec);
+    tweens.update(100.0f);
+
+    DINO_EXPECT(tweens.size() == 1);
+    DINO_EXPECT(isNear(value, 1.0f));
+
+    tweens.update(50.0f);
+
+    DINO_EXPECT(tweens.size() == 0);
+    DINO_EXPECT(isNear(value, 0.0f));
+    DINO_EXPECT(runs == 11);
+}
+
+int main() {
+    testEasing();
+    testConcurrent();
+    testControl();
+
+    return dino::test::result();
+}
@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "platform/virtual_filesystem.hpp"
+#include "test_common.hpp"
+
+namespace {
+
+void writeFile(const std::string& path, const char* content) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+
+    if (file != nullptr) {
+        std::fputs(content, file);
+        std::fclose(file);
+    }
+}
+
+bool viewEquals(const dino::FileView& view, const char* content) {
+    return !view.empty() && view.size == std::strlen(content) && std::memcmp(view.data, content, view.size) == 0;
+}
+
+} // namespace
+
+/* Names intern to stable ids, lookups of unknown names find nothing. */
+static void testInterning(const std::string& directory) {
+    dino::VirtualFilesystem filesystem;
+
+    DINO_EXPECT(filesystem.mountDirectory(directory));
+
+    auto sprite_id = filesystem.intern("texture/sprite.png");
+    auto effect_id = filesystem.intern("audio/effect.wav");
+
+    DINO_EXPECT(sprite_id != effect_id);
+    DINO_EXPECT(filesystem.intern("texture/sprite.png") == sprite_id);
+    DINO_EXPECT(filesystem.find("texture/sprite.png") == sprite_id);
+    DINO_EXPECT(filesystem.find("texture/missing.png") == dino::VirtualFilesystem::INVALID_PATH);
+    DINO_EXPECT(filesystem.getName(effect_id) == "audio/effect.wav");
+
+    auto missing_id = filesystem.intern("texture/missing.png");
+
+    DINO_EXPECT(!filesystem.exists(missing_id));
+    DINO_EXPECT(filesystem.read(missing_id).empty());
+    DINO_EXPECT(filesystem.getRealPath(missing_id).empty());
+}
+
+/* Loose files are read once and served from memory until released. */
+static void testDirectory(const std::string& directory) {
+    dino::VirtualFilesystem filesystem;
+
+    DINO_EXPECT(!filesystem.mountDirectory(directory + "/missing"));
+    DINO_EXPECT(filesystem.mountDirectory(directory + "/texture", "texture/"));
+
+    auto sprite_id = filesystem.intern("texture/sprite.png");
+    auto effect_id = filesystem.intern("audio/effect.wav");
+
+    DINO_EXPECT(filesystem.exists(sprite_id));
+    DINO_EXPECT(!filesystem.exists(effect_id));
+    DINO_EXPECT(std::filesystem::equivalent(filesystem.getRealPath(sprite_id), directory + "/texture/sprite.png"));
+
+    auto view = filesystem.read(sprite_id);
+
+    DINO_EXPECT(viewEquals(view, "sprite"));
+    DINO_EXPECT(filesystem.read(sprite_id).data == view.data);
+
+    filesystem.release(sprite_id);
+    DINO_EXPECT(viewEquals(filesystem.read(sprite_id), "sprite"));
+
+    /* Mounting later resolves the names interned before. */
+    DINO_EXPECT(filesystem.mountDirectory(directory));
+    DINO_EXPECT(viewEquals(filesystem.read(effect_id), "effect"));
+}
+
+/* A pack shadows directories and serves its files in place. */
+static void testPack(const std::string& directory) {
+    auto pack_file = directory + "/assets.pak";
+
+    DINO_EXPECT(dino::VirtualFilesystem::writePack(pack_file, directory + "/pack", {"texture/sprite.png", "empty.bin"}));
+    DINO_EXPECT(!dino::VirtualFilesystem::writePack(pack_file + ".bad", directory + "/pack", {"texture/missing.png"}));
+
+    dino::VirtualFilesystem filesystem;
+
+    DINO_EXPECT(filesystem.mountDirectory(directory));
+    DINO_EXPECT(filesystem.mountPack(pack_file));
+    DINO_EXPECT(!filesystem.mountPack(directory + "/texture/sprite.png"));
+
+    auto sprite_id = filesystem.intern("texture/sprite.png");
+    auto effect_id = filesystem.intern("audio/effect.wav");
+    auto empty_id  = filesystem.intern("empty.bin");
+
+    auto view = filesystem.read(sprite_id);
+
+    DINO_EXPECT(viewEquals(view, "packed sprite"));
+    DINO_EXPECT(reinterpret_cast<uintptr_t>(view.data) % DINO_PACK_ALIGNMENT == 0);
+    DINO_EXPECT(filesystem.getRealPath(sprite_id).empty());
+
+    /* Releasing a packed file keeps it mapped. */
+    filesystem.release(sprite_id);
+    DINO_EXPECT(filesystem.read(sprite_id).data == view.data);
+
+    DINO_EXPECT(!filesystem.read(empty_id).empty() && filesystem.read(empty_id).size == 0);
+    DINO_EXPECT(viewEquals(filesystem.read(effect_id), "effect"));
+    DINO_EXPECT(!filesystem.getRealPath(effect_id).empty());
+}
+
+/* Damaged packs are refused. */
+static void testDamagedPack(const std::string& directory) {
+    auto pack_file = directory + "/damaged.pak";
+
+    DINO_EXPECT(dino::VirtualFilesystem::writePack(pack_file, directory + "/pack", {"texture/sprite.png"}));
+    std::filesystem::resize_file(pack_file, std::filesystem::file_size(pack_file) - 4);
+
+    dino::VirtualFilesystem filesystem;
+    DINO_EXPECT(!filesystem.mountPack(pack_file));
+
+    writeFile(pack_file, "DPAK");
+    DINO_EXPECT(!filesystem.mountPack(pack_file));
+}
+
+int main() {
+    auto directory = (std::filesystem::temp_directory_path() / "dino-virtual-filesystem-test").string();
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory + "/texture");
+    std::filesystem::create_directories(directory + "/audio");
+    std::filesystem::create_directories(directory + "/pack/texture");
+
+    writeFile(directory + "/texture/sprite.png", "sprite");
+    writeFile(directory + "/audio/effect.wav", "effect");
+    writeFile(directory + "/pack/texture/sprite.png", "packed sprite");
+    writeFile(directory + "/pack/empty.bin", "");
+
+    testInterning(directory);
+    testDirectory(directory);
+    testPack(directory);
+    testDamagedPack(directory);
+
+    std::filesystem::remove_all(directory);
+    return dino::test::result();
+}
@@ -0,0 +1,162 @@
+#include <vector>
+
+#include "game/world_simulation.hpp"
+#include "test_common.hpp"
+
+#define DINO_TEST_TICKS 3000
+
+namespace {
+
+/* Sizes of the game assets at 1920x1080. */
+dino::WorldLayout createLayout() {
+    dino::WorldLayout layout {};
+    layout.viewWidth      = 1920;
+    layout.tileWidth      = 210;
+    layout.sceneWidth     = 1920;
+    layout.playerX        = 100;
+    layout.playerY        = 720;
+    layout.playerWidth    = 262;
+    layout.playerHeight   = 160;
+    layout.obstacleY      = 680;
+    layout.obstacleWidth  = 90;
+    layout.obstacleHeight = 200;
+
+    return layout;
+}
+
+/* Jumps at a fixed rhythm, so some obstacles are cleared and some are not. */
+std::vector<uint8_t> createInputs() {
+    std::vector<uint8_t> inputs(DINO_TEST_TICKS, dino::WorldSimulation::INPUT_NONE);
+
+    for (std::size_t tick = 0; tick < inputs.size(); tick += 53) {
+        inputs[tick] = dino::WorldSimulation::INPUT_JUMP;
+    }
+
+    return inputs;
+}
+
+bool isSameState(dino::WorldState& left, dino::WorldState& right) {
+    bool is_same = left.isGameOver == right.isGameOver &&
+            left.spawner.randomState == right.spawner.randomState &&
+            left.spawner.distance == right.spawner.distance &&
+            left.player.runMs == right.player.runMs &&
+            left.player.jumpMs == right.player.jumpMs &&
+            left.player.isJumping == right.player.isJumping &&
+            left.obstacles.size() == right.obstacles.size();
+
+    for (int32_t index = 0; index < left.floorCount; index++) {
+        is_same = is_same && left.floorX[index] == right.floorX[index];
+    }
+
+    std::vector<int> positions;
+
+    left.obstacles.forEach([&] (dino::PoolHandle, dino::ObstacleEntity& obstacle) {
+        positions.push_back(obstacle.posX);
+    });
+
+    right.obstacles.forEach([&] (dino::PoolHandle, dino::ObstacleEntity& obstacle) {
+        is_same = is_same && !positions.empty() && positions.front() == obstacle.posX;
+        positions.erase(positions.begin());
+    });
+
+    return is_same;
+}
+
+} // namespace
+
+/* Simulating ahead of a snapshot twice ends in the same state. */
+static void testResimulate() {
+    auto inputs = createInputs();
+
+    dino::WorldState state;
+    dino::WorldSimulation simulation(createLayout(), &state, 1234);
+
+    simulation.resimulate(state, inputs.data(), 200);
+    dino::WorldState snapshot = state;
+
+    int first_ticks = simulation.resimulate(snapshot, inputs.data() + 200, DINO_TEST_TICKS - 200);
+    dino::WorldState first = state;
+
+    int second_ticks = simulation.resimulate(snapshot, inputs.data() + 200, DINO_TEST_TICKS - 200);
+
+    DINO_EXPECT(first_ticks == second_ticks);
+    DINO_EXPECT(isSameState(first, state));
+}
+
+/* Without input the first obstacle ends the game, at the same tick for the same seed. */
+static void testGameOver() {
+    dino::WorldState state;
+    dino::WorldSimulation simulation(createLayout(), &state, 99);
+
+    dino::WorldState start = state;
+    int ticks = simulation.resimulate(start, nullptr, DINO_TEST_TICKS);
+
+    DINO_EXPECT(ticks < DINO_TEST_TICKS);
+    DINO_EXPECT(state.isGameOver != 0);
+    DINO_EXPECT(simulation.step(dino::WorldSimulation::INPUT_JUMP) == dino::WorldSimulation::EVENT_NONE);
+
+    DINO_EXPECT(simulation.resimulate(start, nullptr, DINO_TEST_TICKS) == ticks);
+}
+
+/* A jump is reported on the tick it starts and the player leaves the floor. */
+static void testJumpEvent() {
+    dino::WorldState state;
+    dino::WorldSimulation simulation(createLayout(), &state, 7);
+
+    DINO_EXPECT(simulation.step(dino::WorldSimulation::INPUT_JUMP) == dino::WorldSimulation::EVENT_JUMP);
+    DINO_EXPECT(simulation.getPlayer()->getLiftY() > 0);
+    DINO_EXPECT(simulation.step(dino::WorldSimulation::INPUT_JUMP) == dino::WorldSimulation::EVENT_NONE);
+}
+
+/* Resetting with the same seed gives the same start state. */
+static void testReset() {
+    dino::WorldState state;
+    dino::WorldSimulation simulation(createLayout(), &state, 42);
+
+    dino::WorldState start = state;
+    simulation.resimulate(state, nullptr, 500);
+
+    simulation.reset(42);
+    DINO_EXPECT(isSameState(start, state));
+    DINO_EXPECT(state.floorCount == 1920 / 210 + 2);
+}
+
+/* Obstacles are spaced so that a jump taken right before one clears it, at the scroll speed of a tick. */
+static void testObstacleGap() {
+    dino::WorldState state;
+    dino::WorldSimulation simulation(createLayout(), &state, 5);
+
+    int jump_ticks = 1;
+    simulation.step(dino::WorldSimulation::INPUT_JUMP);
+
+    while (state.player.isJumping != 0) {
+        simulation.step(dino::WorldSimulation::INPUT_NONE);
+        jump_ticks++;
+    }
+
+    /* The queue holds the floor distance of every obstacle generated ahead of the view. */
+    auto const& spawner = state.spawner;
+
+    for (unsigned int seed = 0; seed < 64; seed++) {
+        simulation.reset(seed);
+
+        DINO_EXPECT(spawner.queueSize > 1);
+
+        for (int32_t index = 1; index < spawner.queueSize; index++) {
+            auto gap = spawner.queue[(spawner.queueHead + index) % DINO_SPAWNER_QUEUE_CAPACITY] -
+                    spawner.queue[(spawner.queueHead + index - 1) % DINO_SPAWNER_QUEUE_CAPACITY];
+
+            DINO_EXPECT(gap >= jump_ticks * DINO_FLOOR_SCROLL_VELOCITY + 90);
+        }
+    }
+}
+
+int main() {
+    testResimulate();
+    testGameOver();
+    testJumpEvent();
+    testReset();
+    testObstacleGap();
+
+    return dino::test::result();
+}